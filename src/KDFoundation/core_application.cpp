@@ -21,6 +21,7 @@
 #include <KDFoundation/platform/macos/macos_platform_integration.h>
 #endif
 
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 
@@ -54,6 +55,7 @@ CoreApplication::CoreApplication(std::unique_ptr<AbstractPlatformIntegration> &&
 {
     assert(ms_application == nullptr);
     ms_application = this;
+    setEventLoop(&m_eventLoop);
 
     spdlog::set_default_logger(m_defaultLogger);
 
@@ -80,9 +82,32 @@ std::shared_ptr<KDBindings::ConnectionEvaluator> CoreApplication::connectionEval
     return m_eventLoop.connectionEvaluator();
 }
 
-void CoreApplication::postEvent(EventReceiver *target, std::unique_ptr<Event> &&event)
+void CoreApplication::postEvent(EventReceiver *target, std::unique_ptr<Event> &&event, EventQueue::Priority priority)
 {
-    m_eventLoop.postEvent(target, std::forward<std::unique_ptr<Event>>(event));
+    // Hand the event to the loop the target lives on. Targets without a loop, e.g. ones
+    // created before the application, are served by the main loop.
+    // Ids rather than addresses, the address of a loop that is gone may have been reused
+    const EventLoop::Id eventLoopId = target->eventLoopId();
+    if (eventLoopId == 0 || eventLoopId == m_eventLoop.id()) {
+        m_eventLoop.postEvent(target, std::forward<std::unique_ptr<Event>>(event), priority);
+        return;
+    }
+    if (!EventLoop::postEventIfAlive(eventLoopId, target, std::forward<std::unique_ptr<Event>>(event), priority))
+        SPDLOG_LOGGER_WARN(m_logger, "Dropping event posted to a receiver whose event loop is gone");
+}
+
+void CoreApplication::postEvents(std::vector<EventQueue::TargetedEvent> &&events, EventQueue::Priority priority)
+{
+    // Events for receivers living on other threads are posted one by one, the rest in
+    // one go
+    auto otherThreads = std::stable_partition(events.begin(), events.end(), [this](const EventQueue::TargetedEvent &event) {
+        const EventLoop::Id eventLoopId = event.first->eventLoopId();
+        return eventLoopId == 0 || eventLoopId == m_eventLoop.id();
+    });
+    for (auto it = otherThreads; it != events.end(); ++it)
+        postEvent(it->first, std::move(it->second), priority);
+    events.erase(otherThreads, events.end());
+    m_eventLoop.postEvents(std::move(events), priority);
 }
 
 void CoreApplication::sendEvent(EventReceiver *target, Event *event)
@@ -102,7 +127,8 @@ int CoreApplication::exec()
 
 void CoreApplication::quit()
 {
-    postEvent(this, std::make_unique<QuitEvent>());
+    // Don't let a flood of pending events delay quitting
+    postEvent(this, std::make_unique<QuitEvent>(), EventQueue::Priority::High);
 }
 
 AbstractPlatformIntegration *CoreApplication::platformIntegration()
@@ -51,9 +51,13 @@ public:
 
     Postman *postman() { return m_eventLoop.postman(); }
 
-    void postEvent(EventReceiver *target, std::unique_ptr<Event> &&event);
+    void postEvent(EventReceiver *target, std::unique_ptr<Event> &&event,
+                   EventQueue::Priority priority = EventQueue::Priority::Normal);
+    void postEvents(std::vector<EventQueue::TargetedEvent> &&events,
+                    EventQueue::Priority priority = EventQueue::Priority::Normal);
     void removeAllEventsTargeting(EventReceiver &evReceiver) { m_eventLoop.removeAllEventsTargeting(evReceiver); }
     EventQueue::size_type eventQueueSize() const { return m_eventLoop.eventQueueSize(); }
+    EventQueue::size_type eventQueueSize(EventQueue::Priority priority) const { return m_eventLoop.eventQueueSize(priority); }
 
     void sendEvent(EventReceiver *target, Event *event);
 
@@ -0,0 +1,412 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+// Opt-in coroutine support. KDFoundation itself is built as C++17, only code including
+// this header needs C++20.
+#if !defined(__cpp_impl_coroutine)
+#error "KDFoundation/coroutine.h requires C++20 coroutine support"
+#endif
+
+#include <KDFoundation/event.h>
+#include <KDFoundation/event_loop.h>
+#include <KDFoundation/file_descriptor_notifier.h>
+#include <KDFoundation/timer.h>
+
+#include <cassert>
+#include <chrono>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace KDFoundation {
+
+template<typename T = void>
+class Task;
+
+namespace Detail {
+
+class TaskPromiseBase
+{
+public:
+    // Tasks are lazy, they start when awaited or started explicitly
+    std::suspend_always initial_suspend() noexcept { return {}; }
+
+    struct FinalAwaiter {
+        bool await_ready() noexcept { return false; }
+
+        template<typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            // Hand over to the awaiting coroutine without growing the stack
+            auto &promise = handle.promise();
+            if (promise.m_continuation)
+                return promise.m_continuation;
+            if (promise.m_detached) {
+                if (promise.m_exception)
+                    std::terminate(); // Nobody is left to handle it
+                handle.destroy();
+            }
+            return std::noop_coroutine();
+        }
+
+        void await_resume() noexcept { }
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+
+    void unhandled_exception() noexcept { m_exception = std::current_exception(); }
+
+    void rethrowIfFailed() const
+    {
+        if (m_exception)
+            std::rethrow_exception(m_exception);
+    }
+
+    std::coroutine_handle<> m_continuation;
+    std::exception_ptr m_exception;
+    bool m_started = false;
+    bool m_detached = false;
+};
+
+template<typename T>
+class TaskPromise : public TaskPromiseBase
+{
+public:
+    Task<T> get_return_object() noexcept;
+
+    template<typename U>
+    void return_value(U &&value) noexcept(std::is_nothrow_constructible_v<T, U &&>)
+    {
+        m_value.emplace(std::forward<U>(value));
+    }
+
+    T result()
+    {
+        rethrowIfFailed();
+        return std::move(*m_value);
+    }
+
+private:
+    std::optional<T> m_value;
+};
+
+template<>
+class TaskPromise<void> : public TaskPromiseBase
+{
+public:
+    Task<void> get_return_object() noexcept;
+
+    void return_void() noexcept { }
+    void result() { rethrowIfFailed(); }
+};
+
+} // namespace Detail
+
+// A coroutine producing a T. Tasks start suspended and run when co_awaited by another
+// coroutine, or when started through start(). Like any other code run by the event
+// loop, a task suspended on one of the awaitables below is resumed by the event loop of
+// the thread it was suspended on.
+//
+// A suspended task may be abandoned by destroying it, which cancels its pending
+// resumption. That has to happen on the thread of the event loop that is to resume it,
+// i.e. the target loop for resumeOn().
+template<typename T>
+class [[nodiscard]] Task
+{
+public:
+    using promise_type = Detail::TaskPromise<T>;
+
+    Task() = default;
+    ~Task()
+    {
+        if (m_handle)
+            m_handle.destroy();
+    }
+
+    // Not copyable
+    Task(const Task &other) = delete;
+    Task &operator=(const Task &other) = delete;
+
+    Task(Task &&other) noexcept
+        : m_handle{ std::exchange(other.m_handle, {}) }
+    {
+    }
+    Task &operator=(Task &&other) noexcept
+    {
+        if (this != &other) {
+            if (m_handle)
+                m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+
+    bool isValid() const { return bool(m_handle); }
+    bool isDone() const { return m_handle && m_handle.done(); }
+
+    // Runs the task up to its first suspension. Does nothing if it has been started.
+    void start()
+    {
+        assert(m_handle);
+        auto &promise = m_handle.promise();
+        if (!promise.m_started) {
+            promise.m_started = true;
+            m_handle.resume();
+        }
+    }
+
+    // Starts the task if needed and lets it run on its own. It is destroyed once done.
+    // Exceptions escaping a detached task terminate the program.
+    void detach()
+    {
+        assert(m_handle);
+        auto handle = std::exchange(m_handle, {});
+        if (handle.done()) {
+            handle.destroy();
+            return;
+        }
+        handle.promise().m_detached = true;
+        if (!handle.promise().m_started) {
+            handle.promise().m_started = true;
+            handle.resume();
+        }
+    }
+
+    // The value returned by the task, which must be done. Rethrows exceptions leaving it.
+    T result()
+    {
+        assert(isDone());
+        return m_handle.promise().result();
+    }
+
+    auto operator co_await() && noexcept { return Awaiter{ m_handle }; }
+    auto operator co_await() & noexcept { return Awaiter{ m_handle }; }
+
+private:
+    friend class Detail::TaskPromise<T>;
+
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept
+        : m_handle{ handle }
+    {
+    }
+
+    struct Awaiter {
+        std::coroutine_handle<promise_type> handle;
+
+        bool await_ready() const noexcept { return !handle || handle.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept
+        {
+            auto &promise = handle.promise();
+            promise.m_continuation = awaiting;
+            if (promise.m_started)
+                return std::noop_coroutine();
+            promise.m_started = true;
+            return handle;
+        }
+
+        T await_resume()
+        {
+            assert(handle);
+            return handle.promise().result();
+        }
+    };
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+namespace Detail {
+
+template<typename T>
+Task<T> TaskPromise<T>::get_return_object() noexcept
+{
+    return Task<T>{ std::coroutine_handle<TaskPromise<T>>::from_promise(*this) };
+}
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept
+{
+    return Task<void>{ std::coroutine_handle<TaskPromise<void>>::from_promise(*this) };
+}
+
+// Resumes a coroutine from an event posted to a loop. Lives in the coroutine frame, as
+// part of an awaiter, so destroying the frame drops the pending resumption along with
+// the other events targeting the receiver. Capturing just the handle keeps the callback
+// within the small buffer of std::function, and InvokeEvent comes from the event pool,
+// so this does not allocate.
+class Resumption : public EventReceiver
+{
+public:
+    explicit Resumption(EventLoop *eventLoop)
+    {
+        assert(eventLoop && "Coroutines can only be resumed by an event loop.");
+        setEventLoop(eventLoop);
+    }
+
+    // Not copyable, events refer to it
+    Resumption(const Resumption &other) = delete;
+    Resumption &operator=(const Resumption &other) = delete;
+
+    void post(std::coroutine_handle<> handle, EventQueue::Priority priority = EventQueue::Priority::Normal)
+    {
+        auto event = std::make_unique<InvokeEvent>([handle] { handle.resume(); });
+        if (!EventLoop::postEventIfAlive(eventLoopId(), this, std::move(event), priority))
+            SPDLOG_ERROR("The EventLoop to resume a coroutine on is gone, it stays suspended.");
+    }
+};
+
+} // namespace Detail
+
+// Suspends until fd is ready for the given type of notification. The notifier lives in
+// the coroutine frame rather than on the heap.
+class FileDescriptorAwaiter
+{
+public:
+    FileDescriptorAwaiter(int fd, FileDescriptorNotifier::NotificationType type)
+        : m_fd{ fd }
+        , m_type{ type }
+    {
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_notifier.emplace(m_fd, m_type, handle);
+    }
+
+    void await_resume() noexcept { }
+
+private:
+    class Notifier : public FileDescriptorNotifier
+    {
+    public:
+        Notifier(int fd, NotificationType type, std::coroutine_handle<> handle)
+            : FileDescriptorNotifier(fd, type)
+            , m_handle{ handle }
+            , m_resumption{ EventLoop::instance() }
+        {
+        }
+
+    protected:
+        void event(EventReceiver *target, Event *ev) override
+        {
+            FileDescriptorNotifier::event(target, ev);
+            // Resuming right here would destroy the notifier while it is handling the
+            // event, hence the round trip through the event loop
+            if (ev->type() == Event::Type::Notifier && !m_resumptionPosted) {
+                m_resumptionPosted = true;
+                m_resumption.post(m_handle, EventQueue::Priority::High);
+            }
+        }
+
+    private:
+        std::coroutine_handle<> m_handle;
+        Detail::Resumption m_resumption;
+        bool m_resumptionPosted = false;
+    };
+
+    int m_fd;
+    FileDescriptorNotifier::NotificationType m_type;
+    std::optional<Notifier> m_notifier;
+};
+
+inline FileDescriptorAwaiter waitForReadable(int fd)
+{
+    return { fd, FileDescriptorNotifier::NotificationType::Read };
+}
+
+inline FileDescriptorAwaiter waitForWritable(int fd)
+{
+    return { fd, FileDescriptorNotifier::NotificationType::Write };
+}
+
+// Suspends for delay, using a timer living in the coroutine frame so that abandoning
+// the task stops it
+class SleepAwaiter
+{
+public:
+    explicit SleepAwaiter(std::chrono::microseconds delay, TimerType type)
+        : m_delay{ delay }
+        , m_type{ type }
+        , m_resumption{ EventLoop::instance() }
+    {
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        // Resuming from the timeout would destroy the timer while it emits
+        m_timer.emplace();
+        m_timer->timerType = m_type;
+        m_timer->interval = m_delay;
+        m_timer->repeating = false;
+        std::ignore = m_timer->timeout.connect([this, handle](uint64_t /*expirations*/) {
+            m_resumption.post(handle, EventQueue::Priority::High);
+        });
+        m_timer->running = true;
+    }
+
+    void await_resume() noexcept { }
+
+private:
+    std::chrono::microseconds m_delay;
+    TimerType m_type;
+    Detail::Resumption m_resumption;
+    std::optional<Timer> m_timer;
+};
+
+template<typename Rep, typename Period>
+SleepAwaiter sleepFor(std::chrono::duration<Rep, Period> delay, TimerType type = TimerType::Precise)
+{
+    return SleepAwaiter{ std::chrono::duration_cast<std::chrono::microseconds>(delay), type };
+}
+
+// Suspends until eventLoop resumes the coroutine from a posted event. Resuming on the
+// current loop lets everything posted before run first, resuming on the loop of another
+// thread moves the coroutine over to that thread. The loop is only held on to by id,
+// if it is gone by the time the coroutine suspends, the coroutine stays suspended.
+class ResumeOnAwaiter
+{
+public:
+    explicit ResumeOnAwaiter(EventLoop *eventLoop)
+        : m_resumption{ eventLoop }
+    {
+    }
+
+    bool await_ready() const noexcept { return false; }
+
+    void await_suspend(std::coroutine_handle<> handle)
+    {
+        m_resumption.post(handle);
+    }
+
+    void await_resume() noexcept { }
+
+private:
+    Detail::Resumption m_resumption;
+};
+
+inline ResumeOnAwaiter resumeOn(EventLoop *eventLoop)
+{
+    return ResumeOnAwaiter{ eventLoop };
+}
+
+inline ResumeOnAwaiter yieldToEventLoop()
+{
+    return ResumeOnAwaiter{ EventLoop::instance() };
+}
+
+} // namespace KDFoundation
@@ -11,8 +11,120 @@
 
 #include "event.h"
 
+#include <array>
+
 using namespace KDFoundation;
 
+namespace {
+
+// Freed events are kept on per-thread free lists, one per size class. Blocks freed on
+// another thread than the one that allocated them (e.g. events posted across threads)
+// simply end up on the lists of the thread that delivered them.
+class EventPool
+{
+public:
+    static constexpr std::size_t granularity = alignof(std::max_align_t);
+    static constexpr std::size_t sizeClassCount = 16;
+    // Bounds the memory a thread keeps around after a burst of events
+    static constexpr std::size_t maxCachedBytesPerClass = 128 * 1024;
+
+    ~EventPool();
+
+    static std::size_t sizeClassFor(std::size_t size) { return (size + granularity - 1) / granularity - 1; }
+    static std::size_t blockSizeFor(std::size_t sizeClass) { return (sizeClass + 1) * granularity; }
+
+    void *allocate(std::size_t sizeClass);
+    void deallocate(void *ptr, std::size_t sizeClass);
+
+private:
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+    struct FreeList {
+        FreeBlock *head = nullptr;
+        std::size_t count = 0;
+    };
+    std::array<FreeList, sizeClassCount> m_freeLists;
+};
+
+// Allows events destroyed after the pool of their thread (e.g. from other thread_local
+// destructors) to go straight back to the global allocator
+thread_local bool s_eventPoolDestroyed = false;
+thread_local EventPool s_eventPool;
+
+EventPool::~EventPool()
+{
+    for (auto &freeList : m_freeLists) {
+        while (freeList.head) {
+            FreeBlock *block = freeList.head;
+            freeList.head = block->next;
+            ::operator delete(block);
+        }
+    }
+    s_eventPoolDestroyed = true;
+}
+
+void *EventPool::allocate(std::size_t sizeClass)
+{
+    FreeList &freeList = m_freeLists[sizeClass];
+    if (!freeList.head)
+        return ::operator new(blockSizeFor(sizeClass));
+
+    FreeBlock *block = freeList.head;
+    freeList.head = block->next;
+    --freeList.count;
+    return block;
+}
+
+void EventPool::deallocate(void *ptr, std::size_t sizeClass)
+{
+    FreeList &freeList = m_freeLists[sizeClass];
+    if (freeList.count * blockSizeFor(sizeClass) >= maxCachedBytesPerClass) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    auto block = static_cast<FreeBlock *>(ptr);
+    block->next = freeList.head;
+    freeList.head = block;
+    ++freeList.count;
+}
+
+} // namespace
+
 Event::~Event()
 {
 }
+
+bool Event::mergeWith(Event &)
+{
+    return false;
+}
+
+void *Event::operator new(std::size_t size)
+{
+    const std::size_t sizeClass = EventPool::sizeClassFor(size);
+    if (sizeClass >= EventPool::sizeClassCount || s_eventPoolDestroyed)
+        return ::operator new(size < EventPool::granularity ? EventPool::granularity : size);
+    return s_eventPool.allocate(sizeClass);
+}
+
+void *Event::operator new(std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void Event::operator delete(void *ptr, std::size_t size) noexcept
+{
+    const std::size_t sizeClass = EventPool::sizeClassFor(size);
+    if (sizeClass >= EventPool::sizeClassCount || s_eventPoolDestroyed) {
+        ::operator delete(ptr);
+        return;
+    }
+    s_eventPool.deallocate(ptr, sizeClass);
+}
+
+void Event::operator delete(void *ptr, std::size_t size, std::align_val_t alignment) noexcept
+{
+    ::operator delete(ptr, size, alignment);
+}
@@ -12,10 +12,15 @@
 #pragma once
 
 #include "KDFoundation/event_receiver.h"
+#include <KDFoundation/config.h>
 #include <KDFoundation/kdfoundation_global.h>
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <memory>
+#include <new>
 
 namespace KDFoundation {
 
@@ -39,6 +44,7 @@ public:
         TextInput = 13,
         Update = 14,
         DeferredDelete = 15,
+        Invoke = 16,
 
         UserType = 4096
     };
@@ -71,6 +77,23 @@ public:
     bool isAccepted() const { return m_accepted; }
     void setAccepted(bool accepted) { m_accepted = accepted; }
 
+    // Coalescing hook used by event loops that have event coalescing enabled. Called on
+    // an event still waiting in the queue when newer, an event of the same type for the
+    // same target, is posted. Return true after folding newer into this event, in which
+    // case newer is dropped. Returning false, as the default implementation does, queues
+    // newer separately.
+    virtual bool mergeWith(Event &newer);
+
+    // Events of all types, including user defined ones, are allocated from a per-thread
+    // recycling pool so that posting events at a high rate doesn't go through the global
+    // allocator in the steady state
+    static void *operator new(std::size_t size);
+    static void *operator new(std::size_t size, std::align_val_t alignment);
+    static void *operator new(std::size_t, void *where) noexcept { return where; }
+    static void operator delete(void *ptr, std::size_t size) noexcept;
+    static void operator delete(void *ptr, std::size_t size, std::align_val_t alignment) noexcept;
+    static void operator delete(void *, void *) noexcept { }
+
 protected:
     Type m_type;
     uint8_t m_systemEvent : 1;
@@ -88,15 +111,25 @@ public:
         : Event(Event::Type::PostedEvent)
         , m_target{ target }
         , m_wrappedEvent{ std::move(wrappedEvent) }
+#if KDFOUNDATION_INSTRUMENTATION
+        , m_postedAt{ std::chrono::steady_clock::now() }
+#endif
     {
     }
 
     EventReceiver *target() const { return m_target; }
     Event *wrappedEvent() const { return m_wrappedEvent.get(); }
 
+#if KDFOUNDATION_INSTRUMENTATION
+    std::chrono::steady_clock::time_point postedAt() const { return m_postedAt; }
+#endif
+
 private:
     EventReceiver *m_target;
     std::unique_ptr<Event> m_wrappedEvent;
+#if KDFOUNDATION_INSTRUMENTATION
+    std::chrono::steady_clock::time_point m_postedAt;
+#endif
 };
 
 // TODO: Implement a timer :)
@@ -137,6 +170,14 @@ public:
     {
     }
 
+    bool mergeWith(Event &newer) override
+    {
+        const auto &newerResize = static_cast<const ResizeEvent &>(newer);
+        m_width = newerResize.m_width;
+        m_height = newerResize.m_height;
+        return true;
+    }
+
     uint32_t width() const { return m_width; }
     uint32_t height() const { return m_height; }
 
@@ -152,6 +193,8 @@ public:
         : Event(Event::Type::Update)
     {
     }
+
+    bool mergeWith(Event &) override { return true; }
 };
 
 class KDFOUNDATION_API DeferredDeleteEvent : public Event
@@ -163,4 +206,22 @@ public:
     }
 };
 
+// Carries a callable to be called on the thread of the event loop it is posted to, see
+// EventLoop::postCallback(). Posted to a receiver, the loop calls it directly rather than
+// delivering it, and drops it along with the other events for that receiver.
+class KDFOUNDATION_API InvokeEvent : public Event
+{
+public:
+    explicit InvokeEvent(std::function<void()> &&callback)
+        : Event(Event::Type::Invoke)
+        , m_callback{ std::move(callback) }
+    {
+    }
+
+    void invoke() { m_callback(); }
+
+private:
+    std::function<void()> m_callback;
+};
+
 } // namespace KDFoundation
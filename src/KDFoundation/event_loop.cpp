@@ -14,6 +14,7 @@
 #include <KDFoundation/core_application.h>
 #include <KDFoundation/platform/abstract_platform_event_loop.h>
 #include "postman.h"
+#include "timer.h"
 
 #if defined(PLATFORM_LINUX)
 #include <KDFoundation/platform/linux/linux_platform_integration.h>
@@ -23,13 +24,75 @@
 #include <KDFoundation/platform/macos/macos_platform_integration.h>
 #endif
 
+#include <algorithm>
 #include <cassert>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
 
 using namespace KDFoundation;
 
 namespace {
 thread_local EventLoop *s_eventLoopInstance = nullptr;
+
+// Keeps a loop from being destroyed while another thread posts to it. Posting threads
+// hold the lock shared, so they don't wait for each other, the loop takes it exclusively
+// to retire the handle.
+struct EventLoopHandle {
+    explicit EventLoopHandle(EventLoop *loop)
+        : eventLoop{ loop }
+    {
+    }
+
+    std::shared_mutex mutex;
+    EventLoop *eventLoop;
+};
+
+// All event loops in existence by id, so that other threads can tell whether the loop
+// a receiver lives on is still around. Only looking a loop up takes the lock of the
+// registry, posting to it doesn't.
+struct EventLoopRegistry {
+    std::shared_mutex mutex;
+    std::unordered_map<EventLoop::Id, std::shared_ptr<EventLoopHandle>> eventLoops;
+    EventLoop::Id lastId = 0;
+
+    std::shared_ptr<EventLoopHandle> find(EventLoop::Id id)
+    {
+        const std::shared_lock<std::shared_mutex> lock(mutex);
+        const auto it = eventLoops.find(id);
+        return it != eventLoops.end() ? it->second : nullptr;
+    }
+};
+
+EventLoopRegistry &eventLoopRegistry()
+{
+    static EventLoopRegistry registry;
+    return registry;
+}
+
+// Calls f with the loop with the given id, unless that loop is gone. The loop can't go
+// away while f runs.
+template<typename F>
+bool withEventLoop(EventLoop::Id eventLoopId, F &&f)
+{
+    const auto handle = eventLoopRegistry().find(eventLoopId);
+    if (!handle)
+        return false;
+    const std::shared_lock<std::shared_mutex> lock(handle->mutex);
+    if (handle->eventLoop == nullptr)
+        return false;
+    f(handle->eventLoop);
+    return true;
 }
+} // namespace
+
+struct EventLoop::SingleShotTimer {
+    Timer timer;
+    // Empty while the timer is available for reuse
+    std::function<void()> callback;
+    KDBindings::ScopedConnection timeoutConnection;
+};
 
 EventLoop *EventLoop::instance()
 {
@@ -48,8 +111,12 @@ std::unique_ptr<AbstractPlatformEventLoop> createPlatformEventLoop()
 }
 } // namespace
 
-EventLoop::EventLoop(std::unique_ptr<AbstractPlatformEventLoop> platformEventLoop)
-    : m_platformEventLoop(platformEventLoop ? std::move(platformEventLoop) : createPlatformEventLoop())
+EventLoop::EventLoop(std::unique_ptr<AbstractPlatformEventLoop> platformEventLoop, EventQueue::Backend eventQueueBackend)
+    : m_eventQueue(eventQueueBackend)
+    , m_platformEventLoop(platformEventLoop ? std::move(platformEventLoop) : createPlatformEventLoop())
+#if KDFOUNDATION_INSTRUMENTATION
+    , m_statistics(std::make_unique<Statistics>())
+#endif
 {
     // Create a default postman object
     m_postman = std::make_unique<Postman>();
@@ -57,10 +124,42 @@ EventLoop::EventLoop(std::unique_ptr<AbstractPlatformEventLoop> platformEventLoo
 
     assert(s_eventLoopInstance == nullptr && "Cannot have more than one event loop per thread.");
     s_eventLoopInstance = this;
+
+    auto &registry = eventLoopRegistry();
+    const std::lock_guard<std::shared_mutex> lock(registry.mutex);
+    m_id = ++registry.lastId;
+    registry.eventLoops.emplace(m_id, std::make_shared<EventLoopHandle>(this));
 }
 
 EventLoop::~EventLoop()
 {
+    // Wait for the threads posting to the loop, and keep the ones that still hold on to
+    // the handle from posting again
+    std::shared_ptr<EventLoopHandle> handle;
+    {
+        auto &registry = eventLoopRegistry();
+        const std::lock_guard<std::shared_mutex> lock(registry.mutex);
+        const auto it = registry.eventLoops.find(m_id);
+        handle = std::move(it->second);
+        registry.eventLoops.erase(it);
+    }
+    {
+        const std::lock_guard<std::shared_mutex> lock(handle->mutex);
+        handle->eventLoop = nullptr;
+    }
+
+    // Objects still scheduled for deletion are left alone, they mustn't refer to this
+    // loop anymore though
+    for (Object *object : m_deferredDeletions) {
+        if (object != nullptr) {
+            object->m_deferredDeletionIndex = Object::NotScheduledForDeletion;
+            object->m_deferredDeletionLoop = nullptr;
+        }
+    }
+
+    // Timers need the platform event loop to clean up after themselves
+    m_singleShotTimers.clear();
+
     // Destroy the platform event loop before removing the event loop instance
     m_platformEventLoop.reset();
     s_eventLoopInstance = nullptr;
@@ -71,38 +170,470 @@ std::shared_ptr<KDBindings::ConnectionEvaluator> EventLoop::connectionEvaluator(
     return m_platformEventLoop->connectionEvaluator();
 }
 
-void EventLoop::postEvent(EventReceiver *target, std::unique_ptr<Event> &&event)
+void EventLoop::singleShot(std::chrono::microseconds delay, std::function<void()> callback, TimerType type)
+{
+    if (!callback)
+        return;
+    if (m_platformEventLoop && m_platformEventLoop->singleShot(delay, type, callback))
+        return;
+
+    auto it = std::find_if(m_singleShotTimers.begin(), m_singleShotTimers.end(), [](const auto &singleShotTimer) {
+        return !singleShotTimer->callback;
+    });
+    if (it == m_singleShotTimers.end()) {
+        auto singleShotTimer = std::make_unique<SingleShotTimer>();
+        singleShotTimer->timer.repeating = false;
+        singleShotTimer->timeoutConnection = singleShotTimer->timer.timeout.connect([singleShotTimer = singleShotTimer.get()](uint64_t /*expirations*/) {
+            // Make the timer available again before calling out, the callback may well
+            // ask for another single shot
+            auto callback = std::move(singleShotTimer->callback);
+            singleShotTimer->callback = nullptr;
+            callback();
+        });
+        m_singleShotTimers.push_back(std::move(singleShotTimer));
+        it = std::prev(m_singleShotTimers.end());
+    }
+
+    auto &singleShotTimer = **it;
+    singleShotTimer.callback = std::move(callback);
+    singleShotTimer.timer.timerType = type;
+    singleShotTimer.timer.interval = delay;
+    singleShotTimer.timer.running = true;
+}
+
+void EventLoop::postEvent(EventReceiver *target, std::unique_ptr<Event> &&event, EventQueue::Priority priority)
 {
     assert(target != nullptr);
     assert(event->type() != Event::Type::Invalid);
-    m_eventQueue.push(target, std::forward<std::unique_ptr<Event>>(event));
+    m_eventQueue.push(target, std::forward<std::unique_ptr<Event>>(event), priority);
+    m_platformEventLoop->wakeUp();
+}
+
+void EventLoop::postEvents(std::vector<EventQueue::TargetedEvent> &&events, EventQueue::Priority priority)
+{
+    if (events.empty())
+        return;
+#ifndef NDEBUG
+    for (const auto &[target, event] : events) {
+        assert(target != nullptr);
+        assert(event->type() != Event::Type::Invalid);
+    }
+#endif
+    m_eventQueue.push(std::move(events), priority);
     m_platformEventLoop->wakeUp();
 }
 
+void EventLoop::postCallback(std::function<void()> callback, EventQueue::Priority priority)
+{
+    if (!callback)
+        return;
+    postEvent(&m_callbackReceiver, std::make_unique<InvokeEvent>(std::move(callback)), priority);
+}
+
+void EventLoop::CallbackReceiver::event(EventReceiver * /*target*/, Event *ev)
+{
+    if (ev->type() == Event::Type::Invoke) {
+        static_cast<InvokeEvent *>(ev)->invoke();
+        ev->setAccepted(true);
+    }
+}
+
 void EventLoop::sendEvent(EventReceiver *target, Event *event)
 {
+#if KDFOUNDATION_INSTRUMENTATION
+    const ScopedLatencyMeasurement measurement(m_statistics->handlerTime(event->type()));
+#endif
     m_postman->deliverEvent(target, event);
 }
 
+void EventLoop::removeAllEventsTargeting(EventReceiver &evReceiver)
+{
+    m_eventQueue.removeAllEventsTargeting(evReceiver);
+
+    // Events already taken out of the queue for delivery can only be touched from the
+    // thread running this loop. Rather than searching the batch, remember how far into
+    // it events for this receiver have to be skipped. Events appended to the batch later
+    // on (e.g. by a nested processEvents()) may target a new receiver at the same address
+    // and must still be delivered.
+    if (s_eventLoopInstance != this)
+        return;
+    m_postman->removeFiltersFor(&evReceiver);
+    for (auto &batch : m_deliveryBatches) {
+        if (batch.index < batch.events.size())
+            batch.cancelledTargets[&evReceiver] = batch.events.size();
+    }
+    if (m_frameUpdateBatch.index < m_frameUpdateBatch.events.size())
+        m_frameUpdateBatch.cancelledTargets[&evReceiver] = m_frameUpdateBatch.events.size();
+
+    // Drop the update held back for the next frame, moving the last one into its slot
+    const auto it = m_pendingFrameUpdateIndices.find(&evReceiver);
+    if (it != m_pendingFrameUpdateIndices.end()) {
+        const size_t index = it->second;
+        m_pendingFrameUpdateIndices.erase(it);
+        if (index != m_pendingFrameUpdates.size() - 1) {
+            m_pendingFrameUpdates[index] = std::move(m_pendingFrameUpdates.back());
+            m_pendingFrameUpdateIndices[m_pendingFrameUpdates[index].target()] = index;
+        }
+        m_pendingFrameUpdates.pop_back();
+    }
+}
+
+bool EventLoop::postEventIfAlive(Id eventLoopId, EventReceiver *target, std::unique_ptr<Event> &&event, EventQueue::Priority priority)
+{
+    return withEventLoop(eventLoopId, [&](EventLoop *eventLoop) {
+        eventLoop->postEvent(target, std::move(event), priority);
+    });
+}
+
+bool EventLoop::removeAllEventsTargetingIfAlive(Id eventLoopId, EventReceiver &evReceiver)
+{
+    return withEventLoop(eventLoopId, [&](EventLoop *eventLoop) {
+        eventLoop->removeAllEventsTargeting(evReceiver);
+    });
+}
+
+bool EventLoop::postCallbackIfAlive(Id eventLoopId, std::function<void()> callback, EventQueue::Priority priority)
+{
+    return withEventLoop(eventLoopId, [&](EventLoop *eventLoop) {
+        eventLoop->postCallback(std::move(callback), priority);
+    });
+}
+
 void EventLoop::processEvents(int timeout)
 {
-    // Deliver any events that have already been posted
-    for (size_t eventIndex = 0, eventCount = m_eventQueue.size(); eventIndex < eventCount; ++eventIndex) {
-        auto postedEvent = m_eventQueue.tryPop();
-        if (!postedEvent)
-            break;
-        const auto target = postedEvent->target();
-        const auto ev = postedEvent->wrappedEvent();
+#if KDFOUNDATION_INSTRUMENTATION
+    const ScopedLatencyMeasurement measurement(m_statistics->iterationTime);
+    m_statistics->queueDepth.record(uint64_t(m_eventQueue.size()));
+#endif
+
+    // Pick up the input that arrived since the last wait before starting a frame
+    if (m_platformEventLoop && isFrameDue(std::chrono::steady_clock::now()))
+        m_platformEventLoop->waitForEvents(0);
+
+    // Deliver the events that have already been posted, highest priority first. Events
+    // posted while delivering are left for the next iteration, except for high priority
+    // ones which get to cut in line.
+    deliverPostedEvents(EventQueue::Priority::High);
+    deliverPostedEvents(EventQueue::Priority::Normal);
+    deliverPostedEvents(EventQueue::Priority::Low);
 
-        m_postman->deliverEvent(target, ev);
+    // Idle events are only delivered once nothing else is pending. So that a busy loop
+    // cannot starve them, they are delivered anyway after having been held back for a
+    // few iterations.
+    const auto idleEventCount = m_eventQueue.size(EventQueue::Priority::Idle);
+    if (idleEventCount != 0) {
+        constexpr int maxIdleDeferrals = 8;
+        const bool otherEventsPending = m_eventQueue.size() != idleEventCount;
+        if (!otherEventsPending || ++m_idleDeferrals > maxIdleDeferrals) {
+            m_idleDeferrals = 0;
+            deliverPostedEvents(EventQueue::Priority::Idle);
+        }
     }
 
-    // Poll/wait for new events
+    // Delete the objects scheduled for deletion by the events delivered above, or since
+    // the last iteration
+    deleteDeferredObjects();
+
+    if (isFrameDue(std::chrono::steady_clock::now()))
+        deliverFrame();
+
+    // Poll/wait for new events. Don't block while idle events are waiting for their turn,
+    // nor past the next frame.
     if (!m_platformEventLoop)
         return;
+    if (m_eventQueue.size(EventQueue::Priority::Idle) != 0)
+        timeout = 0;
+    if (!m_pendingFrameUpdates.empty()) {
+        const auto untilNextFrame = std::max(m_nextFrameTime - std::chrono::steady_clock::now(), std::chrono::steady_clock::duration::zero());
+        // Rounded up, the platform loops wait for whole milliseconds and would spin otherwise
+        const int frameTimeout = static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(untilNextFrame).count());
+        if (timeout < 0 || frameTimeout < timeout)
+            timeout = frameTimeout;
+    }
+
+    // Use the time the loop would spend blocked for the idle handlers. Don't block
+    // either if they have more work pending or have just scheduled some.
+    if (timeout != 0 && m_eventQueue.size() == 0 && !m_idleHandlers.empty()) {
+        const bool moreIdleWorkPending = runIdleHandlers();
+        if (moreIdleWorkPending || m_eventQueue.size() != 0 || !m_deferredDeletions.empty())
+            timeout = 0;
+    }
     m_platformEventLoop->waitForEvents(timeout);
 }
 
+void EventLoop::deliverPostedEvents(EventQueue::Priority priority)
+{
+    // Take all events of this lane in one go and deliver them without holding the
+    // queue lock
+    auto &batch = m_deliveryBatches[static_cast<size_t>(priority)];
+    m_eventQueue.takeAll(priority, batch.events);
+    while (batch.index < batch.events.size()) {
+        // High priority events posted in the meantime cut in line. At least one event of
+        // this lane is delivered in between, so lower lanes always make progress.
+        if (priority != EventQueue::Priority::High && m_eventQueue.size(EventQueue::Priority::High) != 0) {
+            deliverPostedEvents(EventQueue::Priority::High);
+            // A nested processEvents() may have drained this batch already
+            if (batch.index >= batch.events.size())
+                break;
+        }
+
+        // Move the event out as a nested processEvents() may grow the batch
+        const size_t index = batch.index++;
+        PostedEvent postedEvent = std::move(batch.events[index]);
+        const auto target = postedEvent.target();
+
+        if (!batch.cancelledTargets.empty()) {
+            const auto it = batch.cancelledTargets.find(target);
+            if (it != batch.cancelledTargets.end() && index < it->second)
+                continue;
+        }
+
+        if (m_framePeriod.count() != 0 && postedEvent.wrappedEvent()->type() == Event::Type::Update) {
+            holdForNextFrame(std::move(postedEvent));
+            continue;
+        }
+
+        deliverPostedEvent(postedEvent);
+    }
+    batch.events.clear();
+    batch.index = 0;
+    batch.cancelledTargets.clear();
+}
+
+void EventLoop::deliverPostedEvent(PostedEvent &postedEvent)
+{
+#if KDFOUNDATION_INSTRUMENTATION
+    const auto deliveryStartTime = std::chrono::steady_clock::now();
+    m_statistics->deliveryLatency.record(deliveryStartTime - postedEvent.postedAt());
+    auto &handlerTime = m_statistics->handlerTime(postedEvent.wrappedEvent()->type());
+#endif
+    Event *event = postedEvent.wrappedEvent();
+    if (event->type() == Event::Type::Invoke) {
+        // Callbacks aren't events for the target to handle, it only bounds their lifetime:
+        // they are dropped along with the other events targeting it. Calling them here
+        // keeps filters and event() overrides from swallowing them.
+        static_cast<InvokeEvent *>(event)->invoke();
+        event->setAccepted(true);
+    } else {
+        m_postman->deliverEvent(postedEvent.target(), event);
+    }
+#if KDFOUNDATION_INSTRUMENTATION
+    handlerTime.record(std::chrono::steady_clock::now() - deliveryStartTime);
+#endif
+}
+
+void EventLoop::setFramePeriod(std::chrono::nanoseconds period)
+{
+    // Updates held back so far go out with the next frame, or right away if pacing is off
+    m_framePeriod = std::max(period, std::chrono::nanoseconds::zero());
+}
+
+bool EventLoop::isFrameDue(std::chrono::steady_clock::time_point now) const
+{
+    return !m_pendingFrameUpdates.empty() && (m_framePeriod.count() == 0 || now >= m_nextFrameTime);
+}
+
+void EventLoop::holdForNextFrame(PostedEvent &&postedEvent)
+{
+    // UpdateEvents merge, the ones for a target already having one pending are dropped
+    if (!m_pendingFrameUpdateIndices.try_emplace(postedEvent.target(), m_pendingFrameUpdates.size()).second)
+        return;
+
+    // A loop that went without frames for a while starts the next one right away
+    if (m_pendingFrameUpdates.empty())
+        m_nextFrameTime = std::max(m_nextFrameTime, std::chrono::steady_clock::now());
+    m_pendingFrameUpdates.push_back(std::move(postedEvent));
+}
+
+void EventLoop::deliverFrame()
+{
+    const auto deadline = m_nextFrameTime;
+    ++m_frameCount;
+
+    // Updates posted while delivering wait for the next frame, scheduled before
+    // delivering in case a handler runs a nested processEvents()
+    auto &batch = m_frameUpdateBatch;
+    if (batch.events.empty()) {
+        std::swap(batch.events, m_pendingFrameUpdates);
+    } else {
+        std::move(m_pendingFrameUpdates.begin(), m_pendingFrameUpdates.end(), std::back_inserter(batch.events));
+        m_pendingFrameUpdates.clear();
+    }
+    m_pendingFrameUpdateIndices.clear();
+    m_nextFrameTime = deadline + m_framePeriod;
+
+    while (batch.index < batch.events.size()) {
+        const size_t index = batch.index++;
+        PostedEvent postedEvent = std::move(batch.events[index]);
+        if (!batch.cancelledTargets.empty()) {
+            const auto it = batch.cancelledTargets.find(postedEvent.target());
+            if (it != batch.cancelledTargets.end() && index < it->second)
+                continue;
+        }
+        deliverPostedEvent(postedEvent);
+    }
+    batch.events.clear();
+    batch.index = 0;
+    batch.cancelledTargets.clear();
+
+    // Skip the deadlines the frame ran past instead of bunching up frames to catch up
+    if (m_framePeriod.count() == 0)
+        return;
+    const auto frameEnd = std::chrono::steady_clock::now();
+    if (frameEnd >= m_nextFrameTime) {
+        const auto missedFrames = static_cast<uint64_t>((frameEnd - deadline) / m_framePeriod);
+        m_missedFrameCount += missedFrames;
+        m_nextFrameTime = deadline + m_framePeriod * static_cast<int64_t>(missedFrames + 1);
+        frameOverrun.emit(missedFrames);
+    }
+}
+
+void EventLoop::scheduleDeferredDeletion(Object *object)
+{
+    assert(s_eventLoopInstance == this);
+    if (object->m_deferredDeletionIndex != Object::NotScheduledForDeletion)
+        return;
+    object->m_deferredDeletionIndex = m_deferredDeletions.size();
+    object->m_deferredDeletionLoop = this;
+    m_deferredDeletions.push_back(object);
+}
+
+void EventLoop::cancelDeferredDeletion(Object *object)
+{
+    assert(object->m_deferredDeletionLoop == this);
+    const size_t index = object->m_deferredDeletionIndex;
+    object->m_deferredDeletionIndex = Object::NotScheduledForDeletion;
+    object->m_deferredDeletionLoop = nullptr;
+    if (index < m_deferredDeletions.size() && m_deferredDeletions[index] == object)
+        m_deferredDeletions[index] = nullptr;
+}
+
+void EventLoop::deleteDeferredObjects()
+{
+    if (m_deferredDeletions.empty() || m_deletingDeferredObjects)
+        return;
+    m_deletingDeferredObjects = true;
+
+    // Objects scheduled for deletion by the destructors run from here wait for the
+    // next iteration
+    const size_t count = m_deferredDeletions.size();
+    for (size_t i = 0; i < count; ++i) {
+        Object *object = m_deferredDeletions[i];
+        if (object == nullptr)
+            continue;
+
+        // Leave the object to an ancestor deleted further down the list. Entries of objects
+        // destroyed along with their ancestors clear themselves.
+        const Object *ancestor = object->parent();
+        while (ancestor != nullptr && (ancestor->m_deferredDeletionIndex <= i || ancestor->m_deferredDeletionIndex >= count))
+            ancestor = ancestor->parent();
+        if (ancestor != nullptr)
+            continue;
+
+        m_deferredDeletions[i] = nullptr;
+        object->m_deferredDeletionIndex = Object::NotScheduledForDeletion;
+        object->m_deferredDeletionLoop = nullptr;
+        if (Object *parent = object->parent())
+            parent->takeChild(object);
+        else
+            delete object;
+    }
+
+    // Move the objects scheduled in the meantime to the front of the list
+    m_deferredDeletions.erase(m_deferredDeletions.begin(), m_deferredDeletions.begin() + count);
+    for (size_t i = 0; i < m_deferredDeletions.size(); ++i) {
+        if (m_deferredDeletions[i] != nullptr)
+            m_deferredDeletions[i]->m_deferredDeletionIndex = i;
+    }
+    m_deletingDeferredObjects = false;
+}
+
+EventLoop::IdleHandlerId EventLoop::addIdleHandler(IdleHandler handler)
+{
+    if (!handler)
+        return 0;
+    const IdleHandlerId id = m_nextIdleHandlerId++;
+    m_idleHandlers.push_back(IdleHandlerEntry{ id, std::move(handler) });
+    return id;
+}
+
+bool EventLoop::removeIdleHandler(IdleHandlerId id)
+{
+    auto it = std::find_if(m_idleHandlers.begin(), m_idleHandlers.end(), [id](const auto &entry) {
+        return entry.id == id && !entry.removed;
+    });
+    if (it == m_idleHandlers.end())
+        return false;
+
+    // Entries are only erased after a pass, a handler may remove handlers while it runs
+    if (m_runningIdleHandlers) {
+        it->removed = true;
+        it->handler = nullptr;
+    } else {
+        m_idleHandlers.erase(it);
+    }
+    return true;
+}
+
+bool EventLoop::runIdleHandlers()
+{
+    // Handlers calling processEvents() don't get to run the others
+    if (m_runningIdleHandlers)
+        return false;
+    m_runningIdleHandlers = true;
+
+    // Leave the time of the next frame to it
+    auto deadline = std::chrono::steady_clock::now() + m_idleTimeBudget;
+    if (!m_pendingFrameUpdates.empty())
+        deadline = std::min(deadline, m_nextFrameTime);
+    bool moreWorkPending = false;
+    // Handlers added while running wait for the next pass
+    const size_t count = m_idleHandlers.size();
+    for (size_t i = 0; i < count; ++i) {
+        // At least one handler runs per pass, the ones out of time go first next time
+        if (i != 0 && std::chrono::steady_clock::now() >= deadline) {
+            moreWorkPending = true;
+            break;
+        }
+
+        const size_t index = (m_nextIdleHandler + i) % count;
+        m_nextIdleHandler = (index + 1) % count;
+        if (m_idleHandlers[index].removed)
+            continue;
+
+        // Move the handler out while it runs as adding handlers may grow the list
+        IdleHandler handler = std::move(m_idleHandlers[index].handler);
+        const IdleStatus status = handler(deadline);
+        auto &entry = m_idleHandlers[index];
+        if (!entry.removed)
+            entry.handler = std::move(handler);
+        if (status == IdleStatus::MoreWorkPending)
+            moreWorkPending = true;
+    }
+
+    m_idleHandlers.erase(std::remove_if(m_idleHandlers.begin(), m_idleHandlers.end(), [](const auto &entry) {
+                             return entry.removed;
+                         }),
+                         m_idleHandlers.end());
+    if (m_nextIdleHandler >= m_idleHandlers.size())
+        m_nextIdleHandler = 0;
+    m_runningIdleHandlers = false;
+    return moreWorkPending;
+}
+
+#if KDFOUNDATION_INSTRUMENTATION
+void EventLoop::resetStatistics()
+{
+    m_statistics->iterationTime.reset();
+    m_statistics->queueDepth.reset();
+    m_statistics->deliveryLatency.reset();
+    for (auto &handlerTime : m_statistics->handlerTimes)
+        handlerTime.reset();
+    if (m_platformEventLoop)
+        m_platformEventLoop->waitTime().reset();
+}
+#endif
+
 int EventLoop::exec()
 {
     if (!m_platformEventLoop)
@@ -12,9 +12,13 @@
 
 #pragma once
 
+#include <KDFoundation/config.h>
 #include <KDFoundation/kdfoundation_global.h>
 #include <KDFoundation/object.h>
 #include <KDFoundation/event_queue.h>
+#if KDFOUNDATION_INSTRUMENTATION
+#include <KDFoundation/latency_histogram.h>
+#endif
 #include <KDFoundation/platform/abstract_platform_integration.h>
 
 #include <KDUtils/logging.h>
@@ -22,20 +26,28 @@
 
 #include <kdbindings/property.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
+#include <thread>
+#include <unordered_map>
 #include <vector>
 
 namespace KDFoundation {
 
 class AbstractPlatformEventLoop;
 class Postman;
+enum class TimerType : uint8_t;
 
 class KDFOUNDATION_API EventLoop
 {
 public:
-    EventLoop(std::unique_ptr<AbstractPlatformEventLoop> platformEventLoop = nullptr);
+    EventLoop(std::unique_ptr<AbstractPlatformEventLoop> platformEventLoop = nullptr,
+              EventQueue::Backend eventQueueBackend = EventQueue::defaultBackend());
     ~EventLoop();
 
     static EventLoop *instance();
@@ -45,12 +57,84 @@ public:
 
     Postman *postman() { return m_postman.get(); }
 
-    void postEvent(EventReceiver *target, std::unique_ptr<Event> &&event);
-    void removeAllEventsTargeting(EventReceiver &evReceiver) { m_eventQueue.removeAllEventsTargeting(evReceiver); }
+    void postEvent(EventReceiver *target, std::unique_ptr<Event> &&event,
+                   EventQueue::Priority priority = EventQueue::Priority::Normal);
+    // Posts all events in one go and wakes the event loop up only once
+    void postEvents(std::vector<EventQueue::TargetedEvent> &&events,
+                    EventQueue::Priority priority = EventQueue::Priority::Normal);
+    // Calls callback on the thread running this loop. May be called from any thread.
+    void postCallback(std::function<void()> callback,
+                      EventQueue::Priority priority = EventQueue::Priority::Normal);
+    void removeAllEventsTargeting(EventReceiver &evReceiver);
+
+    // Identifies a loop. Unlike its address, which a loop created later may reuse, the id
+    // of a loop is never given to another one. Ids start at 1.
+    using Id = uint64_t;
+    Id id() const { return m_id; }
+    // The thread running the loop, which is the one that created it
+    std::thread::id threadId() const { return m_threadId; }
+
+    // Like postEvent(), removeAllEventsTargeting() and postCallback() on the loop with the
+    // given id, except that they do nothing and return false if that loop has been
+    // destroyed. For use with loops of other threads, e.g. the loop a receiver lives on,
+    // see EventReceiver::eventLoopId().
+    static bool postEventIfAlive(Id eventLoopId, EventReceiver *target, std::unique_ptr<Event> &&event,
+                                 EventQueue::Priority priority = EventQueue::Priority::Normal);
+    static bool removeAllEventsTargetingIfAlive(Id eventLoopId, EventReceiver &evReceiver);
+    static bool postCallbackIfAlive(Id eventLoopId, std::function<void()> callback,
+                                    EventQueue::Priority priority = EventQueue::Priority::Normal);
+
     EventQueue::size_type eventQueueSize() const { return m_eventQueue.size(); }
+    EventQueue::size_type eventQueueSize(EventQueue::Priority priority) const { return m_eventQueue.size(priority); }
+    EventQueue::Backend eventQueueBackend() const { return m_eventQueue.backend(); }
+
+    // Opt-in coalescing of posted events, see EventQueue::setCoalescingEnabled()
+    void setEventCoalescingEnabled(bool enabled) { m_eventQueue.setCoalescingEnabled(enabled); }
+    bool isEventCoalescingEnabled() const { return m_eventQueue.isCoalescingEnabled(); }
 
     void sendEvent(EventReceiver *target, Event *event);
 
+    // What an idle handler reports back, whether it would like to be called again right
+    // away or the loop may go to sleep
+    enum class IdleStatus : uint8_t {
+        Done,
+        MoreWorkPending
+    };
+    // Called with the time by which it should return, yielding if its work isn't done by then
+    using IdleHandler = std::function<IdleStatus(std::chrono::steady_clock::time_point deadline)>;
+    using IdleHandlerId = uint64_t;
+
+    // Idle handlers are run by processEvents() when no posted event is pending and it
+    // would otherwise block waiting for events, for up to idleTimeBudget() per iteration.
+    // Handlers take turns when they don't all fit in the budget. As long as one of them
+    // reports more work pending the loop only polls for events, otherwise it sleeps until
+    // woken up and the handlers run again the next time it is about to block. Must be
+    // called from the thread running this loop, handlers included.
+    IdleHandlerId addIdleHandler(IdleHandler handler);
+    bool removeIdleHandler(IdleHandlerId id);
+
+    void setIdleTimeBudget(std::chrono::microseconds budget) { m_idleTimeBudget = budget; }
+    std::chrono::microseconds idleTimeBudget() const { return m_idleTimeBudget; }
+
+    // Frame-paced mode, off while the frame period is zero. Posted UpdateEvents are then
+    // held back and delivered in frames, at most one per target and frame, started at
+    // most once per frame period. Input and other events keep being delivered as they
+    // come, the wait for events being cut short at the next frame deadline. Frames are
+    // only scheduled while updates are pending, an idle loop doesn't wake up for them.
+    // Must be called from the thread running this loop.
+    void setFramePeriod(std::chrono::nanoseconds period);
+    std::chrono::nanoseconds framePeriod() const { return m_framePeriod; }
+
+    // Number of frames delivered, and of frame deadlines missed because a frame started
+    // late or took too long
+    uint64_t frameCount() const { return m_frameCount; }
+    uint64_t missedFrameCount() const { return m_missedFrameCount; }
+
+    // Emitted after a frame that ended past the deadline of the following one, with the
+    // number of frame deadlines missed. The next frame is scheduled on the next deadline
+    // still ahead rather than trying to catch up.
+    KDBindings::Signal<uint64_t> frameOverrun;
+
     void processEvents(int timeout = 0);
 
     int exec();
@@ -58,11 +142,124 @@ public:
 
     std::shared_ptr<KDBindings::ConnectionEvaluator> connectionEvaluator();
 
+    // Calls callback once after delay, see Timer::singleShot()
+    void singleShot(std::chrono::microseconds delay, std::function<void()> callback, TimerType type);
+
+#if KDFOUNDATION_INSTRUMENTATION
+    // Measurements taken by the loop while running. Durations are in nanoseconds. The
+    // histograms may be read from any thread, see LatencyHistogram.
+    struct Statistics {
+        // Events of user defined types share the last entry of handlerTimes
+        static constexpr size_t HandlerTimeCount = static_cast<size_t>(Event::Type::Invoke) + 2;
+
+        // Duration of processEvents(), including the wait for events
+        LatencyHistogram iterationTime;
+        // Number of posted events pending when processEvents() starts
+        LatencyHistogram queueDepth;
+        // Time from posting an event to its delivery
+        LatencyHistogram deliveryLatency;
+        // Time spent delivering posted and sent events, by event type
+        std::array<LatencyHistogram, HandlerTimeCount> handlerTimes;
+
+        const LatencyHistogram &handlerTime(Event::Type type) const { return handlerTimes[handlerTimeIndex(type)]; }
+        LatencyHistogram &handlerTime(Event::Type type) { return handlerTimes[handlerTimeIndex(type)]; }
+
+        static size_t handlerTimeIndex(Event::Type type)
+        {
+            return std::min(static_cast<size_t>(type), HandlerTimeCount - 1);
+        }
+    };
+    const Statistics &statistics() const { return *m_statistics; }
+    // Must be called from the thread running this loop
+    void resetStatistics();
+#endif
+
 private:
+    friend class Object;
+
     EventQueue m_eventQueue;
+
+    void deliverPostedEvents(EventQueue::Priority priority);
+    void deliverPostedEvent(PostedEvent &postedEvent);
+
+    // Deferred deletions of the objects living on this loop. Object::deleteLater() adds
+    // the object to m_deferredDeletions, which is flushed once per processEvents(), rather
+    // than going through the event queue and the postman. Objects remember their index
+    // in the list, which makes scheduling a deletion twice a no-op and lets objects
+    // destroyed in the meantime clear their entry. Only touched by the thread running
+    // this loop.
+    void scheduleDeferredDeletion(Object *object);
+    void cancelDeferredDeletion(Object *object);
+    void deleteDeferredObjects();
+    std::vector<Object *> m_deferredDeletions;
+    bool m_deletingDeferredObjects = false;
+
+    // Returns whether a handler has more work pending
+    bool runIdleHandlers();
+    struct IdleHandlerEntry {
+        IdleHandlerId id;
+        // Empty while the handler runs
+        IdleHandler handler;
+        bool removed = false;
+    };
+    std::vector<IdleHandlerEntry> m_idleHandlers;
+    IdleHandlerId m_nextIdleHandlerId = 1;
+    // Handler the next pass starts with, so that all get their turn
+    size_t m_nextIdleHandler = 0;
+    bool m_runningIdleHandlers = false;
+    std::chrono::microseconds m_idleTimeBudget{ 5000 };
+
+    // Posted events taken from one lane of m_eventQueue that are being delivered,
+    // together with the index of the next event to deliver. Only touched by the thread
+    // running this loop. The list keeps its capacity and is handed back to the queue
+    // on the next iteration.
+    struct DeliveryBatch {
+        EventQueue::EventList events;
+        size_t index = 0;
+        // Receivers destroyed while the batch was being delivered, mapped to the batch
+        // index up to which their events must be skipped
+        std::unordered_map<const EventReceiver *, size_t> cancelledTargets;
+    };
+    std::array<DeliveryBatch, EventQueue::PriorityCount> m_deliveryBatches;
+    // Number of iterations idle events have been held back for because other events
+    // were pending
+    int m_idleDeferrals = 0;
+
+    // Frame pacing. Update events taken out of the queue wait in m_pendingFrameUpdates,
+    // indexed by target, for the next frame, which delivers them from m_frameUpdateBatch.
+    bool isFrameDue(std::chrono::steady_clock::time_point now) const;
+    void holdForNextFrame(PostedEvent &&postedEvent);
+    void deliverFrame();
+    std::chrono::nanoseconds m_framePeriod{ 0 };
+    std::chrono::steady_clock::time_point m_nextFrameTime;
+    EventQueue::EventList m_pendingFrameUpdates;
+    std::unordered_map<const EventReceiver *, size_t> m_pendingFrameUpdateIndices;
+    DeliveryBatch m_frameUpdateBatch;
+    uint64_t m_frameCount = 0;
+    uint64_t m_missedFrameCount = 0;
+
+    Id m_id = 0;
+    const std::thread::id m_threadId{ std::this_thread::get_id() };
     bool m_quitRequested = false;
     std::unique_ptr<AbstractPlatformEventLoop> m_platformEventLoop;
     std::unique_ptr<Postman> m_postman;
+
+    // Target of the events posted by postCallback()
+    class CallbackReceiver : public EventReceiver
+    {
+    public:
+        void event(EventReceiver *target, Event *ev) override;
+    };
+    CallbackReceiver m_callbackReceiver;
+
+    // Timers used for single shots on platforms that can't do without. They are reused
+    // once they have fired.
+    struct SingleShotTimer;
+    std::vector<std::unique_ptr<SingleShotTimer>> m_singleShotTimers;
+
+#if KDFOUNDATION_INSTRUMENTATION
+    std::unique_ptr<Statistics> m_statistics;
+#endif
 };
 
 } // namespace KDFoundation
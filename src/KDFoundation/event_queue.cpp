@@ -0,0 +1,390 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2018 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+  Author: Paul Lemire <paul.lemire@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "event_queue.h"
+#include "hashutils.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iterator>
+#include <string_view>
+
+using namespace KDFoundation;
+
+struct EventQueue::InboxNode {
+    std::atomic<InboxNode *> next{ nullptr };
+    std::optional<PostedEvent> event;
+    Priority priority = Priority::Normal;
+};
+
+EventQueue::Backend EventQueue::defaultBackend()
+{
+    static const Backend backend = [] {
+        if (const char *value = std::getenv("KDFOUNDATION_EVENT_QUEUE_BACKEND")) // NOLINT(concurrency-mt-unsafe)
+            return std::string_view{ value } == "lockfree" ? Backend::LockFree : Backend::Locking;
+        return Backend::Locking;
+    }();
+    return backend;
+}
+
+EventQueue::EventQueue(Backend backend)
+    : m_backend{ backend }
+{
+    if (m_backend == Backend::LockFree) {
+        // The list always contains at least one node. The node at the tail is a dummy
+        // whose event has already been handed over to the consumer.
+        auto stub = new InboxNode;
+        m_inboxHead.store(stub, std::memory_order_relaxed);
+        m_inboxTail = stub;
+    }
+}
+
+EventQueue::~EventQueue()
+{
+    if (m_backend == Backend::LockFree) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        collectInbox();
+        delete m_inboxTail;
+    }
+}
+
+void EventQueue::push(PostedEvent &&event, Priority priority)
+{
+    if (m_backend == Backend::LockFree) {
+        pushToInbox(std::move(event), priority);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (appendToLane(m_lanes[static_cast<size_t>(priority)], std::move(event)))
+        addToSize(priority, 1);
+}
+
+void EventQueue::push(std::unique_ptr<PostedEvent> &&event, Priority priority)
+{
+    push(std::move(*event), priority);
+}
+
+void EventQueue::push(EventReceiver *target, std::unique_ptr<Event> &&event, Priority priority)
+{
+    push(PostedEvent(target, std::forward<std::unique_ptr<Event>>(event)), priority);
+}
+
+void EventQueue::push(std::vector<TargetedEvent> &&events, Priority priority)
+{
+    if (events.empty())
+        return;
+
+    if (m_backend == Backend::LockFree) {
+        // Chain the nodes up privately and publish the whole chain at once
+        InboxNode *first = nullptr;
+        InboxNode *last = nullptr;
+        for (auto &[target, event] : events) {
+            auto node = new InboxNode;
+            node->event.emplace(target, std::move(event));
+            node->priority = priority;
+            if (last)
+                last->next.store(node, std::memory_order_relaxed);
+            else
+                first = node;
+            last = node;
+        }
+        pushToInbox(first, last, events.size(), priority);
+        events.clear();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto &lane = m_lanes[static_cast<size_t>(priority)];
+    size_type appendedCount = 0;
+    for (auto &[target, event] : events) {
+        if (appendToLane(lane, PostedEvent(target, std::move(event))))
+            ++appendedCount;
+    }
+    addToSize(priority, appendedCount);
+    events.clear();
+}
+
+std::unique_ptr<PostedEvent> EventQueue::tryPop()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    collectInbox();
+    for (auto &lane : m_lanes) {
+        if (lane.liveCount() == 0)
+            continue;
+        lane.skipDead();
+        auto ev = std::make_unique<PostedEvent>(std::move(lane.events[lane.head++]));
+        if (lane.liveCount() == 0)
+            lane.reset();
+        else
+            --lane.pendingCounts[ev->target()];
+        subtractFromSize(lane, 1);
+        return ev;
+    }
+    return std::unique_ptr<PostedEvent>();
+}
+
+PostedEvent *EventQueue::peek() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    collectInbox();
+    for (auto &lane : m_lanes) {
+        if (lane.liveCount() == 0)
+            continue;
+        lane.skipDead();
+        return &lane.events[lane.head];
+    }
+    return nullptr;
+}
+
+void EventQueue::takeAll(Priority priority, EventList &events)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    collectInbox();
+    takeAllLocked(m_lanes[static_cast<size_t>(priority)], events);
+}
+
+void EventQueue::takeAll(EventList &events)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    collectInbox();
+    for (auto &lane : m_lanes)
+        takeAllLocked(lane, events);
+}
+
+void EventQueue::takeAllLocked(Lane &lane, EventList &events)
+{
+    const auto takenCount = lane.liveCount();
+    if (takenCount == 0) {
+        lane.reset();
+        return;
+    }
+
+    if (lane.deadCount != 0) {
+        // Leave the events of removed receivers behind
+        events.reserve(events.size() + takenCount);
+        for (size_type index = lane.head, end = lane.events.size(); index < end; ++index) {
+            if (!lane.isDead(index))
+                events.push_back(std::move(lane.events[index]));
+        }
+    } else if (events.empty() && lane.head == 0) {
+        std::swap(events, lane.events);
+    } else {
+        events.reserve(events.size() + takenCount);
+        std::move(lane.events.begin() + static_cast<std::ptrdiff_t>(lane.head), lane.events.end(), std::back_inserter(events));
+    }
+    lane.reset();
+    subtractFromSize(lane, takenCount);
+}
+
+void EventQueue::removeAllEventsTargeting(EventReceiver &eventReceiver)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    collectInbox();
+    for (auto &lane : m_lanes) {
+        size_type *pendingCount = lane.pendingCounts.find(&eventReceiver);
+        if (!pendingCount || *pendingCount == 0)
+            continue;
+
+        // Every pending event of the receiver is before the current end of the lane
+        const size_type removedCount = *pendingCount;
+        *pendingCount = 0;
+        lane.cancelledBefore[&eventReceiver] = lane.events.size();
+        lane.deadCount += removedCount;
+        subtractFromSize(lane, removedCount);
+        if (lane.liveCount() == 0)
+            lane.reset();
+    }
+}
+
+void EventQueue::setCoalescingEnabled(bool enabled)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_coalescingEnabled = enabled;
+    if (!enabled) {
+        for (auto &lane : m_lanes)
+            lane.latestEvents.clear();
+    }
+}
+
+bool EventQueue::isCoalescingEnabled() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_coalescingEnabled;
+}
+
+size_t EventQueue::CoalescingKeyHash::operator()(const CoalescingKey &key) const
+{
+    uint64_t seed = 0;
+    hash_combine(seed, key.target);
+    hash_combine(seed, static_cast<uint16_t>(key.type));
+    return static_cast<size_t>(seed);
+}
+
+bool EventQueue::appendToLane(Lane &lane, PostedEvent &&event) const
+{
+    const EventReceiver *target = event.target();
+    if (m_coalescingEnabled) {
+        Event *newer = event.wrappedEvent();
+        const size_type index = lane.events.size();
+        auto [it, inserted] = lane.latestEvents.try_emplace({ target, newer->type() }, index);
+        if (!inserted) {
+            const size_type latestIndex = it->second;
+            // Only merge into events that are still pending
+            if (latestIndex >= lane.head && !lane.isDead(latestIndex) &&
+                lane.events[latestIndex].wrappedEvent()->mergeWith(*newer))
+                return false;
+            // Otherwise the newer event is the one to merge into from now on
+            it->second = index;
+        }
+    }
+    lane.events.push_back(std::move(event));
+    ++lane.pendingCounts[target];
+    return true;
+}
+
+void EventQueue::addToSize(Priority priority, size_type count)
+{
+    m_lanes[static_cast<size_t>(priority)].size.fetch_add(count, std::memory_order_release);
+    m_size.fetch_add(count, std::memory_order_release);
+}
+
+void EventQueue::subtractFromSize(Lane &lane, size_type count) const
+{
+    if (count == 0)
+        return;
+    lane.size.fetch_sub(count, std::memory_order_release);
+    m_size.fetch_sub(count, std::memory_order_release);
+}
+
+void EventQueue::pushToInbox(PostedEvent &&event, Priority priority)
+{
+    auto node = new InboxNode;
+    node->event.emplace(std::move(event));
+    node->priority = priority;
+    pushToInbox(node, node, 1, priority);
+}
+
+void EventQueue::pushToInbox(InboxNode *first, InboxNode *last, size_type count, Priority priority)
+{
+    // Account for the events before they become visible to the consumer so that size()
+    // may briefly over-report but never wraps around.
+    addToSize(priority, count);
+
+    // Swing the head to our last node, then link the previous head to our first one.
+    // Between the two steps the consumer sees the list as ending at the previous head
+    // and simply picks up our nodes on its next collection.
+    InboxNode *previous = m_inboxHead.exchange(last, std::memory_order_acq_rel);
+    previous->next.store(first, std::memory_order_release);
+}
+
+void EventQueue::collectInbox() const
+{
+    if (m_backend != Backend::LockFree)
+        return;
+
+    InboxNode *tail = m_inboxTail;
+    InboxNode *next = tail->next.load(std::memory_order_acquire);
+    while (next != nullptr) {
+        // next becomes the new dummy once its event has been moved out. Merged events
+        // were accounted for when pushed, so take them out again.
+        auto &lane = m_lanes[static_cast<size_t>(next->priority)];
+        if (!appendToLane(lane, std::move(*next->event)))
+            subtractFromSize(lane, 1);
+        next->event.reset();
+        delete tail;
+        tail = next;
+        next = tail->next.load(std::memory_order_acquire);
+    }
+    m_inboxTail = tail;
+}
+
+bool EventQueue::Lane::isDead(size_type index)
+{
+    if (cancelledBefore.isEmpty())
+        return false;
+    const size_type *before = cancelledBefore.find(events[index].target());
+    return before && index < *before;
+}
+
+void EventQueue::Lane::skipDead()
+{
+    while (deadCount != 0 && isDead(head)) {
+        ++head;
+        --deadCount;
+    }
+}
+
+size_t EventQueue::TargetTable::slotIndexFor(const EventReceiver *target, size_t slotCount)
+{
+    // Fibonacci hashing, the slot count is a power of two
+    const auto key = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(target));
+    return static_cast<size_t>((key * 0x9e3779b97f4a7c15ULL) >> 32) & (slotCount - 1);
+}
+
+EventQueue::size_type *EventQueue::TargetTable::find(const EventReceiver *target)
+{
+    if (m_liveCount == 0)
+        return nullptr;
+    const size_t mask = m_slots.size() - 1;
+    for (size_t index = slotIndexFor(target, m_slots.size());; index = (index + 1) & mask) {
+        Slot &slot = m_slots[index];
+        if (slot.generation != m_generation)
+            return nullptr;
+        if (slot.target == target)
+            return &slot.value;
+    }
+}
+
+EventQueue::size_type &EventQueue::TargetTable::operator[](const EventReceiver *target)
+{
+    // Keep the load factor at or below one half
+    if ((m_liveCount + 1) * 2 > m_slots.size())
+        grow();
+
+    const size_t mask = m_slots.size() - 1;
+    for (size_t index = slotIndexFor(target, m_slots.size());; index = (index + 1) & mask) {
+        Slot &slot = m_slots[index];
+        if (slot.generation != m_generation) {
+            slot = { target, 0, m_generation };
+            ++m_liveCount;
+            return slot.value;
+        }
+        if (slot.target == target)
+            return slot.value;
+    }
+}
+
+void EventQueue::TargetTable::clear()
+{
+    if (m_liveCount == 0)
+        return;
+    m_liveCount = 0;
+    if (++m_generation == 0) {
+        // Wrapped around, make sure no slot looks live by accident
+        for (auto &slot : m_slots)
+            slot.generation = 0;
+        m_generation = 1;
+    }
+}
+
+void EventQueue::TargetTable::grow()
+{
+    std::vector<Slot> oldSlots(std::max<size_t>(16, m_slots.size() * 2));
+    std::swap(oldSlots, m_slots);
+    const uint32_t oldGeneration = m_generation;
+    m_generation = 1;
+    m_liveCount = 0;
+    for (const auto &slot : oldSlots) {
+        if (slot.generation == oldGeneration)
+            (*this)[slot.target] = slot.value;
+    }
+}
@@ -14,76 +14,199 @@
 #include <KDFoundation/kdfoundation_global.h>
 #include <KDFoundation/event.h>
 
-#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
-#include <deque>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace KDFoundation {
 
 class KDFOUNDATION_API EventQueue
 {
 public:
-    EventQueue()
-    {
-    }
-
-    void push(std::unique_ptr<PostedEvent> &&event)
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        m_events.push_back(std::move(event));
-    }
-
-    void push(EventReceiver *target, std::unique_ptr<Event> &&event)
-    {
-        auto ev = std::make_unique<PostedEvent>(target, std::forward<std::unique_ptr<Event>>(event));
-        push(std::move(ev));
-    }
-
-    std::unique_ptr<PostedEvent> tryPop()
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        if (m_events.empty())
-            return std::unique_ptr<PostedEvent>();
-        auto ev = std::move(m_events.front());
-        m_events.pop_front();
-        return std::move(ev);
-    }
-
-    PostedEvent *peek() const
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        if (m_events.empty())
-            return nullptr;
-        return m_events.front().get();
-    }
+    enum class Backend : uint8_t {
+        // Every operation is serialized through a single mutex
+        Locking = 0,
+        // Producers hand over events through a lock-free multi-producer/single-consumer
+        // list and never take the mutex. Only the consuming side (popping, peeking and
+        // removing events) is serialized.
+        LockFree = 1
+    };
+
+    // Returns the backend used by default. This is Backend::Locking unless the
+    // KDFOUNDATION_EVENT_QUEUE_BACKEND environment variable is set to "lockfree".
+    static Backend defaultBackend();
+
+    explicit EventQueue(Backend backend = defaultBackend());
+    ~EventQueue();
+
+    // Not copyable
+    EventQueue(const EventQueue &other) = delete;
+    EventQueue &operator=(const EventQueue &other) = delete;
+
+    // Not movable
+    EventQueue(EventQueue &&other) = delete;
+    EventQueue &operator=(EventQueue &&other) = delete;
+
+    Backend backend() const { return m_backend; }
+
+    // Events are kept in one FIFO lane per priority. Consumers drain higher priority
+    // lanes first.
+    enum class Priority : uint8_t {
+        // Latency critical events such as QuitEvent
+        High = 0,
+        // The default for posted events
+        Normal = 1,
+        // Events that may wait until the normal ones have been handled
+        Low = 2,
+        // Events only worth handling when there is nothing else to do
+        Idle = 3
+    };
+    static constexpr size_t PriorityCount = 4;
+
+    // Posted events are stored inline so that queueing an event does not allocate
+    // once the storage has grown to its working size.
+    using EventList = std::vector<PostedEvent>;
+    using TargetedEvent = std::pair<EventReceiver *, std::unique_ptr<Event>>;
+
+    void push(PostedEvent &&event, Priority priority = Priority::Normal);
+    void push(std::unique_ptr<PostedEvent> &&event, Priority priority = Priority::Normal);
+    void push(EventReceiver *target, std::unique_ptr<Event> &&event, Priority priority = Priority::Normal);
+    // Appends all events, in order, taking the lock (Backend::Locking) or swinging the
+    // inbox head (Backend::LockFree) only once for the whole batch
+    void push(std::vector<TargetedEvent> &&events, Priority priority = Priority::Normal);
+
+    // Convenience for consumers handling one event at a time. Event loops use the
+    // allocation-free takeAll() instead. Events come out highest priority first.
+    std::unique_ptr<PostedEvent> tryPop();
+    PostedEvent *peek() const;
+
+    // Moves all pending events of the given priority, in order, to the back of events
+    // while taking the lock only once. If events is empty the storages are swapped
+    // instead, so that handing the same list back in on every call recycles its capacity.
+    void takeAll(Priority priority, EventList &events);
+    // Same as above for all priorities, highest priority first
+    void takeAll(EventList &events);
+
+    void removeAllEventsTargeting(EventReceiver &eventReceiver);
+
+    // When enabled, an event pushed while an event of the same type for the same target
+    // is still waiting in the same lane is offered to the waiting one through
+    // Event::mergeWith(). If merged, the pushed event is dropped and the waiting one
+    // keeps its place in the queue. Disabled by default.
+    void setCoalescingEnabled(bool enabled);
+    bool isCoalescingEnabled() const;
+
+    using size_type = EventList::size_type;
+    size_type size() const { return m_size.load(std::memory_order_acquire); }
+    size_type size(Priority priority) const { return m_lanes[static_cast<size_t>(priority)].size.load(std::memory_order_acquire); }
+    bool isEmpty() const { return size() == 0; }
 
-    void removeAllEventsTargeting(EventReceiver &eventReceiver)
+private:
+    struct InboxNode;
+
+    struct CoalescingKey {
+        const EventReceiver *target;
+        Event::Type type;
+
+        bool operator==(const CoalescingKey &other) const { return target == other.target && type == other.type; }
+    };
+    struct CoalescingKeyHash {
+        size_t operator()(const CoalescingKey &key) const;
+    };
+
+    // Open addressing hash table from target to a counter or index, used for the
+    // per-target bookkeeping of a lane. Entries are never erased individually. clear()
+    // is O(1) and the table keeps its capacity, so that the steady state doesn't allocate.
+    class TargetTable
     {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        auto postedEventTargetsEventReceiver = [&eventReceiver](std::unique_ptr<PostedEvent> &postedEvent) {
-            return (postedEvent->target() == &eventReceiver);
+    public:
+        bool isEmpty() const { return m_liveCount == 0; }
+        // Returns nullptr if target has no entry
+        size_type *find(const EventReceiver *target);
+        // Inserts a zero entry if target has none yet
+        size_type &operator[](const EventReceiver *target);
+        void clear();
+
+    private:
+        struct Slot {
+            const EventReceiver *target = nullptr;
+            size_type value = 0;
+            uint32_t generation = 0;
         };
-        const auto it = std::remove_if(m_events.begin(), m_events.end(), postedEventTargetsEventReceiver);
-        m_events.erase(it, m_events.end());
-    }
-
-    using size_type = std::deque<std::unique_ptr<PostedEvent>>::size_type;
-    size_type size() const
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        return m_events.size();
-    }
-
-    bool isEmpty() const
-    {
-        std::lock_guard<std::mutex> lock(m_mutex);
-        return m_events.empty();
-    }
-
-private:
+        static size_t slotIndexFor(const EventReceiver *target, size_t slotCount);
+        void grow();
+
+        // Slots from an older generation are empty
+        std::vector<Slot> m_slots;
+        uint32_t m_generation = 1;
+        size_type m_liveCount = 0;
+    };
+
+    // Pending events of a lane are events[head..]. Popping single events only advances
+    // head, the consumed slots are released once the lane has been drained.
+    //
+    // Removing the events of a receiver doesn't touch the events themselves. Instead
+    // the receiver is mapped to the end of the lane at that time, and entries before
+    // that index targeting it are dead and skipped when draining.
+    struct Lane {
+        EventList events;
+        size_type head = 0;
+        // Dead entries at or after head
+        size_type deadCount = 0;
+        std::atomic<size_type> size{ 0 };
+        // Number of live pending events per target
+        TargetTable pendingCounts;
+        // Index before which events targeting a removed receiver are dead
+        TargetTable cancelledBefore;
+        // Index of the latest pending event per target and type, only maintained while
+        // coalescing is enabled
+        std::unordered_map<CoalescingKey, size_type, CoalescingKeyHash> latestEvents;
+
+        size_type liveCount() const { return events.size() - head - deadCount; }
+        bool isDead(size_type index);
+        // Advances head past dead entries
+        void skipDead();
+        void reset()
+        {
+            events.clear();
+            head = 0;
+            deadCount = 0;
+            pendingCounts.clear();
+            cancelledBefore.clear();
+            latestEvents.clear();
+        }
+    };
+
+    void pushToInbox(PostedEvent &&event, Priority priority);
+    void pushToInbox(InboxNode *first, InboxNode *last, size_type count, Priority priority);
+    // Moves everything producers have handed over so far to the back of the lanes.
+    // Must be called with m_mutex held.
+    void collectInbox() const;
+    // Appends event to lane unless it could be merged into a pending one. Returns
+    // whether the event was appended. Must be called with m_mutex held.
+    bool appendToLane(Lane &lane, PostedEvent &&event) const;
+    // Must be called with m_mutex held
+    void takeAllLocked(Lane &lane, EventList &events);
+    void addToSize(Priority priority, size_type count);
+    void subtractFromSize(Lane &lane, size_type count) const;
+
+    const Backend m_backend;
     mutable std::mutex m_mutex;
-    std::deque<std::unique_ptr<PostedEvent>> m_events;
+    mutable std::array<Lane, PriorityCount> m_lanes;
+    bool m_coalescingEnabled = false;
+    mutable std::atomic<size_type> m_size{ 0 };
+
+    // Vyukov-style MPSC list used by Backend::LockFree. Producers only ever touch
+    // m_inboxHead while the consumer, with m_mutex held, only ever touches m_inboxTail.
+    // Both live on their own cache line so that producers and consumer don't bounce it.
+    alignas(64) std::atomic<InboxNode *> m_inboxHead{ nullptr };
+    alignas(64) mutable InboxNode *m_inboxTail{ nullptr };
 };
 
 } // namespace KDFoundation
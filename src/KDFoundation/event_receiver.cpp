@@ -14,13 +14,30 @@
 
 using namespace KDFoundation;
 
+EventReceiver::EventReceiver() noexcept
+    : m_eventLoop{ EventLoop::instance() }
+    , m_eventLoopId{ m_eventLoop != nullptr ? m_eventLoop->id() : 0 }
+{
+}
+
+void EventReceiver::setEventLoop(EventLoop *eventLoop)
+{
+    m_eventLoop = eventLoop;
+    m_eventLoopId = eventLoop != nullptr ? eventLoop->id() : 0;
+}
+
 EventReceiver::~EventReceiver() noexcept
 {
     // Clear this thread's and the main event loop from events targeting this receiver
-    // FIXME Events posted to other threads' event loops are not cleared
-    if (EventLoop::instance() != nullptr)
-        EventLoop::instance()->removeAllEventsTargeting(*this);
+    EventLoop *currentEventLoop = EventLoop::instance();
+    if (currentEventLoop != nullptr)
+        currentEventLoop->removeAllEventsTargeting(*this);
+
+    EventLoop *mainEventLoop = CoreApplication::instance() != nullptr ? CoreApplication::instance()->eventLoop() : nullptr;
+    if (mainEventLoop != nullptr && mainEventLoop != currentEventLoop)
+        mainEventLoop->removeAllEventsTargeting(*this);
 
-    if (CoreApplication::instance() != nullptr && CoreApplication::instance()->eventLoop() != EventLoop::instance())
-        CoreApplication::instance()->removeAllEventsTargeting(*this);
+    // And the loop of the thread the receiver lives on, unless it is gone already
+    if (m_eventLoop != nullptr && m_eventLoop != currentEventLoop && m_eventLoop != mainEventLoop)
+        EventLoop::removeAllEventsTargetingIfAlive(m_eventLoopId, *this);
 }
@@ -13,16 +13,35 @@
 
 #include <KDFoundation/kdfoundation_global.h>
 
+#include <cstdint>
+
 namespace KDFoundation {
 
 class Event;
+class EventLoop;
 
 class KDFOUNDATION_API EventReceiver
 {
 public:
+    EventReceiver() noexcept;
     virtual ~EventReceiver() noexcept;
 
     virtual void event(EventReceiver *target, Event *ev) { };
+
+    // The event loop this receiver lives on. That is the loop of the thread it was
+    // created on, unless it has been moved since. Events posted through
+    // CoreApplication::postEvent() are delivered by this loop.
+    EventLoop *eventLoop() const { return m_eventLoop; }
+    // The id of that loop, or 0 if there is none. Unlike eventLoop() it can tell whether
+    // the loop still exists, see EventLoop::postEventIfAlive().
+    uint64_t eventLoopId() const { return m_eventLoopId; }
+
+protected:
+    void setEventLoop(EventLoop *eventLoop);
+
+private:
+    EventLoop *m_eventLoop;
+    uint64_t m_eventLoopId;
 };
 
 } // namespace KDFoundation
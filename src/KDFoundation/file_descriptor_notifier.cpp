@@ -19,9 +19,10 @@
 
 using namespace KDFoundation;
 
-FileDescriptorNotifier::FileDescriptorNotifier(int fd, NotificationType type)
+FileDescriptorNotifier::FileDescriptorNotifier(int fd, NotificationType type, TriggerMode triggerMode)
     : m_fd{ fd }
     , m_type{ type }
+    , m_triggerMode{ triggerMode }
 {
     assert(m_fd >= 0);
 
@@ -50,9 +51,26 @@ FileDescriptorNotifier::~FileDescriptorNotifier()
         platformEventLoop->unregisterNotifier(this);
 }
 
+void FileDescriptorNotifier::setEnabled(bool enabled)
+{
+    if (m_enabled == enabled)
+        return;
+    m_enabled = enabled;
+
+    auto eventLoop = EventLoop::instance();
+    if (!eventLoop)
+        return;
+    auto platformEventLoop = eventLoop->platformEventLoop();
+    if (platformEventLoop)
+        platformEventLoop->updateNotifier(this);
+}
+
 void FileDescriptorNotifier::event(EventReceiver *target, Event *ev)
 {
     if (ev->type() == Event::Type::Notifier) {
+        // Before emitting, so that handlers can rearm right away
+        if (m_triggerMode == TriggerMode::OneShot)
+            setEnabled(false);
         triggered.emit(m_fd);
         ev->setAccepted(true);
     }
@@ -27,6 +27,10 @@ namespace KDFoundation {
 /// after every successful write. This means that socket should be written to
 /// until WSAEWOULDBLOCK is returned from the send-type operation running on the
 /// socket to receive next write notification.
+///
+/// Disabling a notifier keeps it registered but stops notifications until it is enabled
+/// again. On Linux this is a single epoll_ctl() call, which makes it a cheap way to drop
+/// interest in e.g. writability while there is nothing to write.
 class KDFOUNDATION_API FileDescriptorNotifier : public Object
 {
 public:
@@ -36,7 +40,19 @@ public:
         Exception = 2
     };
 
-    explicit FileDescriptorNotifier(int fd, NotificationType type);
+    enum class TriggerMode : uint8_t {
+        // Notifies as long as the file descriptor is ready
+        Level = 0,
+        // Notifies when the file descriptor becomes ready. The handler has to consume
+        // everything available, e.g. read until EAGAIN, to get notified again.
+        // Platforms without support, and notifiers sharing their file descriptor with
+        // level-triggered ones, fall back to Level.
+        Edge = 1,
+        // Notifies once, then disables the notifier until rearm() is called
+        OneShot = 2
+    };
+
+    explicit FileDescriptorNotifier(int fd, NotificationType type, TriggerMode triggerMode = TriggerMode::Level);
     ~FileDescriptorNotifier();
 
     KDBindings::Signal<int> triggered;
@@ -46,6 +62,12 @@ public:
         return m_fd;
     }
     NotificationType type() const { return m_type; }
+    TriggerMode triggerMode() const { return m_triggerMode; }
+
+    bool isEnabled() const { return m_enabled; }
+    void setEnabled(bool enabled);
+    // Enables a one-shot notifier again after it fired. Same as setEnabled(true).
+    void rearm() { setEnabled(true); }
 
 protected:
     void event(EventReceiver *target, Event *ev) override;
@@ -53,6 +75,8 @@ protected:
 private:
     int m_fd;
     NotificationType m_type;
+    TriggerMode m_triggerMode;
+    bool m_enabled = true;
 };
 
 } // namespace KDFoundation
@@ -0,0 +1,537 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDFoundation/event_loop.h>
+#include <KDFoundation/timer.h>
+
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace KDFoundation {
+
+template<typename T>
+class Future;
+
+template<typename T>
+class Promise;
+
+namespace Detail {
+
+// Stands in for the value of futures of void
+struct Unit {
+};
+
+template<typename T>
+using FutureValue = std::conditional_t<std::is_void_v<T>, Unit, T>;
+
+template<typename T>
+struct UnwrapFuture {
+    using Type = T;
+    static constexpr bool isFuture = false;
+};
+
+template<typename T>
+struct UnwrapFuture<Future<T>> {
+    using Type = T;
+    static constexpr bool isFuture = true;
+};
+
+// Shared by a future and its promises. The value is stored in place, so a promise costs
+// a single allocation. Attaching a continuation costs one more, for its captures.
+// Dispatching it to an event loop leaves the continuation in the state and only posts
+// a callback holding on to the state.
+template<typename T>
+class FutureState : public std::enable_shared_from_this<FutureState<T>>
+{
+public:
+    using Value = FutureValue<T>;
+
+    enum class Status {
+        Pending,
+        Ready,
+        Canceled
+    };
+
+    Status status() const { return m_status.load(std::memory_order_acquire); }
+
+    // Only valid once ready. The value does not change anymore at that point.
+    Value &value()
+    {
+        assert(status() == Status::Ready);
+        return *m_value;
+    }
+
+    void setValue(Value &&value)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (status() != Status::Pending)
+            return;
+        m_value.emplace(std::move(value));
+        m_status.store(Status::Ready, std::memory_order_release);
+        dispatch(lock);
+    }
+
+    void cancel()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (status() != Status::Pending)
+            return;
+        m_status.store(Status::Canceled, std::memory_order_release);
+        dispatch(lock);
+    }
+
+    // Calls continuation with this state once settled, from a callback posted to
+    // eventLoop. A null eventLoop calls it right away on the thread settling the state,
+    // which is only meant for forwarding to another state.
+    template<typename Continuation>
+    void setContinuation(EventLoop *eventLoop, Continuation &&continuation)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        assert(!m_continuation && "A future can only have a single continuation.");
+        m_continuation = std::make_unique<ContinuationImpl<std::decay_t<Continuation>>>(std::forward<Continuation>(continuation));
+        m_continuationEventLoopId = eventLoop != nullptr ? eventLoop->id() : 0;
+        if (status() != Status::Pending)
+            dispatch(lock);
+    }
+
+    // The state is canceled once the last promise is gone without having set a value
+    void addPromise() { m_promiseCount.fetch_add(1, std::memory_order_relaxed); }
+    void releasePromise()
+    {
+        if (m_promiseCount.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            cancel();
+    }
+
+private:
+    class Continuation
+    {
+    public:
+        virtual ~Continuation() = default;
+        virtual void run(FutureState &state) = 0;
+    };
+
+    template<typename F>
+    class ContinuationImpl : public Continuation
+    {
+    public:
+        explicit ContinuationImpl(F &&f)
+            : m_f{ std::move(f) }
+        {
+        }
+        explicit ContinuationImpl(const F &f)
+            : m_f{ f }
+        {
+        }
+
+        void run(FutureState &state) override { m_f(state); }
+
+    private:
+        F m_f;
+    };
+
+    void dispatch(std::unique_lock<std::mutex> &lock)
+    {
+        if (!m_continuation)
+            return;
+        const EventLoop::Id eventLoopId = m_continuationEventLoopId;
+        if (eventLoopId == 0) {
+            auto continuation = std::move(m_continuation);
+            lock.unlock();
+            continuation->run(*this);
+            return;
+        }
+        lock.unlock();
+
+        // A continuation that cannot run anymore is dropped, which cancels the future
+        // returned by then(). If the loop goes away with the callback still queued, that
+        // happens once the state is gone.
+        const bool posted = EventLoop::postCallbackIfAlive(eventLoopId, [self = this->shared_from_this()] {
+            self->runContinuation();
+        });
+        if (!posted)
+            takeContinuation();
+    }
+
+    std::unique_ptr<Continuation> takeContinuation()
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        return std::move(m_continuation);
+    }
+
+    void runContinuation()
+    {
+        if (auto continuation = takeContinuation())
+            continuation->run(*this);
+    }
+
+    std::mutex m_mutex;
+    std::atomic<Status> m_status{ Status::Pending };
+    std::atomic<size_t> m_promiseCount{ 0 };
+    std::optional<Value> m_value;
+    std::unique_ptr<Continuation> m_continuation;
+    EventLoop::Id m_continuationEventLoopId = 0;
+};
+
+template<typename T, typename F>
+decltype(auto) invokeWithValue(F &f, FutureState<T> &state)
+{
+    if constexpr (std::is_void_v<T>)
+        return f();
+    else
+        return f(std::move(state.value()));
+}
+
+template<typename T, typename F>
+using ContinuationResult = decltype(invokeWithValue<T>(std::declval<F &>(), std::declval<FutureState<T> &>()));
+
+struct FutureAccess {
+    template<typename T>
+    static std::shared_ptr<FutureState<T>> takeState(Future<T> &&future) { return std::exchange(future.m_state, {}); }
+};
+
+} // namespace Detail
+
+// The producing end of a Future. Copies of a promise refer to the same future, the
+// first value set wins. Once all copies are gone without a value having been set, the
+// future is canceled. Promises may be fulfilled from any thread.
+template<typename T>
+class Promise
+{
+public:
+    using Value = Detail::FutureValue<T>;
+
+    Promise()
+        : m_state{ std::make_shared<Detail::FutureState<T>>() }
+    {
+        m_state->addPromise();
+    }
+    ~Promise()
+    {
+        if (m_state)
+            m_state->releasePromise();
+    }
+
+    Promise(const Promise &other)
+        : m_state{ other.m_state }
+    {
+        if (m_state)
+            m_state->addPromise();
+    }
+    Promise &operator=(const Promise &other)
+    {
+        Promise copy(other);
+        std::swap(m_state, copy.m_state);
+        return *this;
+    }
+
+    Promise(Promise &&other) noexcept = default;
+    Promise &operator=(Promise &&other) noexcept
+    {
+        Promise moved(std::move(other));
+        std::swap(m_state, moved.m_state);
+        return *this;
+    }
+
+    // May be called once, as a future can only be consumed once
+    Future<T> future() const { return Future<T>{ m_state }; }
+
+    // Constructs the value from args. Futures of void take no arguments.
+    template<typename... Args>
+    void setValue(Args &&...args)
+    {
+        assert(m_state);
+        m_state->setValue(Value(std::forward<Args>(args)...));
+    }
+
+    void cancel()
+    {
+        assert(m_state);
+        m_state->cancel();
+    }
+
+private:
+    std::shared_ptr<Detail::FutureState<T>> m_state;
+};
+
+// A value of type T becoming available later, or never if the future gets canceled.
+// Continuations attached through then() are called on an event loop, never right away,
+// so they may rely on the code attaching them having finished. Calling then() consumes
+// the future and returns a new one for the result of the continuation, which makes
+// request/response flows read as a chain:
+//
+//   client.subscribe(topic)                         // Future<SubscribeResult>
+//       .then([](SubscribeResult &&result) { ... }) // runs once SUBACK has arrived
+//
+// Cancellation propagates along the chain without calling the continuations.
+template<typename T>
+class [[nodiscard]] Future
+{
+public:
+    using Value = Detail::FutureValue<T>;
+
+    Future() = default;
+
+    // Not copyable
+    Future(const Future &other) = delete;
+    Future &operator=(const Future &other) = delete;
+
+    Future(Future &&other) noexcept = default;
+    Future &operator=(Future &&other) noexcept = default;
+
+    bool isValid() const { return bool(m_state); }
+    bool isReady() const { return m_state && m_state->status() == State::Status::Ready; }
+    bool isCanceled() const { return m_state && m_state->status() == State::Status::Canceled; }
+    bool isFinished() const { return m_state && m_state->status() != State::Status::Pending; }
+
+    // The value, which must be ready
+    template<typename U = T, typename = std::enable_if_t<!std::is_void_v<U>>>
+    const U &result() const
+    {
+        assert(isReady());
+        return m_state->value();
+    }
+
+    // Calls f with the value on eventLoop once ready. Returns a future for the result of
+    // f. If f returns a future itself, that future is waited for.
+    template<typename F>
+    auto then(EventLoop *eventLoop, F &&f) &&
+    {
+        assert(m_state);
+        assert(eventLoop && "Continuations need an event loop to run on.");
+
+        using Result = Detail::ContinuationResult<T, std::decay_t<F>>;
+        using Unwrapped = Detail::UnwrapFuture<Result>;
+        using NextValue = typename Unwrapped::Type;
+
+        Promise<NextValue> promise;
+        Future<NextValue> next = promise.future();
+        auto current = std::exchange(m_state, {});
+        current->setContinuation(eventLoop, [f = std::forward<F>(f), promise = std::move(promise)](State &state) mutable {
+            if (state.status() != State::Status::Ready)
+                return;
+            if constexpr (Unwrapped::isFuture) {
+                forwardTo(Detail::invokeWithValue<T>(f, state), std::move(promise));
+            } else if constexpr (std::is_void_v<Result>) {
+                Detail::invokeWithValue<T>(f, state);
+                promise.setValue();
+            } else {
+                promise.setValue(Detail::invokeWithValue<T>(f, state));
+            }
+        });
+        return next;
+    }
+
+    // Same, on the event loop of the calling thread
+    template<typename F>
+    auto then(F &&f) &&
+    {
+        return std::move(*this).then(EventLoop::instance(), std::forward<F>(f));
+    }
+
+private:
+    using State = Detail::FutureState<T>;
+
+    template<typename U>
+    friend class Future;
+    friend class Promise<T>;
+    friend struct Detail::FutureAccess;
+
+    explicit Future(std::shared_ptr<State> state)
+        : m_state{ std::move(state) }
+    {
+    }
+
+    // Settles promise like future, right on the thread settling future
+    template<typename U>
+    static void forwardTo(Future<U> &&future, Promise<U> &&promise)
+    {
+        if (!future.m_state)
+            return; // Dropping promise cancels it
+        auto current = std::exchange(future.m_state, {});
+        current->setContinuation(nullptr, [promise = std::move(promise)](Detail::FutureState<U> &state) mutable {
+            if (state.status() == Detail::FutureState<U>::Status::Ready)
+                promise.setValue(std::move(state.value()));
+        });
+    }
+
+    std::shared_ptr<State> m_state;
+};
+
+template<typename T>
+Future<std::decay_t<T>> makeReadyFuture(T &&value)
+{
+    Promise<std::decay_t<T>> promise;
+    promise.setValue(std::forward<T>(value));
+    return promise.future();
+}
+
+inline Future<void> makeReadyFuture()
+{
+    Promise<void> promise;
+    promise.setValue();
+    return promise.future();
+}
+
+template<typename T>
+using WhenAllResult = std::conditional_t<std::is_void_v<T>, void, std::vector<Detail::FutureValue<T>>>;
+
+// Ready once all futures are, with their values in the same order. Canceled as soon as
+// one of them is.
+template<typename T>
+Future<WhenAllResult<T>> whenAll(std::vector<Future<T>> futures)
+{
+    using Result = WhenAllResult<T>;
+
+    struct Shared {
+        std::mutex mutex;
+        std::vector<std::optional<Detail::FutureValue<T>>> values;
+        size_t remaining;
+        Promise<Result> promise;
+    };
+
+    auto shared = std::make_shared<Shared>();
+    shared->values.resize(futures.size());
+    shared->remaining = futures.size();
+    Future<Result> result = shared->promise.future();
+    if (futures.empty()) {
+        shared->promise.setValue();
+        return result;
+    }
+
+    for (size_t i = 0; i < futures.size(); ++i) {
+        auto current = Detail::FutureAccess::takeState(std::move(futures[i]));
+        if (!current) {
+            shared->promise.cancel();
+            continue;
+        }
+        current->setContinuation(nullptr, [shared, i](Detail::FutureState<T> &state) {
+            if (state.status() != Detail::FutureState<T>::Status::Ready) {
+                shared->promise.cancel();
+                return;
+            }
+            std::unique_lock<std::mutex> lock(shared->mutex);
+            shared->values[i].emplace(std::move(state.value()));
+            if (--shared->remaining != 0)
+                return;
+            lock.unlock();
+
+            if constexpr (std::is_void_v<T>) {
+                shared->promise.setValue();
+            } else {
+                std::vector<T> values;
+                values.reserve(shared->values.size());
+                for (auto &value : shared->values)
+                    values.push_back(std::move(*value));
+                shared->promise.setValue(std::move(values));
+            }
+        });
+    }
+    return result;
+}
+
+template<typename T>
+using WhenAnyResult = std::conditional_t<std::is_void_v<T>, size_t, std::pair<size_t, Detail::FutureValue<T>>>;
+
+// Ready once the first of futures is, with its index and, unless void, its value.
+// Canceled if all of them are.
+template<typename T>
+Future<WhenAnyResult<T>> whenAny(std::vector<Future<T>> futures)
+{
+    using Result = WhenAnyResult<T>;
+
+    struct Shared {
+        std::atomic<size_t> remaining;
+        Promise<Result> promise;
+    };
+
+    auto shared = std::make_shared<Shared>();
+    shared->remaining = futures.size();
+    Future<Result> result = shared->promise.future();
+
+    for (size_t i = 0; i < futures.size(); ++i) {
+        auto current = Detail::FutureAccess::takeState(std::move(futures[i]));
+        auto onSettled = [shared, i](Detail::FutureState<T> *state) {
+            if (state && state->status() == Detail::FutureState<T>::Status::Ready) {
+                if constexpr (std::is_void_v<T>)
+                    shared->promise.setValue(i);
+                else
+                    shared->promise.setValue(i, std::move(state->value()));
+            }
+            if (shared->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                shared->promise.cancel(); // Does nothing if one of them was ready
+        };
+        if (current)
+            current->setContinuation(nullptr, [onSettled](Detail::FutureState<T> &state) { onSettled(&state); });
+        else
+            onSettled(nullptr);
+    }
+    // Drops the last promise if futures is empty
+    shared.reset();
+    return result;
+}
+
+// Ready after delay has elapsed, using a single shot timer of the event loop of the
+// calling thread
+template<typename Rep, typename Period>
+Future<void> delay(std::chrono::duration<Rep, Period> delay, TimerType type = TimerType::Precise)
+{
+    Promise<void> promise;
+    Future<void> future = promise.future();
+    Timer::singleShot(std::chrono::duration_cast<std::chrono::microseconds>(delay), [promise]() mutable { promise.setValue(); }, type);
+    return future;
+}
+
+template<typename T>
+using TimeoutResult = std::conditional_t<std::is_void_v<T>, bool, std::optional<Detail::FutureValue<T>>>;
+
+// Waits for future for at most timeout, as measured by the event loop of the calling
+// thread. The result holds the value of future, or nothing if time ran out first. For
+// futures of void it tells whether future got ready in time.
+template<typename T, typename Rep, typename Period>
+Future<TimeoutResult<T>> withTimeout(Future<T> future, std::chrono::duration<Rep, Period> timeout, TimerType type = TimerType::Precise)
+{
+    using Result = TimeoutResult<T>;
+
+    Promise<Result> promise;
+    Future<Result> result = promise.future();
+    auto current = Detail::FutureAccess::takeState(std::move(future));
+    if (!current)
+        return result;
+
+    Timer::singleShot(
+            std::chrono::duration_cast<std::chrono::microseconds>(timeout), [promise]() mutable {
+                if constexpr (std::is_void_v<T>)
+                    promise.setValue(false);
+                else
+                    promise.setValue(std::nullopt);
+            },
+            type);
+    current->setContinuation(nullptr, [promise](Detail::FutureState<T> &state) mutable {
+        if (state.status() != Detail::FutureState<T>::Status::Ready)
+            promise.cancel();
+        else if constexpr (std::is_void_v<T>)
+            promise.setValue(true);
+        else
+            promise.setValue(std::move(state.value()));
+    });
+    return result;
+}
+
+} // namespace KDFoundation
@@ -0,0 +1,112 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/latency_histogram.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+using namespace KDFoundation;
+
+namespace {
+constexpr uint64_t HalfSubBucketCount = LatencyHistogram::SubBucketCount / 2;
+
+int mostSignificantBit(uint64_t value)
+{
+    assert(value != 0);
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#else
+    int bit = 0;
+    while (value >>= 1)
+        ++bit;
+    return bit;
+#endif
+}
+} // namespace
+
+size_t LatencyHistogram::bucketIndex(uint64_t value)
+{
+    value = std::min(value, MaxValue);
+    if (value < SubBucketCount)
+        return size_t(value);
+    const int shift = mostSignificantBit(value) - (SubBucketBits - 1);
+    const uint64_t subBucket = value >> shift;
+    return size_t(SubBucketCount + (shift - 1) * HalfSubBucketCount + (subBucket - HalfSubBucketCount));
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t bucket)
+{
+    assert(bucket < BucketCount);
+    if (bucket < SubBucketCount)
+        return bucket;
+    const uint64_t index = bucket - SubBucketCount;
+    const uint64_t shift = index / HalfSubBucketCount + 1;
+    return (HalfSubBucketCount + index % HalfSubBucketCount) << shift;
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t bucket)
+{
+    if (bucket < SubBucketCount)
+        return bucket;
+    const uint64_t shift = (bucket - SubBucketCount) / HalfSubBucketCount + 1;
+    return bucketLowerBound(bucket) + (uint64_t(1) << shift) - 1;
+}
+
+void LatencyHistogram::record(uint64_t value)
+{
+    increment(m_buckets[bucketIndex(value)]);
+    increment(m_count);
+    increment(m_sum, value);
+    if (value < m_min.load(std::memory_order_relaxed))
+        m_min.store(value, std::memory_order_relaxed);
+    if (value > m_max.load(std::memory_order_relaxed))
+        m_max.store(value, std::memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::min() const
+{
+    return count() == 0 ? 0 : m_min.load(std::memory_order_relaxed);
+}
+
+double LatencyHistogram::mean() const
+{
+    const uint64_t valueCount = count();
+    return valueCount == 0 ? 0.0 : double(m_sum.load(std::memory_order_relaxed)) / double(valueCount);
+}
+
+uint64_t LatencyHistogram::valueAtPercentile(double percentile) const
+{
+    const uint64_t valueCount = count();
+    if (valueCount == 0)
+        return 0;
+    percentile = std::clamp(percentile, 0.0, 100.0);
+    const auto rank = std::max<uint64_t>(1, uint64_t(std::ceil(percentile / 100.0 * double(valueCount))));
+
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < BucketCount; ++bucket) {
+        seen += countInBucket(bucket);
+        if (seen >= rank)
+            return std::clamp(bucketUpperBound(bucket), min(), max());
+    }
+    // Only reached while values are being recorded
+    return max();
+}
+
+void LatencyHistogram::reset()
+{
+    for (auto &bucket : m_buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(UINT64_MAX, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
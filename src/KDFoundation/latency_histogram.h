@@ -0,0 +1,101 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDFoundation/kdfoundation_global.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace KDFoundation {
+
+// Histogram of non-negative values, typically durations in nanoseconds, with a fixed
+// relative precision in the manner of HdrHistogram: values below SubBucketCount are
+// counted exactly, every power of two range above that is split into SubBucketCount / 2
+// buckets of equal width. Values too large are counted in the last bucket.
+//
+// Values are recorded by a single thread without locking. Any thread may read the
+// histogram meanwhile, it merely sees the values recorded up to some point.
+class KDFOUNDATION_API LatencyHistogram
+{
+public:
+    static constexpr int SubBucketBits = 5;
+    static constexpr uint64_t SubBucketCount = uint64_t(1) << SubBucketBits;
+    // Largest value told apart from larger ones, about 18 minutes in nanoseconds
+    static constexpr int MaxValueBits = 40;
+    static constexpr uint64_t MaxValue = (uint64_t(1) << MaxValueBits) - 1;
+    static constexpr size_t BucketCount = (MaxValueBits - SubBucketBits + 2) * (SubBucketCount / 2);
+
+    LatencyHistogram() = default;
+
+    // Not copyable
+    LatencyHistogram(const LatencyHistogram &other) = delete;
+    LatencyHistogram &operator=(const LatencyHistogram &other) = delete;
+
+    void record(uint64_t value);
+    void record(std::chrono::nanoseconds duration) { record(duration.count() > 0 ? uint64_t(duration.count()) : 0); }
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    // Smallest and largest value recorded, 0 if none
+    uint64_t min() const;
+    uint64_t max() const { return m_max.load(std::memory_order_relaxed); }
+    double mean() const;
+    // The value below or at which percentile percent of the recorded values are,
+    // precise to the width of its bucket. 0 if no value has been recorded.
+    uint64_t valueAtPercentile(double percentile) const;
+
+    uint64_t countInBucket(size_t bucket) const { return m_buckets[bucket].load(std::memory_order_relaxed); }
+
+    // Like record(), should be called by the recording thread
+    void reset();
+
+    static size_t bucketIndex(uint64_t value);
+    // Range of values counted in bucket
+    static uint64_t bucketLowerBound(size_t bucket);
+    static uint64_t bucketUpperBound(size_t bucket);
+
+private:
+    // Single writer, so plain loads and stores suffice to update the counters
+    static void increment(std::atomic<uint64_t> &counter, uint64_t by = 1)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+    }
+
+    std::array<std::atomic<uint64_t>, BucketCount> m_buckets{};
+    std::atomic<uint64_t> m_count{ 0 };
+    std::atomic<uint64_t> m_sum{ 0 };
+    std::atomic<uint64_t> m_min{ UINT64_MAX };
+    std::atomic<uint64_t> m_max{ 0 };
+};
+
+// Records the time from its construction to its destruction into a histogram
+class ScopedLatencyMeasurement
+{
+public:
+    explicit ScopedLatencyMeasurement(LatencyHistogram &histogram)
+        : m_histogram{ histogram }
+        , m_startTime{ std::chrono::steady_clock::now() }
+    {
+    }
+    ~ScopedLatencyMeasurement() { m_histogram.record(std::chrono::steady_clock::now() - m_startTime); }
+
+    ScopedLatencyMeasurement(const ScopedLatencyMeasurement &other) = delete;
+    ScopedLatencyMeasurement &operator=(const ScopedLatencyMeasurement &other) = delete;
+
+private:
+    LatencyHistogram &m_histogram;
+    std::chrono::steady_clock::time_point m_startTime;
+};
+
+} // namespace KDFoundation
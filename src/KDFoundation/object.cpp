@@ -12,21 +12,91 @@
 #include "object.h"
 #include "core_application.h"
 #include "event.h"
+#include "object_arena.h"
 
 #include <cassert>
 #include <algorithm>
+#include <new>
+#include <utility>
+#include <vector>
 
 using namespace KDFoundation;
 
+namespace {
+
+// Set while an Object is being allocated from an arena, until its Object constructor
+// has run
+thread_local ObjectArena *s_allocationArena = nullptr;
+
+// The arena allocated Objects being destroyed on this thread, innermost last. Their
+// operator delete runs once m_arena can't be read anymore.
+struct ArenaDeallocation {
+    const Object *object;
+    ObjectArena *arena;
+};
+thread_local std::vector<ArenaDeallocation> s_arenaDeallocations;
+
+} // namespace
+
 Object::Object()
     : EventReceiver()
     , m_parent{ nullptr }
+    , m_arena{ std::exchange(s_allocationArena, nullptr) }
+{
+}
+
+void Object::setAllocationArena(ObjectArena *arena)
 {
+    s_allocationArena = arena;
+}
+
+void *Object::operator new(std::size_t size)
+{
+    if (ObjectArena *arena = s_allocationArena)
+        return arena->allocate(size);
+    return ::operator new(size);
+}
+
+void *Object::operator new(std::size_t size, std::align_val_t alignment)
+{
+    return ::operator new(size, alignment);
+}
+
+void Object::operator delete(void *ptr, std::size_t size) noexcept
+{
+    if (ptr == nullptr)
+        return;
+
+    // The Object may be a base at some offset into the allocation
+    auto memory = static_cast<const std::byte *>(ptr);
+    if (!s_arenaDeallocations.empty()) {
+        const ArenaDeallocation &deallocation = s_arenaDeallocations.back();
+        auto object = reinterpret_cast<const std::byte *>(deallocation.object);
+        if (object >= memory && object < memory + size) {
+            ObjectArena *arena = deallocation.arena;
+            s_arenaDeallocations.pop_back();
+            arena->deallocate(ptr, size);
+            return;
+        }
+    }
+
+    // A constructor threw before the Object constructor ran
+    if (s_allocationArena != nullptr) {
+        s_allocationArena->deallocate(ptr, size);
+        return;
+    }
+    ::operator delete(ptr, size);
+}
+
+void Object::operator delete(void *ptr, std::size_t size, std::align_val_t alignment) noexcept
+{
+    ::operator delete(ptr, size, alignment);
 }
 
 void Object::deleteLater()
 {
-    if (EventLoop::instance() == nullptr) {
+    EventLoop *loop = eventLoop() != nullptr ? eventLoop() : EventLoop::instance();
+    if (loop == nullptr) {
         SPDLOG_ERROR("No EventLoop to schedule deferred deletion of object with.");
         return;
     }
@@ -36,12 +106,86 @@ void Object::deleteLater()
         return;
     }
 
-    auto ev = std::make_unique<DeferredDeleteEvent>();
-    EventLoop::instance()->postEvent(this, std::move(ev));
+    if (loop == EventLoop::instance()) {
+        loop->scheduleDeferredDeletion(this);
+    } else if (!EventLoop::postEventIfAlive(eventLoopId(), this, std::make_unique<DeferredDeleteEvent>())) {
+        SPDLOG_ERROR("The EventLoop object {} lives on is gone, cannot schedule its deferred deletion.", objectName());
+    }
+}
+
+void Object::moveToEventLoop(EventLoop *eventLoop)
+{
+    assert((this->eventLoop() == nullptr || this->eventLoop() == EventLoop::instance()) && "Objects can only be moved from the thread they live on.");
+    setEventLoopRecursively(eventLoop);
+}
+
+void Object::setObjectName(const std::string &objectName)
+{
+    if (objectName == m_objectName)
+        return;
+
+    // Keep the name index of the parent, if it has one, up to date
+    Object *indexingParent = m_parent != nullptr && m_parent->m_nameIndex ? m_parent : nullptr;
+    if (indexingParent != nullptr)
+        indexingParent->removeFromNameIndex(this);
+    m_objectName = objectName;
+    if (indexingParent != nullptr)
+        indexingParent->addToNameIndex(this);
+}
+
+const Object::NameIndex &Object::nameIndex()
+{
+    if (!m_nameIndex) {
+        m_nameIndex = std::make_unique<NameIndex>();
+        m_nameIndex->reserve(m_children.size());
+        for (const auto &child : m_children)
+            addToNameIndex(child.get());
+    }
+    return *m_nameIndex;
+}
+
+void Object::addToNameIndex(Object *child)
+{
+    // Unnamed children are found by scanning
+    if (!child->m_objectName.empty())
+        m_nameIndex->emplace(child->m_objectName, child);
+}
+
+void Object::removeFromNameIndex(Object *child)
+{
+    const auto [begin, end] = m_nameIndex->equal_range(child->m_objectName);
+    const auto it = std::find_if(begin, end, [child](const auto &entry) {
+        return entry.second == child;
+    });
+    if (it != end)
+        m_nameIndex->erase(it);
+}
+
+void Object::setEventLoopRecursively(EventLoop *eventLoop)
+{
+    assert((m_arena.arena == nullptr || eventLoop == nullptr || eventLoop->threadId() == m_arena.arena->threadId()) && "Objects allocated from an arena can't move to another thread.");
+
+    // A pending deferred deletion goes to the new loop, the old one mustn't touch the
+    // object anymore
+    EventLoop *deferredDeletionLoop = m_deferredDeletionLoop;
+    if (deferredDeletionLoop != nullptr && deferredDeletionLoop != eventLoop)
+        deferredDeletionLoop->cancelDeferredDeletion(this);
+
+    setEventLoop(eventLoop);
+    if (deferredDeletionLoop != nullptr && deferredDeletionLoop != eventLoop)
+        deleteLater();
+    for (const auto &child : m_children)
+        child->setEventLoopRecursively(eventLoop);
 }
 
 Object::~Object()
 {
+    if (m_arena.arena != nullptr)
+        s_arenaDeallocations.push_back({ this, m_arena.arena });
+
+    if (m_deferredDeletionLoop != nullptr)
+        m_deferredDeletionLoop->cancelDeferredDeletion(this);
+
     try {
         destroyed.emit(this);
     } catch (...) {
@@ -59,6 +203,8 @@ Object::~Object()
                          objectName(),
                          child->objectName());
         }
+        if (m_nameIndex)
+            removeFromNameIndex(child);
         m_children.pop_back();
     }
 }
@@ -70,14 +216,20 @@ void Object::event(EventReceiver *target, Event *ev)
 
     switch (ev->type()) {
     case Event::Type::DeferredDelete: {
-        // delete object and immediately return from event handler
-        delete this;
-        return;
+        // Posted by deleteLater() from another thread. Join the deferred deletions of the
+        // loop the object lives on, or forward the request if it moved in the meantime.
+        deleteLater();
+        break;
     }
     case Event::Type::Timer: {
         timerEvent(static_cast<TimerEvent *>(ev));
         break;
     }
+    case Event::Type::Invoke: {
+        static_cast<InvokeEvent *>(ev)->invoke();
+        ev->setAccepted(true);
+        break;
+    }
 
     default: {
         if (ev->type() >= Event::Type::UserType)
@@ -14,8 +14,14 @@
 #include <KDFoundation/kdfoundation_global.h>
 #include <KDFoundation/event_receiver.h>
 
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <new>
 #include <string>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include <kdbindings/signal.h>
@@ -23,11 +29,18 @@
 namespace KDFoundation {
 
 class Event;
+class ObjectArena;
 class TimerEvent;
 
 class KDFOUNDATION_API Object : public EventReceiver
 {
 public:
+    // Whether findChild() and findChildren() look at the descendants of the children too
+    enum class ChildLookup : uint8_t {
+        DirectChildrenOnly,
+        Recursive
+    };
+
     Object();
     /// @warning This destructor emits #destroyed signal and #childRemoved for each child. If any of
     /// the slots connected to these signals throws (which is UB in KDBindings anyway) the exception
@@ -45,6 +58,8 @@ public:
     const Object *parent() const { return m_parent; }
     Object *parent() { return m_parent; }
 
+    // In the order the children were added, except that takeChild() moves the last child
+    // into the slot of the one it takes. Children are destroyed in reverse of this order.
     const std::vector<std::unique_ptr<Object>> &children() const { return m_children; }
 
     template<typename T>
@@ -53,52 +68,134 @@ public:
         // Caller has to transfer ownership to us so there should not be an old parent
         assert(child->parent() == nullptr);
 
+        // Children live on the event loop of their parent
         child->m_parent = this;
+        child->m_indexInParent = m_children.size();
+        if (child->eventLoop() != eventLoop())
+            child->setEventLoopRecursively(eventLoop());
         m_children.push_back(std::move(child));
         Object *childPtr = m_children.back().get();
+        if (m_nameIndex)
+            addToNameIndex(childPtr);
         childPtr->parentChanged.emit(childPtr, childPtr->m_parent);
         childAdded.emit(this, childPtr);
         return childPtr;
     }
 
+    // Children of an object allocated from an ObjectArena are allocated from the same arena
     template<typename T, typename... Ts>
     T *createChild(Ts &&...args)
     {
+        if constexpr (alignof(T) <= alignof(std::max_align_t)) {
+            if (m_arena.arena != nullptr)
+                return createChild<T>(*m_arena.arena, std::forward<Ts>(args)...);
+        }
         auto child = std::make_unique<T>(std::forward<Ts>(args)...);
         return static_cast<T *>(this->addChild(std::move(child)));
     }
 
+    // Allocates the child from arena, which has to outlive it
+    template<typename T, typename... Ts>
+    T *createChild(ObjectArena &arena, Ts &&...args)
+    {
+        static_assert(alignof(T) <= alignof(std::max_align_t), "Over-aligned Objects can't be allocated from an arena");
+        std::unique_ptr<T> child;
+        {
+            const ArenaAllocationScope scope(&arena);
+            child.reset(new T(std::forward<Ts>(args)...));
+        }
+        return static_cast<T *>(this->addChild(std::move(child)));
+    }
+
+    // The arena the object was allocated from, if any
+    ObjectArena *arena() const { return m_arena.arena; }
+
+    // Takes the child in constant time, by moving the last child into its slot. The order
+    // of the remaining children is therefore not preserved, e.g. taking b from a, b, c, d
+    // leaves a, d, c.
     template<typename T>
     std::unique_ptr<Object> takeChild(T *child)
     {
-        // Find the child from the raw pointer
-        auto childIt = std::find_if(
-                m_children.begin(),
-                m_children.end(),
-                [child](const auto &v) {
-                    return v.get() == child;
-                });
-
-        // Didn't find a matching child?
-        if (childIt == m_children.end())
+        // Not one of our children?
+        Object *childObject = child;
+        if (childObject == nullptr || childObject->m_parent != this)
             return {};
 
+        const size_t index = childObject->m_indexInParent;
+        assert(index < m_children.size() && m_children[index].get() == childObject);
+        if (m_nameIndex)
+            removeFromNameIndex(childObject);
+
         // Unparent the child and return it along with ownership!
-        auto takenChild = std::move(*childIt);
+        auto takenChild = std::move(m_children[index]);
+        if (index != m_children.size() - 1) {
+            m_children[index] = std::move(m_children.back());
+            m_children[index]->m_indexInParent = index;
+        }
+        m_children.pop_back();
         takenChild->m_parent = nullptr;
         takenChild->parentChanged.emit(takenChild.get(), takenChild->m_parent);
-        m_children.erase(childIt);
         childRemoved.emit(this, takenChild.get());
         return takenChild;
     }
 
+    // Returns a child of type T named name, or any child of type T if name is empty.
+    // Direct children are looked up first. Which child is returned when several match is
+    // unspecified. The first lookup by name indexes the names of the children, later
+    // ones are constant time for direct children.
+    template<typename T = Object>
+    T *findChild(const std::string &name = {}, ChildLookup lookup = ChildLookup::Recursive)
+    {
+        // Only this object gets indexed, the descendants use their index if they have one
+        if (!name.empty())
+            nameIndex();
+        return findInChildren<T>(name, lookup);
+    }
+
+    // Returns the children of type T named name, or all the children of type T if name is
+    // empty, in depth-first pre-order. Only direct lookups by name use the name index.
+    template<typename T = Object>
+    std::vector<T *> findChildren(const std::string &name = {}, ChildLookup lookup = ChildLookup::Recursive)
+    {
+        std::vector<T *> matches;
+        if (lookup == ChildLookup::DirectChildrenOnly && !name.empty()) {
+            const auto [begin, end] = nameIndex().equal_range(name);
+            for (auto it = begin; it != end; ++it) {
+                if (auto match = dynamic_cast<T *>(it->second))
+                    matches.push_back(match);
+            }
+        } else {
+            collectChildren(name, lookup, matches);
+        }
+        return matches;
+    }
+
+    // Deletes the object from the event loop it lives on. Called from the thread of that
+    // loop, the deletion happens once per loop iteration, together with the other deferred
+    // deletions, see EventLoop::processEvents(). Children of an object deleted in the same
+    // pass are deleted along with it.
     void deleteLater();
 
-    void setObjectName(const std::string &objectName) { m_objectName = objectName; }
+    // Makes eventLoop, e.g. the one of a Thread, deliver the events posted to this object
+    // and its children from now on. Must be called from the thread the object currently
+    // lives on. Events posted before are still delivered by the previous loop. Objects
+    // allocated from an arena can only move to loops of the thread of the arena.
+    void moveToEventLoop(EventLoop *eventLoop);
+
+    void setObjectName(const std::string &objectName);
     std::string objectName() const { return m_objectName; }
 
     void event(EventReceiver *target, Event *ev) override;
 
+    // Objects allocated from an arena are handed back to it by delete, and therefore
+    // std::unique_ptr, too. Over-aligned objects never come from an arena.
+    static void *operator new(std::size_t size);
+    static void *operator new(std::size_t size, std::align_val_t alignment);
+    static void *operator new(std::size_t, void *where) noexcept { return where; }
+    static void operator delete(void *ptr, std::size_t size) noexcept;
+    static void operator delete(void *ptr, std::size_t size, std::align_val_t alignment) noexcept;
+    static void operator delete(void *, void *) noexcept { }
+
     KDBindings::Signal<Object *, Object *> parentChanged;
     KDBindings::Signal<Object *, Object *> childAdded;
     KDBindings::Signal<Object *, Object *> childRemoved;
@@ -109,9 +206,90 @@ protected:
     virtual void userEvent(Event *ev);
 
 private:
+    friend class EventLoop;
+    friend class ObjectArena;
+
+    // Makes the Objects allocated while it exists come from arena
+    struct ArenaAllocationScope {
+        explicit ArenaAllocationScope(ObjectArena *arena) { setAllocationArena(arena); }
+        ~ArenaAllocationScope() { setAllocationArena(nullptr); }
+        ArenaAllocationScope(const ArenaAllocationScope &other) = delete;
+        ArenaAllocationScope &operator=(const ArenaAllocationScope &other) = delete;
+    };
+    static void setAllocationArena(ObjectArena *arena);
+
+    void setEventLoopRecursively(EventLoop *eventLoop);
+
+    // Maps the names of the children to them, only built once looked up by name
+    using NameIndex = std::unordered_multimap<std::string, Object *>;
+    const NameIndex &nameIndex();
+    void addToNameIndex(Object *child);
+    void removeFromNameIndex(Object *child);
+
+    // Uses the name index of the objects that have one and scans the children of the others
+    template<typename T>
+    T *findInChildren(const std::string &name, ChildLookup lookup) const
+    {
+        if (m_nameIndex && !name.empty()) {
+            const auto [begin, end] = m_nameIndex->equal_range(name);
+            for (auto it = begin; it != end; ++it) {
+                if (auto match = dynamic_cast<T *>(it->second))
+                    return match;
+            }
+        } else {
+            for (const auto &child : m_children) {
+                if (name.empty() || child->m_objectName == name) {
+                    if (auto match = dynamic_cast<T *>(child.get()))
+                        return match;
+                }
+            }
+        }
+
+        if (lookup == ChildLookup::Recursive) {
+            for (const auto &child : m_children) {
+                if (auto match = child->findInChildren<T>(name, lookup))
+                    return match;
+            }
+        }
+        return nullptr;
+    }
+
+    template<typename T>
+    void collectChildren(const std::string &name, ChildLookup lookup, std::vector<T *> &matches) const
+    {
+        for (const auto &child : m_children) {
+            if (name.empty() || child->m_objectName == name) {
+                if (auto match = dynamic_cast<T *>(child.get()))
+                    matches.push_back(match);
+            }
+            if (lookup == ChildLookup::Recursive)
+                child->collectChildren(name, lookup, matches);
+        }
+    }
+
     Object *m_parent{ nullptr };
+    // The memory of an object stays where it was allocated, so moves don't carry this over
+    struct ArenaAllocation {
+        ObjectArena *arena = nullptr;
+
+        explicit ArenaAllocation(ObjectArena *allocationArena)
+            : arena{ allocationArena }
+        {
+        }
+        ArenaAllocation(ArenaAllocation &&) noexcept { }
+        ArenaAllocation &operator=(ArenaAllocation &&) noexcept { return *this; }
+    };
+    ArenaAllocation m_arena;
     std::vector<std::unique_ptr<Object>> m_children;
+    // Slot of the object in the children of its parent
+    size_t m_indexInParent{ 0 };
+    // Slot of the object in the deferred deletions of m_deferredDeletionLoop. Moving the
+    // object to another loop moves the pending deletion along.
+    static constexpr size_t NotScheduledForDeletion = SIZE_MAX;
+    size_t m_deferredDeletionIndex{ NotScheduledForDeletion };
+    EventLoop *m_deferredDeletionLoop{ nullptr };
     std::string m_objectName;
+    std::unique_ptr<NameIndex> m_nameIndex;
 };
 
 } // namespace KDFoundation
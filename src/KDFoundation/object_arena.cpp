@@ -0,0 +1,66 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "object_arena.h"
+
+#include <cassert>
+
+using namespace KDFoundation;
+
+ObjectArena::ObjectArena(size_t chunkSize)
+    : m_chunkSize{ chunkSize < MaxPooledSize ? MaxPooledSize : chunkSize }
+{
+}
+
+ObjectArena::~ObjectArena()
+{
+    assert(m_allocationCount == 0 && "Objects allocated from an ObjectArena have to be destroyed before it");
+}
+
+void *ObjectArena::allocate(size_t size)
+{
+    assert(std::this_thread::get_id() == m_threadId && "ObjectArenas can only be used on the thread that created them");
+    ++m_allocationCount;
+    if (size > MaxPooledSize)
+        return ::operator new(size);
+
+    const size_t sizeClass = ObjectArena::sizeClass(size);
+    if (FreeBlock *block = m_freeBlocks[sizeClass]) {
+        m_freeBlocks[sizeClass] = block->next;
+        return block;
+    }
+
+    const size_t blockSize = sizeClass * Granularity;
+    if (static_cast<size_t>(m_chunkEnd - m_chunkPosition) < blockSize) {
+        // Whatever is left of the current chunk is too small and gets abandoned
+        m_chunks.emplace_back(new std::byte[m_chunkSize]);
+        m_chunkPosition = m_chunks.back().get();
+        m_chunkEnd = m_chunkPosition + m_chunkSize;
+    }
+    void *block = m_chunkPosition;
+    m_chunkPosition += blockSize;
+    return block;
+}
+
+void ObjectArena::deallocate(void *ptr, size_t size)
+{
+    assert(std::this_thread::get_id() == m_threadId && "ObjectArenas can only be used on the thread that created them");
+    assert(m_allocationCount > 0);
+    --m_allocationCount;
+    if (size > MaxPooledSize) {
+        ::operator delete(ptr);
+        return;
+    }
+
+    const size_t sizeClass = ObjectArena::sizeClass(size);
+    auto block = static_cast<FreeBlock *>(ptr);
+    block->next = m_freeBlocks[sizeClass];
+    m_freeBlocks[sizeClass] = block;
+}
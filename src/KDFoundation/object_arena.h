@@ -0,0 +1,100 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDFoundation/kdfoundation_global.h>
+#include <KDFoundation/object.h>
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace KDFoundation {
+
+// Pool the memory of Objects can be allocated from, see Object::createChild() and
+// ObjectArena::create(). Children created with createChild() on an object allocated
+// from an arena come from the same arena, so allocating the root of a tree from an
+// arena is enough to pool the whole tree.
+//
+// Allocations are carved out of large chunks and recycled through one free list per
+// size class, which makes creating and destroying objects cheap and keeps a tree close
+// together in memory. Objects are still destroyed one by one, with the usual signal
+// emissions, but their memory is only handed back to the system, all at once, when the
+// arena is destroyed. The arena therefore has to outlive the objects allocated from it.
+//
+// An arena is not thread-safe. The objects allocated from it have to be created and
+// destroyed on the thread that created the arena, and can't move to the event loop of
+// another thread.
+class KDFOUNDATION_API ObjectArena
+{
+public:
+    explicit ObjectArena(size_t chunkSize = 64 * 1024);
+    ~ObjectArena();
+
+    // Not copyable
+    ObjectArena(const ObjectArena &other) = delete;
+    ObjectArena &operator=(const ObjectArena &other) = delete;
+
+    // Not movable, objects point back at their arena
+    ObjectArena(ObjectArena &&other) = delete;
+    ObjectArena &operator=(ObjectArena &&other) = delete;
+
+    // Creates a parentless object, typically the root of a tree, from the arena
+    template<typename T, typename... Ts>
+    std::unique_ptr<T> create(Ts &&...args);
+
+    // Memory is aligned like for operator new. Sizes above MaxPooledSize are passed on to
+    // the global operator new.
+    void *allocate(size_t size);
+    // size has to be the one passed to allocate()
+    void deallocate(void *ptr, size_t size);
+
+    // The thread the arena was created on, the only one it may be used from
+    std::thread::id threadId() const { return m_threadId; }
+
+    // Number of allocations not deallocated yet
+    size_t allocationCount() const { return m_allocationCount; }
+    // Memory reserved from the system for pooled allocations
+    size_t reservedSize() const { return m_chunks.size() * m_chunkSize; }
+
+    static constexpr size_t Granularity = alignof(std::max_align_t);
+    static constexpr size_t MaxPooledSize = 1024;
+
+private:
+    struct FreeBlock {
+        FreeBlock *next;
+    };
+
+    static constexpr size_t sizeClass(size_t size) { return (size + Granularity - 1) / Granularity; }
+
+    const size_t m_chunkSize;
+    const std::thread::id m_threadId{ std::this_thread::get_id() };
+    std::vector<std::unique_ptr<std::byte[]>> m_chunks;
+    std::byte *m_chunkPosition = nullptr;
+    std::byte *m_chunkEnd = nullptr;
+    std::array<FreeBlock *, MaxPooledSize / Granularity + 1> m_freeBlocks{};
+    size_t m_allocationCount = 0;
+};
+
+template<typename T, typename... Ts>
+std::unique_ptr<T> ObjectArena::create(Ts &&...args)
+{
+    static_assert(std::is_base_of_v<Object, T>, "Only Objects can be allocated from an arena");
+    static_assert(alignof(T) <= Granularity, "Over-aligned Objects can't be allocated from an arena");
+
+    const Object::ArenaAllocationScope scope(this);
+    return std::unique_ptr<T>(new T(std::forward<Ts>(args)...));
+}
+
+} // namespace KDFoundation
@@ -10,6 +10,7 @@
 */
 
 #include <KDFoundation/platform/abstract_platform_event_loop.h>
+#include <KDFoundation/file_descriptor_notifier.h>
 
 namespace KDFoundation {
 
@@ -67,3 +68,12 @@ void KDFoundation::AbstractPlatformEventLoop::waitForEvents(int timeout)
         m_connectionEvaluator->evaluateDeferredConnections();
     }
 }
+
+bool AbstractPlatformEventLoop::updateNotifier(FileDescriptorNotifier *notifier)
+{
+    if (!notifier)
+        return false;
+    if (notifier->isEnabled())
+        return registerNotifier(notifier);
+    return unregisterNotifier(notifier);
+}
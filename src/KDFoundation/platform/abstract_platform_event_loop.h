@@ -11,10 +11,17 @@
 
 #pragma once
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <memory>
 
+#include <KDFoundation/config.h>
 #include <KDFoundation/kdfoundation_global.h>
 #include <KDFoundation/platform/abstract_platform_timer.h>
+#if KDFOUNDATION_INSTRUMENTATION
+#include <KDFoundation/latency_histogram.h>
+#endif
 
 #include <kdbindings/connection_evaluator.h>
 
@@ -24,6 +31,7 @@ class Postman;
 class FileDescriptorNotifier;
 class AbstractPlatformTimer;
 class Timer;
+enum class TimerType : uint8_t;
 
 class KDFOUNDATION_API AbstractPlatformEventLoop
 {
@@ -45,22 +53,43 @@ public:
 
     virtual bool registerNotifier(FileDescriptorNotifier *notifier) = 0;
     virtual bool unregisterNotifier(FileDescriptorNotifier *notifier) = 0;
+    // Called when a registered notifier got enabled or disabled. By default disabled
+    // notifiers are unregistered and registered again once enabled.
+    virtual bool updateNotifier(FileDescriptorNotifier *notifier);
 
     std::unique_ptr<AbstractPlatformTimer> createPlatformTimer(Timer *timer)
     {
         return createPlatformTimerImpl(timer);
     }
+    // Calls callback once after delay, see Timer::singleShot(). Returns false, leaving
+    // callback untouched, if the platform has no means to do so without a Timer.
+    bool singleShot(std::chrono::microseconds delay, TimerType type, std::function<void()> &callback)
+    {
+        return singleShotImpl(delay, type, callback);
+    }
+
     std::shared_ptr<KDBindings::ConnectionEvaluator> connectionEvaluator()
     {
         return m_connectionEvaluator;
     }
 
+#if KDFOUNDATION_INSTRUMENTATION
+    // Time spent blocked in the operating system waiting for events, in nanoseconds
+    const LatencyHistogram &waitTime() const { return m_waitTime; }
+    LatencyHistogram &waitTime() { return m_waitTime; }
+#endif
+
 protected:
     virtual std::unique_ptr<AbstractPlatformTimer> createPlatformTimerImpl(Timer *timer) = 0;
     virtual void waitForEventsImpl(int timeout) = 0;
+    virtual bool singleShotImpl(std::chrono::microseconds /*delay*/, TimerType /*type*/, std::function<void()> & /*callback*/) { return false; }
 
     Postman *m_postman{ nullptr };
     std::shared_ptr<KDBindings::ConnectionEvaluator> m_connectionEvaluator;
+#if KDFOUNDATION_INSTRUMENTATION
+    // Recorded by the implementations around their blocking call
+    LatencyHistogram m_waitTime;
+#endif
 };
 
 } // namespace KDFoundation
@@ -21,12 +21,22 @@
 #include <unistd.h>
 #include <sys/eventfd.h>
 
+#include <algorithm>
 #include <array>
+#include <cstdlib>
 #include <cstring>
+#include <string_view>
+#include <utility>
 
 using namespace KDFoundation;
 
+namespace {
+constexpr size_t MinEventBatchSize = 16;
+constexpr size_t MaxEventBatchSize = 4096;
+} // namespace
+
 LinuxPlatformEventLoop::LinuxPlatformEventLoop()
+    : m_events(MinEventBatchSize)
 {
     // We use epoll to multiplex as it has much better performance than
     // select or poll.
@@ -61,6 +71,10 @@ LinuxPlatformEventLoop::LinuxPlatformEventLoop()
 
 LinuxPlatformEventLoop::~LinuxPlatformEventLoop()
 {
+    if (m_timerWheel) {
+        epoll_ctl(m_epollHandle, EPOLL_CTL_DEL, m_timerWheel->fileDescriptor(), nullptr);
+        m_timerWheel.reset();
+    }
     if (close(m_eventfd))
         SPDLOG_CRITICAL("Failed to cleanup eventfd");
     if (close(m_epollHandle))
@@ -69,50 +83,78 @@ LinuxPlatformEventLoop::~LinuxPlatformEventLoop()
 
 void LinuxPlatformEventLoop::waitForEventsImpl(int timeout)
 {
-    const int maxEventCount = 16;
-    std::array<epoll_event, maxEventCount> events;
-
-    const int eventCount = epoll_wait(m_epollHandle, events.data(), events.size(), timeout);
+#if KDFOUNDATION_INSTRUMENTATION
+    const auto waitStartTime = std::chrono::steady_clock::now();
+#endif
+    const int eventCount = epoll_wait(m_epollHandle, m_events.data(), static_cast<int>(m_events.size()), timeout);
+#if KDFOUNDATION_INSTRUMENTATION
+    m_waitTime.record(std::chrono::steady_clock::now() - waitStartTime);
+#endif
     SPDLOG_DEBUG("epoll_wait() returned {} events within {} msecs", eventCount, timeout);
 
+    // We are awake. Anything posted before a wake-up got coalesced into a pending one
+    // is processed after we return, so the next wakeUp() has to kick the eventfd again.
+    m_wakeUpPending.exchange(false, std::memory_order_acq_rel);
+
     // Let interested parties know if something happened.
     if (!m_postman) {
         SPDLOG_WARN("No postman set. Cannot deliver events");
         return;
     }
 
+    // Notifiers may register or unregister notifiers while their events are delivered,
+    // which may move the table around. Hence the copies and lookups by index below.
     for (int i = 0; i < eventCount; ++i) {
-        const auto &ePollEvent = events[i];
-        if (ePollEvent.data.fd == m_eventfd)
+        const int fd = m_events[i].data.fd;
+        const uint32_t eventTypes = m_events[i].events;
+        if (fd == m_eventfd)
             continue; // Just our wake up event
 
-        const auto &notifierSet = m_notifiers[ePollEvent.data.fd];
-
-        // Find which notifiers for this fd should be poked
-        const uint32_t eventTypes = ePollEvent.events;
-
-        if (notifierSet.hasNotifier(FileDescriptorNotifier::NotificationType::Read) &&
-            (eventTypes & EPOLLIN || eventTypes & EPOLLHUP || eventTypes & EPOLLERR)) {
-            NotifierEvent ev;
-            m_postman->deliverEvent(notifierSet.getNotifier(FileDescriptorNotifier::NotificationType::Read), &ev);
+        if (m_timerWheel && fd == m_timerWheel->fileDescriptor()) {
+            m_timerWheel->processExpiredTimers();
+            continue;
         }
 
-        if (notifierSet.hasNotifier(FileDescriptorNotifier::NotificationType::Write) &&
-            (eventTypes & EPOLLOUT || eventTypes & EPOLLHUP || eventTypes & EPOLLERR)) {
-            NotifierEvent ev;
-            m_postman->deliverEvent(notifierSet.getNotifier(FileDescriptorNotifier::NotificationType::Write), &ev);
-        }
+        // A one-shot registration is off in the kernel now. It gets re-armed below
+        // unless the notifiers that fired disabled themselves, in which case it stays
+        // disarmed until they are re-armed.
+        if (static_cast<size_t>(fd) < m_notifiers.size() && (m_notifiers[fd].epollEvents & EPOLLONESHOT))
+            m_notifiers[fd].disarmed = true;
 
-        if (notifierSet.hasNotifier(FileDescriptorNotifier::NotificationType::Exception) &&
-            (eventTypes & EPOLLPRI || eventTypes & EPOLLHUP || eventTypes & EPOLLERR)) {
-            NotifierEvent ev;
-            m_postman->deliverEvent(notifierSet.getNotifier(FileDescriptorNotifier::NotificationType::Exception), &ev);
+        // Find which notifiers for this fd should be poked
+        constexpr uint32_t errorEvents = EPOLLHUP | EPOLLERR;
+        const std::array<std::pair<FileDescriptorNotifier::NotificationType, uint32_t>, 3> types = { {
+                { FileDescriptorNotifier::NotificationType::Read, EPOLLIN | errorEvents },
+                { FileDescriptorNotifier::NotificationType::Write, EPOLLOUT | errorEvents },
+                { FileDescriptorNotifier::NotificationType::Exception, EPOLLPRI | errorEvents },
+        } };
+        for (const auto &[type, mask] : types) {
+            if (!(eventTypes & mask))
+                continue;
+            auto notifier = notifierSet(fd).getNotifier(type);
+            if (notifier && notifier->isEnabled()) {
+                NotifierEvent ev;
+                m_postman->deliverEvent(notifier, &ev);
+            }
         }
+
+        if (static_cast<size_t>(fd) < m_notifiers.size() && m_notifiers[fd].disarmed)
+            updateEpollRegistration(fd);
     }
+
+    // A full batch means more file descriptors are likely ready. Fetch more of them
+    // per call from now on.
+    if (static_cast<size_t>(eventCount) == m_events.size() && m_events.size() < MaxEventBatchSize)
+        m_events.resize(m_events.size() * 2);
 }
 
 void LinuxPlatformEventLoop::wakeUp()
 {
+    // Only write to the eventfd if no wake-up is pending yet. This makes bursts of posted
+    // events cost a single syscall.
+    if (m_wakeUpPending.exchange(true, std::memory_order_acq_rel))
+        return;
+
     const eventfd_t value{ 1 };
     eventfd_write(m_eventfd, value);
 }
@@ -122,16 +164,31 @@ bool LinuxPlatformEventLoop::registerNotifier(FileDescriptorNotifier *notifier)
     if (!notifier)
         return false;
 
+    // Negative file descriptors would make for a huge index into the table
+    const int fd = notifier->fileDescriptor();
+    if (fd < 0) {
+        SPDLOG_ERROR("Failed to register invalid file descriptor {}", fd);
+        return false;
+    }
+
     // Is this file descriptor already being watched?
-    auto &notifierSet = m_notifiers[notifier->fileDescriptor()];
     const auto type = notifier->type();
-    if (notifierSet.hasNotifier(type))
+    if (notifierSet(fd).hasNotifier(type))
         return false;
+    const bool wasWatched = !notifierSet(fd).isEmpty();
 
-    const bool result = registerFileDescriptor(notifier->fileDescriptor(), type);
-    if (result)
-        notifierSet.setNotifier(type, notifier);
-    return result;
+    if (static_cast<size_t>(fd) >= m_notifiers.size())
+        m_notifiers.resize(std::max(static_cast<size_t>(fd) + 1, m_notifiers.size() * 2));
+    m_notifiers[fd].setNotifier(type, notifier);
+    if (!updateEpollRegistration(fd)) {
+        m_notifiers[fd].resetNotifier(type);
+        return false;
+    }
+
+    if (!wasWatched)
+        ++m_registeredFileDescriptorCount;
+    SPDLOG_DEBUG("Registered file descriptor {}", fd);
+    return true;
 }
 
 bool LinuxPlatformEventLoop::unregisterNotifier(FileDescriptorNotifier *notifier)
@@ -139,24 +196,101 @@ bool LinuxPlatformEventLoop::unregisterNotifier(FileDescriptorNotifier *notifier
     if (!notifier)
         return false;
 
+    const int fd = notifier->fileDescriptor();
     const auto type = notifier->type();
-    const bool result = unregisterFileDescriptor(notifier->fileDescriptor(), type);
-    if (result) {
-        auto &notifierSet = m_notifiers[notifier->fileDescriptor()];
-        notifierSet.resetNotifier(type);
-        if (notifierSet.isEmpty())
-            m_notifiers.erase(notifier->fileDescriptor());
-    }
+    if (notifierSet(fd).getNotifier(type) != notifier)
+        return false;
+
+    // Forget about the notifier even if epoll refuses, it may be about to be destroyed
+    m_notifiers[fd].resetNotifier(type);
+    if (m_notifiers[fd].isEmpty())
+        --m_registeredFileDescriptorCount;
+    const bool result = updateEpollRegistration(fd);
+    SPDLOG_DEBUG("Unregistered file descriptor {}", fd);
     return result;
 }
 
+bool LinuxPlatformEventLoop::updateNotifier(FileDescriptorNotifier *notifier)
+{
+    if (!notifier || notifierSet(notifier->fileDescriptor()).getNotifier(notifier->type()) != notifier)
+        return false;
+    return updateEpollRegistration(notifier->fileDescriptor());
+}
+
+uint32_t LinuxPlatformEventLoop::epollEventsForNotifiers(const NotifierSet &notifierSet)
+{
+    uint32_t events = 0;
+    bool allEdge = true;
+    bool allOneShot = true;
+    for (const auto type : { FileDescriptorNotifier::NotificationType::Read,
+                             FileDescriptorNotifier::NotificationType::Write,
+                             FileDescriptorNotifier::NotificationType::Exception }) {
+        const auto notifier = notifierSet.getNotifier(type);
+        if (!notifier || !notifier->isEnabled())
+            continue;
+        events |= epollEventFromNotifierTypes(type == FileDescriptorNotifier::NotificationType::Read,
+                                              type == FileDescriptorNotifier::NotificationType::Write,
+                                              type == FileDescriptorNotifier::NotificationType::Exception);
+        allEdge &= notifier->triggerMode() == FileDescriptorNotifier::TriggerMode::Edge;
+        allOneShot &= notifier->triggerMode() == FileDescriptorNotifier::TriggerMode::OneShot;
+    }
+    if (events == 0)
+        return 0;
+
+    // Trigger flags apply to the whole file descriptor. Mixed modes fall back to level
+    // triggering, one-shot notifiers then disable themselves once they fired.
+    if (allEdge)
+        events |= EPOLLET;
+    else if (allOneShot)
+        events |= EPOLLONESHOT;
+    return events;
+}
+
+bool LinuxPlatformEventLoop::updateEpollRegistration(int fd)
+{
+    auto &set = m_notifiers[fd];
+    const uint32_t events = epollEventsForNotifiers(set);
+    if (events == set.epollEvents && !set.disarmed)
+        return true;
+
+    // A disarmed one-shot registration doesn't report anything anymore, hang-ups and
+    // errors included. Keep it while the fd has notifiers, re-arming them is then a single
+    // EPOLL_CTL_MOD rather than an EPOLL_CTL_DEL followed by an EPOLL_CTL_ADD.
+    if (events == 0 && set.disarmed && !set.isEmpty())
+        return true;
+
+    // Without enabled notifiers the file descriptor leaves epoll altogether, as errors
+    // and hang-ups would otherwise still be reported
+    int epollOp = EPOLL_CTL_MOD;
+    if (set.epollEvents == 0)
+        epollOp = EPOLL_CTL_ADD;
+    else if (events == 0)
+        epollOp = EPOLL_CTL_DEL;
+
+    epoll_event ev = { 0 };
+    ev.events = events;
+    ev.data.fd = fd;
+    if (epoll_ctl(m_epollHandle, epollOp, fd, &ev)) {
+        // A closed file descriptor has left epoll already, see unregisterFileDescriptor()
+        if (epollOp == EPOLL_CTL_ADD || errno != EBADF) {
+            std::array<char, 64> buf;
+            SPDLOG_ERROR("Failed to update file descriptor {} in epoll. Error {}: {}.", fd, errno, strerror_r(errno, buf.data(), buf.size()));
+            return false;
+        }
+    }
+
+    set.epollEvents = epollOp == EPOLL_CTL_DEL ? 0 : events;
+    set.disarmed = false;
+    return true;
+}
+
 bool LinuxPlatformEventLoop::registerFileDescriptor(int fd, FileDescriptorNotifier::NotificationType type)
 {
     epoll_event ev = { 0 };
     ev.events = epollEventFromFdPlusType(fd, type);
     ev.data.fd = fd;
 
-    const int epollOp = m_notifiers[fd].isEmpty() ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+    const int epollOp = notifierSet(fd).isEmpty() ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
 
     if (epoll_ctl(m_epollHandle, epollOp, fd, &ev)) {
         SPDLOG_ERROR("Failed to register file descriptor {}. Error = {}", fd, errno);
@@ -173,7 +307,7 @@ bool LinuxPlatformEventLoop::unregisterFileDescriptor(int fd, FileDescriptorNoti
     ev.events = epollEventFromFdMinusType(fd, type);
     ev.data.fd = fd;
 
-    const int epollOp = m_notifiers[fd].wouldBeEmptyIfUnset(type) ? EPOLL_CTL_DEL : EPOLL_CTL_MOD;
+    const int epollOp = notifierSet(fd).wouldBeEmptyIfUnset(type) ? EPOLL_CTL_DEL : EPOLL_CTL_MOD;
     const auto rv = epoll_ctl(m_epollHandle, epollOp, fd, &ev);
 
     // In case we attempted to unregister a previously registered file descriptor
@@ -192,11 +326,11 @@ bool LinuxPlatformEventLoop::unregisterFileDescriptor(int fd, FileDescriptorNoti
 
 int LinuxPlatformEventLoop::epollEventFromFdPlusType(int fd, FileDescriptorNotifier::NotificationType type)
 {
-    const auto &notifierSet = m_notifiers[fd];
+    const auto &set = notifierSet(fd);
 
-    const auto hasReadNotifier = notifierSet.hasNotifier(FileDescriptorNotifier::NotificationType::Read);
-    const auto hasWriteNotifier = notifierSet.hasNotifier(FileDescriptorNotifier::NotificationType::Write);
-    const auto hasExceptionNotifier = notifierSet.hasNotifier(FileDescriptorNotifier::NotificationType::Exception);
+    const auto hasReadNotifier = set.hasNotifier(FileDescriptorNotifier::NotificationType::Read);
+    const auto hasWriteNotifier = set.hasNotifier(FileDescriptorNotifier::NotificationType::Write);
+    const auto hasExceptionNotifier = set.hasNotifier(FileDescriptorNotifier::NotificationType::Exception);
 
     switch (type) {
     case FileDescriptorNotifier::NotificationType::Read:
@@ -212,11 +346,11 @@ int LinuxPlatformEventLoop::epollEventFromFdPlusType(int fd, FileDescriptorNotif
 
 int LinuxPlatformEventLoop::epollEventFromFdMinusType(int fd, FileDescriptorNotifier::NotificationType type)
 {
-    const auto &notifierSet = m_notifiers[fd];
+    const auto &set = notifierSet(fd);
 
-    const auto hasReadNotifier = notifierSet.hasNotifier(FileDescriptorNotifier::NotificationType::Read);
-    const auto hasWriteNotifier = notifierSet.hasNotifier(FileDescriptorNotifier::NotificationType::Write);
-    const auto hasExceptionNotifier = notifierSet.hasNotifier(FileDescriptorNotifier::NotificationType::Exception);
+    const auto hasReadNotifier = set.hasNotifier(FileDescriptorNotifier::NotificationType::Read);
+    const auto hasWriteNotifier = set.hasNotifier(FileDescriptorNotifier::NotificationType::Write);
+    const auto hasExceptionNotifier = set.hasNotifier(FileDescriptorNotifier::NotificationType::Exception);
 
     switch (type) {
     case FileDescriptorNotifier::NotificationType::Read:
@@ -243,7 +377,51 @@ int LinuxPlatformEventLoop::epollEventFromNotifierTypes(bool read, bool write, b
     return epollEvent;
 }
 
+const LinuxPlatformEventLoop::NotifierSet &LinuxPlatformEventLoop::notifierSet(int fd) const
+{
+    static const NotifierSet emptySet;
+    if (fd < 0 || static_cast<size_t>(fd) >= m_notifiers.size())
+        return emptySet;
+    return m_notifiers[fd];
+}
+
+LinuxPlatformEventLoop::TimerBackend LinuxPlatformEventLoop::defaultTimerBackend()
+{
+    static const TimerBackend backend = [] {
+        if (const char *value = std::getenv("KDFOUNDATION_TIMER_BACKEND")) // NOLINT(concurrency-mt-unsafe)
+            return std::string_view{ value } == "wheel" ? TimerBackend::TimerWheel : TimerBackend::TimerFd;
+        return TimerBackend::TimerFd;
+    }();
+    return backend;
+}
+
+LinuxTimerWheel *LinuxPlatformEventLoop::timerWheel()
+{
+    if (m_timerWheel)
+        return m_timerWheel.get();
+
+    m_timerWheel = std::make_unique<LinuxTimerWheel>();
+
+    // Watched directly rather than through a FileDescriptorNotifier, just like the eventfd
+    epoll_event ev = { 0 };
+    ev.events = EPOLLIN;
+    ev.data.fd = m_timerWheel->fileDescriptor();
+    if (epoll_ctl(m_epollHandle, EPOLL_CTL_ADD, m_timerWheel->fileDescriptor(), &ev))
+        SPDLOG_CRITICAL("Failed to register timer wheel file descriptor. Error = {}", errno);
+
+    return m_timerWheel.get();
+}
+
 std::unique_ptr<AbstractPlatformTimer> LinuxPlatformEventLoop::createPlatformTimerImpl(Timer *timer)
 {
+    // Coarse timers always go to the wheel so that they can share wake-ups
+    if (m_timerBackend == TimerBackend::TimerWheel || timer->timerType.get() != TimerType::Precise)
+        return std::make_unique<LinuxTimerWheelTimer>(timer, timerWheel());
     return std::make_unique<LinuxPlatformTimer>(timer);
 }
+
+bool LinuxPlatformEventLoop::singleShotImpl(std::chrono::microseconds delay, TimerType type, std::function<void()> &callback)
+{
+    timerWheel()->singleShot(delay, type, std::move(callback));
+    return true;
+}
@@ -13,12 +13,15 @@
 
 #include <KDFoundation/platform/abstract_platform_event_loop.h>
 #include <KDFoundation/file_descriptor_notifier.h>
+#include <KDFoundation/platform/linux/linux_timer_wheel.h>
 
 #include <KDUtils/logging.h>
 
 #include <array>
+#include <atomic>
 #include <cstdint>
-#include <map>
+#include <memory>
+#include <vector>
 
 #include <sys/epoll.h>
 
@@ -39,26 +42,54 @@ public:
 
     bool registerNotifier(FileDescriptorNotifier *notifier) override;
     bool unregisterNotifier(FileDescriptorNotifier *notifier) override;
+    bool updateNotifier(FileDescriptorNotifier *notifier) override;
 
     int epollHandle() { return m_epollHandle; }
 
     bool registerFileDescriptor(int fd, FileDescriptorNotifier::NotificationType type);
     bool unregisterFileDescriptor(int fd, FileDescriptorNotifier::NotificationType type);
 
-    size_t registeredFileDescriptorCount() const { return m_notifiers.size(); }
+    size_t registeredFileDescriptorCount() const { return m_registeredFileDescriptorCount; }
 
     int epollEventFromFdPlusType(int fd, FileDescriptorNotifier::NotificationType type);
     int epollEventFromFdMinusType(int fd, FileDescriptorNotifier::NotificationType type);
     static int epollEventFromNotifierTypes(bool read, bool write, bool exception);
 
+    enum class TimerBackend : uint8_t {
+        // Every timer arms a timerfd of its own
+        TimerFd = 0,
+        // All timers share the timer wheel of the event loop and with it a single
+        // timerfd. Expiries are rounded up to the millisecond. Coarse and very coarse
+        // timers use the wheel regardless of the backend.
+        TimerWheel = 1
+    };
+
+    // Returns the backend used by default. This is TimerBackend::TimerFd unless the
+    // KDFOUNDATION_TIMER_BACKEND environment variable is set to "wheel".
+    static TimerBackend defaultTimerBackend();
+
+    // Only affects timers created afterwards
+    void setTimerBackend(TimerBackend backend) { m_timerBackend = backend; }
+    TimerBackend timerBackend() const { return m_timerBackend; }
+
+    // The timer wheel is created along with the first timer using it
+    LinuxTimerWheel *timerWheel();
+
 protected:
     void waitForEventsImpl(int timeout) override;
 
 private:
     std::unique_ptr<AbstractPlatformTimer> createPlatformTimerImpl(Timer *timer) override;
+    bool singleShotImpl(std::chrono::microseconds delay, TimerType type, std::function<void()> &callback) override;
 
     int m_epollHandle = -1;
     int m_eventfd = -1;
+    // Set by the first wakeUp() after the loop last woke up. Further calls are no-ops
+    // until waitForEventsImpl() returns from epoll_wait() and clears it again.
+    std::atomic<bool> m_wakeUpPending{ false };
+
+    TimerBackend m_timerBackend = defaultTimerBackend();
+    std::unique_ptr<LinuxTimerWheel> m_timerWheel;
 
     struct NotifierSet {
         bool isEmpty() const
@@ -111,8 +142,29 @@ private:
             return static_cast<uint8_t>(type);
         }
         std::array<FileDescriptorNotifier *, 3> events{ nullptr, nullptr, nullptr };
+
+    public:
+        // What the file descriptor is registered with in epoll, 0 if it is not
+        uint32_t epollEvents = 0;
+        // Set when a EPOLLONESHOT registration fired, which disables it in the kernel
+        bool disarmed = false;
     };
-    std::map<int, NotifierSet> m_notifiers;
+
+    // Returns an empty set for file descriptors without notifiers
+    const NotifierSet &notifierSet(int fd) const;
+
+    // Combines the enabled notifiers of a set and their trigger modes into epoll events
+    static uint32_t epollEventsForNotifiers(const NotifierSet &notifierSet);
+    // Brings the epoll registration of fd in line with its notifiers
+    bool updateEpollRegistration(int fd);
+
+    // Indexed by file descriptor. The kernel hands out the lowest free descriptor, so the
+    // table stays dense and lookups are a lot cheaper than in a map with many of them.
+    std::vector<NotifierSet> m_notifiers;
+    size_t m_registeredFileDescriptorCount = 0;
+
+    // Grows while epoll_wait() keeps filling it up
+    std::vector<epoll_event> m_events;
 };
 
 } // namespace KDFoundation
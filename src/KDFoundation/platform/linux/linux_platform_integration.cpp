@@ -10,9 +10,13 @@
 */
 
 #include <KDFoundation/platform/linux/linux_platform_integration.h>
+#include <KDFoundation/platform/linux/linux_uring_platform_event_loop.h>
 
 #include <KDFoundation/core_application.h>
 
+#include <cstdlib>
+#include <string_view>
+
 using namespace KDFoundation;
 
 LinuxPlatformIntegration::LinuxPlatformIntegration()
@@ -23,8 +27,23 @@ LinuxPlatformIntegration::~LinuxPlatformIntegration()
 {
 }
 
-LinuxPlatformEventLoop *LinuxPlatformIntegration::createPlatformEventLoopImpl()
+LinuxPlatformIntegration::EventLoopBackend LinuxPlatformIntegration::defaultEventLoopBackend()
 {
+    static const EventLoopBackend backend = [] {
+        if (const char *value = std::getenv("KDFOUNDATION_EVENT_LOOP_BACKEND")) // NOLINT(concurrency-mt-unsafe)
+            return std::string_view{ value } == "io_uring" ? EventLoopBackend::IoUring : EventLoopBackend::Epoll;
+        return EventLoopBackend::Epoll;
+    }();
+    return backend;
+}
+
+AbstractPlatformEventLoop *LinuxPlatformIntegration::createPlatformEventLoopImpl()
+{
+    if (m_eventLoopBackend == EventLoopBackend::IoUring) {
+        if (LinuxUringPlatformEventLoop::isSupported())
+            return new LinuxUringPlatformEventLoop();
+        SPDLOG_INFO("io_uring is not supported by the kernel, using epoll instead");
+    }
     return new LinuxPlatformEventLoop();
 }
 
@@ -26,8 +26,25 @@ public:
 
     static std::string linuxAppDataPath(const CoreApplication &app);
 
+    enum class EventLoopBackend : uint8_t {
+        // LinuxPlatformEventLoop
+        Epoll = 0,
+        // LinuxUringPlatformEventLoop. Falls back to epoll if the kernel lacks support.
+        IoUring = 1
+    };
+
+    // Returns the backend used by default. This is EventLoopBackend::Epoll unless the
+    // KDFOUNDATION_EVENT_LOOP_BACKEND environment variable is set to "io_uring".
+    static EventLoopBackend defaultEventLoopBackend();
+
+    // Only affects event loops created afterwards
+    void setEventLoopBackend(EventLoopBackend backend) { m_eventLoopBackend = backend; }
+    EventLoopBackend eventLoopBackend() const { return m_eventLoopBackend; }
+
 private:
-    LinuxPlatformEventLoop *createPlatformEventLoopImpl() override;
+    AbstractPlatformEventLoop *createPlatformEventLoopImpl() override;
+
+    EventLoopBackend m_eventLoopBackend = defaultEventLoopBackend();
 };
 
 } // namespace KDFoundation
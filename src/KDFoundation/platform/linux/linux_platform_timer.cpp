@@ -18,8 +18,7 @@
 #include <unistd.h>
 #include <sys/timerfd.h>
 
-#include <array>
-#include <tuple>
+#include <cstdint>
 
 using namespace KDFoundation;
 
@@ -27,9 +26,11 @@ LinuxPlatformTimer::LinuxPlatformTimer(Timer *timer)
     : m_notifier(timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC), FileDescriptorNotifier::NotificationType::Read)
 {
     m_notifierConnection = m_notifier.triggered.connect([this, timer]() {
-        std::array<char, 8> buf;
-        std::ignore = read(m_notifier.fileDescriptor(), buf.data(), buf.size());
-        timer->timeout.emit();
+        // The timerfd counts the expirations since it was last read
+        uint64_t expirations = 0;
+        if (read(m_notifier.fileDescriptor(), &expirations, sizeof(expirations)) != sizeof(expirations))
+            expirations = 1;
+        timer->timeout.emit(expirations);
     });
 
     m_timerRunningConnection = timer->running.valueChanged().connect([this, timer](bool running) {
@@ -44,6 +45,9 @@ LinuxPlatformTimer::LinuxPlatformTimer(Timer *timer)
             arm(timer->interval.get());
         }
     });
+
+    if (timer->running.get())
+        arm(timer->interval.get());
 }
 
 LinuxPlatformTimer::~LinuxPlatformTimer()
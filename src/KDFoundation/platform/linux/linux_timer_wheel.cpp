@@ -0,0 +1,263 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/platform/linux/linux_timer_wheel.h>
+
+#include <KDUtils/logging.h>
+
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+#include <algorithm>
+#include <array>
+#include <ctime>
+#include <tuple>
+
+using namespace KDFoundation;
+
+class LinuxTimerWheel::SingleShotEntry final : public TimerWheel::Entry
+{
+public:
+    explicit SingleShotEntry(LinuxTimerWheel *timerWheel)
+        : m_timerWheel(timerWheel)
+    {
+    }
+
+    std::function<void()> callback;
+
+private:
+    void expire(TimerWheel::Tick /*now*/) override
+    {
+        // Recycle the entry before calling out, the callback may well ask for another
+        // single shot
+        auto call = std::move(callback);
+        callback = nullptr;
+        m_timerWheel->m_freeSingleShotEntries.push_back(this);
+        call();
+    }
+
+    LinuxTimerWheel *m_timerWheel;
+};
+
+namespace {
+std::chrono::nanoseconds monotonicTime()
+{
+    timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+    return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+}
+} // namespace
+
+LinuxTimerWheel::LinuxTimerWheel(Mode mode)
+    : m_fd(mode == Mode::TimerFd ? timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK) : -1)
+    , m_epoch(monotonicTime())
+{
+    if (mode == Mode::TimerFd && m_fd == -1)
+        SPDLOG_CRITICAL("Failed to create timerfd for the timer wheel. Error = {}", errno);
+}
+
+LinuxTimerWheel::~LinuxTimerWheel()
+{
+    if (m_fd != -1 && close(m_fd))
+        SPDLOG_CRITICAL("Failed to close timerfd of the timer wheel");
+}
+
+TimerWheel::Tick LinuxTimerWheel::currentTick() const
+{
+    return static_cast<TimerWheel::Tick>(sinceEpoch() / tickDuration);
+}
+
+TimerWheel::Tick LinuxTimerWheel::tickAfter(std::chrono::microseconds delay) const
+{
+    // Round up so that timers never fire early
+    const auto deadline = sinceEpoch() + delay;
+    return static_cast<TimerWheel::Tick>((deadline + tickDuration - std::chrono::nanoseconds(1)) / tickDuration);
+}
+
+TimerWheel::Tick LinuxTimerWheel::coalescedExpiry(TimerWheel::Tick deadline, TimerWheel::Tick intervalTicks, TimerType type)
+{
+    constexpr TimerWheel::Tick second = std::chrono::seconds(1) / tickDuration;
+    switch (type) {
+    case TimerType::Precise:
+        break;
+    case TimerType::VeryCoarse:
+        // Round to the nearest second. Timers with shorter intervals are merely coarse.
+        if (intervalTicks >= second)
+            return (deadline + second / 2) / second * second;
+        [[fallthrough]];
+    case TimerType::Coarse: {
+        // Allow for 5% of the interval, and prefer the coarsest alignment that fits
+        const TimerWheel::Tick slack = intervalTicks / 20;
+        for (const TimerWheel::Tick granularity : { 1000, 500, 250, 100, 50, 25, 10, 5, 2 }) {
+            const TimerWheel::Tick aligned = (deadline + granularity - 1) / granularity * granularity;
+            if (aligned - deadline <= slack)
+                return aligned;
+        }
+        break;
+    }
+    }
+    return deadline;
+}
+
+void LinuxTimerWheel::schedule(TimerWheel::Entry &entry, TimerWheel::Tick expiry)
+{
+    m_wheel.schedule(entry, expiry);
+    if (!m_armedTick || entry.expiry() < *m_armedTick)
+        arm(entry.expiry());
+}
+
+void LinuxTimerWheel::cancel(TimerWheel::Entry &entry)
+{
+    m_wheel.cancel(entry);
+}
+
+void LinuxTimerWheel::singleShot(std::chrono::microseconds delay, TimerType type, std::function<void()> &&callback)
+{
+    if (m_freeSingleShotEntries.empty()) {
+        m_singleShotEntries.push_back(std::make_unique<SingleShotEntry>(this));
+        m_freeSingleShotEntries.push_back(m_singleShotEntries.back().get());
+    }
+    SingleShotEntry *entry = m_freeSingleShotEntries.back();
+    m_freeSingleShotEntries.pop_back();
+    entry->callback = std::move(callback);
+
+    const auto delayTicks = static_cast<TimerWheel::Tick>((std::max(delay, std::chrono::microseconds(0)) + tickDuration - std::chrono::microseconds(1)) / tickDuration);
+    schedule(*entry, coalescedExpiry(tickAfter(delay), delayTicks, type));
+}
+
+std::optional<std::chrono::nanoseconds> LinuxTimerWheel::timeUntilNextExpiry() const
+{
+    const auto nextExpiry = m_wheel.nextExpiry();
+    if (!nextExpiry)
+        return {};
+    const auto deadline = std::chrono::duration_cast<std::chrono::nanoseconds>(*nextExpiry * tickDuration);
+    return std::max(deadline - sinceEpoch(), std::chrono::nanoseconds(0));
+}
+
+void LinuxTimerWheel::processExpiredTimers()
+{
+    // Reset the expiration counter of the timerfd
+    if (m_fd != -1) {
+        std::array<char, 8> buf;
+        std::ignore = read(m_fd, buf.data(), buf.size());
+    }
+
+    // Timers started from within the handlers arm the timerfd as needed
+    m_armedTick.reset();
+    m_wheel.advanceTo(currentTick());
+    updateDeadline();
+}
+
+std::chrono::nanoseconds LinuxTimerWheel::sinceEpoch() const
+{
+    return monotonicTime() - m_epoch;
+}
+
+void LinuxTimerWheel::arm(TimerWheel::Tick tick)
+{
+    if (m_fd == -1)
+        return;
+    const auto deadline = m_epoch + std::chrono::duration_cast<std::chrono::nanoseconds>(tick * tickDuration);
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(deadline);
+    const itimerspec spec = {
+        .it_interval = { 0, 0 },
+        .it_value = { static_cast<time_t>(seconds.count()), static_cast<long>((deadline - seconds).count()) }
+    };
+    if (timerfd_settime(m_fd, TFD_TIMER_ABSTIME, &spec, nullptr) == 0)
+        m_armedTick = tick;
+}
+
+void LinuxTimerWheel::updateDeadline()
+{
+    if (m_fd == -1)
+        return;
+    const auto nextExpiry = m_wheel.nextExpiry();
+    if (nextExpiry == m_armedTick)
+        return;
+
+    if (nextExpiry) {
+        arm(*nextExpiry);
+    } else {
+        const itimerspec spec = {};
+        timerfd_settime(m_fd, 0, &spec, nullptr);
+        m_armedTick.reset();
+    }
+}
+
+LinuxTimerWheelTimer::LinuxTimerWheelTimer(Timer *timer, LinuxTimerWheel *timerWheel)
+    : m_timer(timer)
+    , m_timerWheel(timerWheel)
+{
+    m_timerRunningConnection = timer->running.valueChanged().connect([this](bool running) {
+        if (running) {
+            start();
+        } else {
+            stop();
+        }
+    });
+    m_timerIntervalConnection = timer->interval.valueChanged().connect([this]() {
+        if (m_timer->running.get()) {
+            start();
+        }
+    });
+
+    if (timer->running.get())
+        start();
+}
+
+LinuxTimerWheelTimer::~LinuxTimerWheelTimer()
+{
+    // The wheel lets go of its entries when it is destroyed first
+    if (isScheduled())
+        m_timerWheel->cancel(*this);
+}
+
+void LinuxTimerWheelTimer::start()
+{
+    // Like a timerfd, a zero interval leaves the timer disarmed
+    const auto interval = m_timer->interval.get();
+    if (interval.count() <= 0) {
+        stop();
+        return;
+    }
+
+    m_type = m_timer->timerType.get();
+    m_intervalTicks = static_cast<TimerWheel::Tick>((interval + LinuxTimerWheel::tickDuration - std::chrono::microseconds(1)) / LinuxTimerWheel::tickDuration);
+    if (m_type == TimerType::VeryCoarse) {
+        // Intervals of a second or more are rounded to whole seconds as well
+        constexpr TimerWheel::Tick second = std::chrono::seconds(1) / LinuxTimerWheel::tickDuration;
+        if (m_intervalTicks >= second)
+            m_intervalTicks = (m_intervalTicks + second / 2) / second * second;
+    }
+
+    m_deadline = m_timerWheel->tickAfter(m_intervalTicks * LinuxTimerWheel::tickDuration);
+    m_timerWheel->schedule(*this, LinuxTimerWheel::coalescedExpiry(m_deadline, m_intervalTicks, m_type));
+}
+
+void LinuxTimerWheelTimer::stop()
+{
+    m_timerWheel->cancel(*this);
+}
+
+void LinuxTimerWheelTimer::expire(TimerWheel::Tick now)
+{
+    // Stay in phase with the original start time. Expirations that were missed because
+    // the loop was late are folded into this one, as a timerfd would do.
+    uint64_t expirations = 1;
+    m_deadline += m_intervalTicks;
+    if (m_deadline <= now) {
+        const TimerWheel::Tick missed = (now - m_deadline) / m_intervalTicks + 1;
+        m_deadline += missed * m_intervalTicks;
+        expirations += missed;
+    }
+    m_timerWheel->schedule(*this, LinuxTimerWheel::coalescedExpiry(m_deadline, m_intervalTicks, m_type));
+
+    m_timer->timeout.emit(expirations);
+}
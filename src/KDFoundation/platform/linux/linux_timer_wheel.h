@@ -0,0 +1,124 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include <kdbindings/signal.h>
+
+#include <KDFoundation/platform/abstract_platform_timer.h>
+#include <KDFoundation/timer.h>
+#include <KDFoundation/timer_wheel.h>
+
+namespace KDFoundation {
+
+// Drives a TimerWheel with one tick per millisecond from a single timerfd, which is
+// always armed to the next expiry of the wheel. The owning LinuxPlatformEventLoop
+// watches the timerfd and calls processExpiredTimers() once it becomes readable.
+class KDFOUNDATION_API LinuxTimerWheel
+{
+public:
+    enum class Mode : uint8_t {
+        // Arms a timerfd of its own to the next expiry
+        TimerFd = 0,
+        // Without a timerfd. The owner bounds its waits by timeUntilNextExpiry() and calls
+        // processExpiredTimers() after every wait.
+        External = 1
+    };
+
+    explicit LinuxTimerWheel(Mode mode = Mode::TimerFd);
+    ~LinuxTimerWheel();
+
+    LinuxTimerWheel(const LinuxTimerWheel &other) = delete;
+    LinuxTimerWheel &operator=(const LinuxTimerWheel &other) = delete;
+    LinuxTimerWheel(LinuxTimerWheel &&other) = delete;
+    LinuxTimerWheel &operator=(LinuxTimerWheel &&other) = delete;
+
+    static constexpr std::chrono::microseconds tickDuration{ 1000 };
+
+    // -1 in Mode::External
+    int fileDescriptor() const { return m_fd; }
+
+    // The tick that has most recently begun
+    TimerWheel::Tick currentTick() const;
+    // The first tick that begins once delay has elapsed from now
+    TimerWheel::Tick tickAfter(std::chrono::microseconds delay) const;
+
+    // Returns the tick at which a timer of the given type with the given deadline
+    // should expire. Coarse timers are moved to the roundest tick within their slack,
+    // so that timers with similar deadlines end up sharing the same wake-up.
+    static TimerWheel::Tick coalescedExpiry(TimerWheel::Tick deadline, TimerWheel::Tick intervalTicks, TimerType type);
+
+    void schedule(TimerWheel::Entry &entry, TimerWheel::Tick expiry);
+    void cancel(TimerWheel::Entry &entry);
+
+    // Calls callback once after delay. The wheel entries used for this are recycled.
+    void singleShot(std::chrono::microseconds delay, TimerType type, std::function<void()> &&callback);
+
+    size_t timerCount() const { return m_wheel.size(); }
+
+    // Time left until the next expiry, zero if it is overdue, nothing if no timer is
+    // scheduled. May be early, see TimerWheel::nextExpiry().
+    std::optional<std::chrono::nanoseconds> timeUntilNextExpiry() const;
+
+    void processExpiredTimers();
+
+private:
+    std::chrono::nanoseconds sinceEpoch() const;
+    void arm(TimerWheel::Tick tick);
+    void updateDeadline();
+
+    class SingleShotEntry;
+
+    int m_fd = -1;
+    // CLOCK_MONOTONIC time of tick 0
+    std::chrono::nanoseconds m_epoch{ 0 };
+    // Declared before the wheel so that they outlive it
+    std::vector<std::unique_ptr<SingleShotEntry>> m_singleShotEntries;
+    std::vector<SingleShotEntry *> m_freeSingleShotEntries;
+    TimerWheel m_wheel;
+    // The tick the timerfd is armed for. The timerfd is not disarmed when timers are
+    // cancelled. It may then fire early, in which case it is simply armed again.
+    std::optional<TimerWheel::Tick> m_armedTick;
+};
+
+// Timer backed by the timer wheel of the event loop instead of a timerfd of its own.
+// Expiries are rounded up to whole ticks of the wheel and coalesced according to the
+// type of the timer.
+class KDFOUNDATION_API LinuxTimerWheelTimer : public AbstractPlatformTimer, private TimerWheel::Entry
+{
+public:
+    LinuxTimerWheelTimer(Timer *timer, LinuxTimerWheel *timerWheel);
+    ~LinuxTimerWheelTimer() override;
+
+private:
+    void start();
+    void stop();
+    void expire(TimerWheel::Tick now) override;
+
+    Timer *m_timer;
+    LinuxTimerWheel *m_timerWheel;
+    TimerType m_type = TimerType::Precise;
+    TimerWheel::Tick m_intervalTicks = 0;
+    // The tick the timer is due at. Coarse timers may be scheduled to expire a little
+    // later (or, if very coarse, earlier). Later deadlines are derived from this one
+    // so that coalescing does not make the timer drift.
+    TimerWheel::Tick m_deadline = 0;
+    KDBindings::ScopedConnection m_timerRunningConnection;
+    KDBindings::ScopedConnection m_timerIntervalConnection;
+};
+
+} // namespace KDFoundation
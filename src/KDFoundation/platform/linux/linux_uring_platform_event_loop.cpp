@@ -0,0 +1,540 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/platform/linux/linux_uring_platform_event_loop.h>
+
+#include <KDFoundation/event.h>
+#include <KDFoundation/postman.h>
+#include <KDFoundation/timer.h>
+
+#include <KDUtils/logging.h>
+
+#include <linux/io_uring.h>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <vector>
+
+using namespace KDFoundation;
+
+namespace {
+// User data of completions that only serve to wake the loop up or acknowledge the
+// removal of a poll request. Poll requests never use it, their generation is never 0.
+constexpr uint64_t IgnoredUserData = 0;
+// User data of the poll request on the wake-up eventfd, slot 1 of generation 0
+constexpr uint64_t WakeUpUserData = 1;
+
+constexpr unsigned RingEntries = 256;
+
+uint64_t pollUserData(uint32_t slotIndex, uint32_t generation)
+{
+    return (uint64_t(generation) << 32) | slotIndex;
+}
+
+uint32_t pollEventsFor(FileDescriptorNotifier::NotificationType type)
+{
+    // Errors and hang-ups are always reported, as with epoll
+    switch (type) {
+    case FileDescriptorNotifier::NotificationType::Read:
+        return POLLIN;
+    case FileDescriptorNotifier::NotificationType::Write:
+        return POLLOUT;
+    case FileDescriptorNotifier::NotificationType::Exception:
+        return POLLPRI;
+    }
+    return 0;
+}
+
+// The io_uring loop run by the current thread, if any
+thread_local LinuxUringPlatformEventLoop *s_threadUringLoop = nullptr;
+} // namespace
+
+// Minimal io_uring: one mapping for both rings (IORING_FEAT_SINGLE_MMAP) and one for the
+// submission queue entries. Not thread-safe, each ring is used by a single thread only.
+class LinuxUringPlatformEventLoop::Ring
+{
+public:
+    explicit Ring(unsigned entries, unsigned flags = 0)
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        params.flags = flags;
+        m_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (m_fd < 0) {
+            m_fd = -1;
+            return;
+        }
+        m_features = params.features;
+        if (!(m_features & IORING_FEAT_SINGLE_MMAP)) {
+            close(m_fd);
+            m_fd = -1;
+            return;
+        }
+
+        m_ringSize = std::max(params.sq_off.array + params.sq_entries * sizeof(unsigned),
+                              params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe));
+        m_ringMemory = mmap(nullptr, m_ringSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+        m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+        void *sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+        if (m_ringMemory == MAP_FAILED || sqes == MAP_FAILED) {
+            if (m_ringMemory != MAP_FAILED)
+                munmap(m_ringMemory, m_ringSize);
+            if (sqes != MAP_FAILED)
+                munmap(sqes, m_sqesSize);
+            m_ringMemory = nullptr;
+            close(m_fd);
+            m_fd = -1;
+            return;
+        }
+        m_sqes = static_cast<io_uring_sqe *>(sqes);
+
+        auto base = static_cast<char *>(m_ringMemory);
+        m_sqHead = reinterpret_cast<unsigned *>(base + params.sq_off.head);
+        m_sqTail = reinterpret_cast<unsigned *>(base + params.sq_off.tail);
+        m_sqMask = *reinterpret_cast<unsigned *>(base + params.sq_off.ring_mask);
+        m_sqEntries = *reinterpret_cast<unsigned *>(base + params.sq_off.ring_entries);
+        m_cqHead = reinterpret_cast<unsigned *>(base + params.cq_off.head);
+        m_cqTail = reinterpret_cast<unsigned *>(base + params.cq_off.tail);
+        m_cqMask = *reinterpret_cast<unsigned *>(base + params.cq_off.ring_mask);
+        m_cqes = reinterpret_cast<io_uring_cqe *>(base + params.cq_off.cqes);
+
+        // Submission queue entries are always used in order
+        auto array = reinterpret_cast<unsigned *>(base + params.sq_off.array);
+        for (unsigned i = 0; i < m_sqEntries; ++i)
+            array[i] = i;
+        m_localSqTail = m_submittedSqTail = *m_sqTail;
+    }
+
+    ~Ring()
+    {
+        if (m_fd == -1)
+            return;
+        munmap(m_sqes, m_sqesSize);
+        munmap(m_ringMemory, m_ringSize);
+        close(m_fd);
+    }
+
+    Ring(const Ring &other) = delete;
+    Ring &operator=(const Ring &other) = delete;
+
+    bool isValid() const { return m_fd != -1; }
+    int fd() const { return m_fd; }
+    uint32_t features() const { return m_features; }
+
+    // Returns a cleared entry to fill in. Submits what is queued already if the queue is
+    // full, returns nullptr if that does not help either.
+    io_uring_sqe *nextSqe()
+    {
+        if (m_localSqTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) >= m_sqEntries) {
+            enter(0, 0);
+            if (m_localSqTail - __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE) >= m_sqEntries)
+                return nullptr;
+        }
+        io_uring_sqe *sqe = &m_sqes[m_localSqTail & m_sqMask];
+        ++m_localSqTail;
+        std::memset(sqe, 0, sizeof(io_uring_sqe));
+        return sqe;
+    }
+
+    unsigned pendingSubmissions() const { return m_localSqTail - m_submittedSqTail; }
+
+    // Submits all queued entries and, with IORING_ENTER_GETEVENTS, waits for minComplete
+    // completions
+    int enter(unsigned minComplete, unsigned flags, const void *arg = nullptr, size_t argSize = 0)
+    {
+        __atomic_store_n(m_sqTail, m_localSqTail, __ATOMIC_RELEASE);
+        const int result = static_cast<int>(syscall(__NR_io_uring_enter, m_fd, pendingSubmissions(), minComplete, flags, arg, argSize));
+        // Without a submission thread the kernel consumes entries right away. Its head
+        // tells how many went through, even if the wait itself failed or timed out.
+        m_submittedSqTail = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+        return result;
+    }
+
+    bool hasCompletions() const
+    {
+        return *m_cqHead != __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+    }
+
+    // Appends all available completions to completions and hands their entries back to
+    // the kernel
+    void takeCompletions(std::vector<Completion> &completions)
+    {
+        unsigned head = *m_cqHead;
+        const unsigned tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+        for (; head != tail; ++head) {
+            const io_uring_cqe &cqe = m_cqes[head & m_cqMask];
+            completions.push_back({ cqe.user_data, cqe.res, cqe.flags });
+        }
+        __atomic_store_n(m_cqHead, head, __ATOMIC_RELEASE);
+    }
+
+    void discardCompletions()
+    {
+        __atomic_store_n(m_cqHead, __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+    }
+
+private:
+    int m_fd = -1;
+    uint32_t m_features = 0;
+    void *m_ringMemory = nullptr;
+    size_t m_ringSize = 0;
+    io_uring_sqe *m_sqes = nullptr;
+    size_t m_sqesSize = 0;
+
+    unsigned *m_sqHead = nullptr;
+    unsigned *m_sqTail = nullptr;
+    unsigned m_sqMask = 0;
+    unsigned m_sqEntries = 0;
+    unsigned *m_cqHead = nullptr;
+    unsigned *m_cqTail = nullptr;
+    unsigned m_cqMask = 0;
+    io_uring_cqe *m_cqes = nullptr;
+
+    // Tail of the entries filled in so far, and of the ones the kernel has consumed
+    unsigned m_localSqTail = 0;
+    unsigned m_submittedSqTail = 0;
+};
+
+bool LinuxUringPlatformEventLoop::isSupported()
+{
+    static const bool supported = [] {
+        Ring ring(2);
+        if (!ring.isValid())
+            return false;
+
+        // Waits with a timeout need IORING_ENTER_EXT_ARG
+        if (!(ring.features() & IORING_FEAT_EXT_ARG))
+            return false;
+
+        constexpr unsigned probeOpCount = 256;
+        std::vector<char> buffer(sizeof(io_uring_probe) + probeOpCount * sizeof(io_uring_probe_op), 0);
+        auto probe = reinterpret_cast<io_uring_probe *>(buffer.data());
+        if (syscall(__NR_io_uring_register, ring.fd(), IORING_REGISTER_PROBE, probe, probeOpCount) < 0)
+            return false;
+        for (const int op : { IORING_OP_NOP, IORING_OP_POLL_ADD, IORING_OP_POLL_REMOVE, IORING_OP_MSG_RING }) {
+            if (op > probe->last_op || !(probe->ops[op].flags & IO_URING_OP_SUPPORTED))
+                return false;
+        }
+        return true;
+    }();
+    return supported;
+}
+
+LinuxUringPlatformEventLoop::LinuxUringPlatformEventLoop()
+    : m_threadId(std::this_thread::get_id())
+{
+    // Only this thread ever submits to the ring, which lets the kernel skip some locking
+    // and defer its work to the next io_uring_enter()
+    m_ring = std::make_unique<Ring>(RingEntries, IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_COOP_TASKRUN);
+    if (!m_ring->isValid())
+        m_ring = std::make_unique<Ring>(RingEntries);
+    if (!m_ring->isValid()) {
+        SPDLOG_CRITICAL("Failed to set up io_uring. Error = {}", errno);
+        return;
+    }
+
+    m_wakeUpFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if (m_wakeUpFd == -1)
+        SPDLOG_CRITICAL("Failed to create eventfd for waking up the event loop. Error = {}", errno);
+    else
+        submitWakeUpPoll();
+    s_threadUringLoop = this;
+}
+
+LinuxUringPlatformEventLoop::~LinuxUringPlatformEventLoop()
+{
+    if (s_threadUringLoop == this)
+        s_threadUringLoop = nullptr;
+
+    // Closing the ring cancels all poll requests
+    m_timerWheel.reset();
+    m_ring.reset();
+    if (m_wakeUpFd != -1)
+        close(m_wakeUpFd);
+}
+
+void LinuxUringPlatformEventLoop::waitForEventsImpl(int timeout)
+{
+    if (!m_ring->isValid())
+        return;
+
+    // Don't sleep past the next timer
+    std::optional<std::chrono::nanoseconds> waitTime;
+    if (timeout >= 0)
+        waitTime = std::chrono::milliseconds(timeout);
+    if (m_timerWheel) {
+        if (const auto untilNextTimer = m_timerWheel->timeUntilNextExpiry())
+            waitTime = waitTime ? std::min(*waitTime, *untilNextTimer) : *untilNextTimer;
+    }
+
+    // Hand the queued submissions to the kernel and wait in the same call
+    if (m_ring->hasCompletions() || (waitTime && waitTime->count() == 0)) {
+        if (m_ring->pendingSubmissions() != 0)
+            m_ring->enter(0, 0);
+    } else {
+        __kernel_timespec timespec = {};
+        io_uring_getevents_arg arg = {};
+        if (waitTime) {
+            const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(*waitTime);
+            timespec.tv_sec = seconds.count();
+            timespec.tv_nsec = (*waitTime - seconds).count();
+            arg.ts = reinterpret_cast<uint64_t>(&timespec);
+        }
+        // Fails with ETIME on timeout and EINTR on signals, either is fine
+#if KDFOUNDATION_INSTRUMENTATION
+        const ScopedLatencyMeasurement measurement(m_waitTime);
+#endif
+        m_ring->enter(1, IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &arg, sizeof(arg));
+    }
+
+    // We are awake. Anything posted before a wake-up got coalesced into a pending one
+    // is processed after we return, so the next wakeUp() has to kick the ring again.
+    m_wakeUpPending.exchange(false, std::memory_order_acq_rel);
+
+    if (!m_postman) {
+        SPDLOG_WARN("No postman set. Cannot deliver events");
+        return;
+    }
+
+    if (m_timerWheel)
+        m_timerWheel->processExpiredTimers();
+
+    // Copy the completions out first. Notifiers may register or unregister notifiers,
+    // or even wait for events in a nested loop, while theirs are being delivered.
+    std::vector<Completion> completions;
+    completions.swap(m_completions);
+    m_ring->takeCompletions(completions);
+    for (const auto &completion : completions)
+        dispatchCompletion(completion.userData, completion.result, completion.flags);
+    completions.clear();
+    if (m_completions.capacity() < completions.capacity())
+        m_completions.swap(completions);
+}
+
+void LinuxUringPlatformEventLoop::dispatchCompletion(uint64_t userData, int32_t result, uint32_t flags)
+{
+    if (userData == IgnoredUserData)
+        return;
+    if (userData == WakeUpUserData) {
+        // Only there to wake the loop up. The poll stays armed unless the kernel ended it.
+        uint64_t count;
+        while (read(m_wakeUpFd, &count, sizeof(count)) == sizeof(count)) { }
+        if (!(flags & IORING_CQE_F_MORE))
+            submitWakeUpPoll();
+        return;
+    }
+
+    // Drop completions of notifiers that have been unregistered in the meantime
+    const auto slotIndex = static_cast<uint32_t>(userData);
+    const auto generation = static_cast<uint32_t>(userData >> 32);
+    if (slotIndex >= m_slots.size() || m_slots[slotIndex].generation != generation || !m_slots[slotIndex].notifier)
+        return;
+
+    // Without IORING_CQE_F_MORE the request is done, be it a single-shot poll or a
+    // multishot one the kernel ended, e.g. because the completion queue overflowed
+    if (!(flags & IORING_CQE_F_MORE))
+        m_slots[slotIndex].polling = false;
+
+    FileDescriptorNotifier *notifier = m_slots[slotIndex].notifier;
+    if (result < 0) {
+        SPDLOG_ERROR("Failed to poll file descriptor {}. Error = {}", notifier->fileDescriptor(), -result);
+        return;
+    }
+
+    if (notifier->isEnabled()) {
+        NotifierEvent ev;
+        m_postman->deliverEvent(notifier, &ev);
+    }
+
+    // Poll again unless the notifier went away or got disabled during delivery. For
+    // level-triggered notifiers this reports data the handler left unread right away.
+    const Slot &slot = m_slots[slotIndex];
+    if (slot.generation == generation && slot.notifier && slot.notifier->isEnabled() && !slot.polling)
+        submitPoll(slotIndex);
+}
+
+void LinuxUringPlatformEventLoop::wakeUp()
+{
+    // Only kick the ring if no wake-up is pending yet, as with the eventfd of epoll
+    if (m_wakeUpPending.exchange(true, std::memory_order_acq_rel) || !m_ring->isValid())
+        return;
+
+    // On the loop's own thread a no-op completes as soon as the loop goes to wait
+    if (std::this_thread::get_id() == m_threadId) {
+        if (io_uring_sqe *sqe = m_ring->nextSqe()) {
+            sqe->opcode = IORING_OP_NOP;
+            sqe->user_data = IgnoredUserData;
+        }
+        return;
+    }
+
+    // Other threads can't submit to our ring. Those running an io_uring loop themselves
+    // post a completion to it from their own ring, which saves a system call on our side.
+    LinuxUringPlatformEventLoop *senderLoop = s_threadUringLoop;
+    if (senderLoop != nullptr && senderLoop->m_ring->isValid()) {
+        if (io_uring_sqe *sqe = senderLoop->m_ring->nextSqe()) {
+            // Successful messages don't produce completions on the sending ring. Failed
+            // ones are ignored by its loop, the eventfd makes up for them.
+            sqe->opcode = IORING_OP_MSG_RING;
+            sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+            sqe->fd = m_ring->fd();
+            sqe->addr = IORING_MSG_DATA;
+            sqe->off = IgnoredUserData; // user data of the completion posted to our ring
+            sqe->user_data = IgnoredUserData;
+            if (senderLoop->m_ring->enter(0, 0) >= 0)
+                return;
+        }
+    }
+
+    // Everybody else goes through the eventfd polled by our ring
+    if (m_wakeUpFd == -1) {
+        SPDLOG_CRITICAL("Cannot wake up the event loop without its eventfd");
+        return;
+    }
+    const uint64_t one = 1;
+    while (write(m_wakeUpFd, &one, sizeof(one)) == -1 && errno == EINTR) { }
+}
+
+void LinuxUringPlatformEventLoop::submitWakeUpPoll()
+{
+    io_uring_sqe *sqe = m_ring->nextSqe();
+    if (!sqe) {
+        SPDLOG_CRITICAL("io_uring submission queue overflow, cannot poll the wake-up eventfd");
+        return;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = m_wakeUpFd;
+    sqe->poll32_events = POLLIN;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->user_data = WakeUpUserData;
+}
+
+bool LinuxUringPlatformEventLoop::registerNotifier(FileDescriptorNotifier *notifier)
+{
+    if (!notifier || !m_ring->isValid() || m_slotsByNotifier.count(notifier) != 0)
+        return false;
+    if (notifier->fileDescriptor() < 0) {
+        SPDLOG_ERROR("Failed to register invalid file descriptor {}", notifier->fileDescriptor());
+        return false;
+    }
+
+    // Regular files are always ready, polling them would spin. epoll refuses them as well.
+    struct stat status;
+    if (fstat(notifier->fileDescriptor(), &status) != 0 || S_ISREG(status.st_mode)) {
+        SPDLOG_ERROR("Failed to register file descriptor {}. It is invalid or a regular file", notifier->fileDescriptor());
+        return false;
+    }
+
+    uint32_t slotIndex;
+    if (!m_freeSlots.empty()) {
+        slotIndex = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        slotIndex = static_cast<uint32_t>(m_slots.size());
+        m_slots.emplace_back();
+    }
+    m_slots[slotIndex].notifier = notifier;
+    m_slotsByNotifier.emplace(notifier, slotIndex);
+
+    if (notifier->isEnabled())
+        submitPoll(slotIndex);
+    SPDLOG_DEBUG("Registered file descriptor {}", notifier->fileDescriptor());
+    return true;
+}
+
+bool LinuxUringPlatformEventLoop::unregisterNotifier(FileDescriptorNotifier *notifier)
+{
+    const auto it = m_slotsByNotifier.find(notifier);
+    if (it == m_slotsByNotifier.end())
+        return false;
+    const uint32_t slotIndex = it->second;
+    m_slotsByNotifier.erase(it);
+
+    cancelPoll(slotIndex);
+    m_slots[slotIndex].notifier = nullptr;
+    m_freeSlots.push_back(slotIndex);
+
+    SPDLOG_DEBUG("Unregistered file descriptor {}", notifier->fileDescriptor());
+    return true;
+}
+
+bool LinuxUringPlatformEventLoop::updateNotifier(FileDescriptorNotifier *notifier)
+{
+    const auto it = m_slotsByNotifier.find(notifier);
+    if (it == m_slotsByNotifier.end())
+        return false;
+
+    const uint32_t slotIndex = it->second;
+    if (notifier->isEnabled() && !m_slots[slotIndex].polling)
+        submitPoll(slotIndex);
+    else if (!notifier->isEnabled())
+        cancelPoll(slotIndex);
+    return true;
+}
+
+void LinuxUringPlatformEventLoop::cancelPoll(uint32_t slotIndex)
+{
+    Slot &slot = m_slots[slotIndex];
+    if (slot.polling) {
+        if (io_uring_sqe *sqe = m_ring->nextSqe()) {
+            sqe->opcode = IORING_OP_POLL_REMOVE;
+            sqe->flags = IOSQE_CQE_SKIP_SUCCESS;
+            sqe->addr = pollUserData(slotIndex, slot.generation);
+            sqe->user_data = IgnoredUserData;
+        }
+        slot.polling = false;
+    }
+
+    // Completions still on their way carry the old generation and get dropped
+    if (++slot.generation == 0)
+        slot.generation = 1;
+}
+
+void LinuxUringPlatformEventLoop::submitPoll(uint32_t slotIndex)
+{
+    Slot &slot = m_slots[slotIndex];
+    io_uring_sqe *sqe = m_ring->nextSqe();
+    if (!sqe) {
+        SPDLOG_CRITICAL("io_uring submission queue overflow, cannot poll file descriptor {}", slot.notifier->fileDescriptor());
+        return;
+    }
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = slot.notifier->fileDescriptor();
+    sqe->poll32_events = pollEventsFor(slot.notifier->type());
+    if (slot.notifier->triggerMode() == FileDescriptorNotifier::TriggerMode::Edge)
+        sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->user_data = pollUserData(slotIndex, slot.generation);
+    slot.polling = true;
+}
+
+LinuxTimerWheel *LinuxUringPlatformEventLoop::timerWheel()
+{
+    if (!m_timerWheel)
+        m_timerWheel = std::make_unique<LinuxTimerWheel>(LinuxTimerWheel::Mode::External);
+    return m_timerWheel.get();
+}
+
+std::unique_ptr<AbstractPlatformTimer> LinuxUringPlatformEventLoop::createPlatformTimerImpl(Timer *timer)
+{
+    return std::make_unique<LinuxTimerWheelTimer>(timer, timerWheel());
+}
+
+bool LinuxUringPlatformEventLoop::singleShotImpl(std::chrono::microseconds delay, TimerType type, std::function<void()> &callback)
+{
+    timerWheel()->singleShot(delay, type, std::move(callback));
+    return true;
+}
@@ -0,0 +1,109 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDFoundation/platform/abstract_platform_event_loop.h>
+#include <KDFoundation/file_descriptor_notifier.h>
+#include <KDFoundation/platform/linux/linux_timer_wheel.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace KDFoundation {
+
+// Completion based alternative to LinuxPlatformEventLoop, built on io_uring without
+// depending on liburing.
+//
+// - Every enabled notifier is a poll request on the ring, re-armed after each
+//   notification for level-triggered notifiers and multishot for edge-triggered ones.
+//   Registering, unregistering and re-arming notifiers only queue submissions, which go
+//   to the kernel along with the next wait, in a single io_uring_enter() call.
+// - Timers live on a timer wheel without a timerfd. The wait for completions is bounded
+//   by the next expiry instead.
+// - Other threads wake the loop up by writing to an eventfd the ring polls, threads
+//   running an io_uring loop themselves by sending a message to the ring from theirs.
+//   The loop's own thread queues a no-op submission instead.
+//
+// Needs Linux 5.18 or later, see isSupported().
+class KDFOUNDATION_API LinuxUringPlatformEventLoop : public AbstractPlatformEventLoop
+{
+public:
+    LinuxUringPlatformEventLoop();
+    ~LinuxUringPlatformEventLoop() override;
+
+    LinuxUringPlatformEventLoop(LinuxUringPlatformEventLoop const &other) = delete;
+    LinuxUringPlatformEventLoop &operator=(LinuxUringPlatformEventLoop const &other) = delete;
+    LinuxUringPlatformEventLoop(LinuxUringPlatformEventLoop &&other) = delete;
+    LinuxUringPlatformEventLoop &operator=(LinuxUringPlatformEventLoop &&other) = delete;
+
+    // Whether the kernel provides all io_uring features the loop relies on. Probed once.
+    static bool isSupported();
+
+    void wakeUp() override;
+
+    bool registerNotifier(FileDescriptorNotifier *notifier) override;
+    bool unregisterNotifier(FileDescriptorNotifier *notifier) override;
+    bool updateNotifier(FileDescriptorNotifier *notifier) override;
+
+    size_t registeredNotifierCount() const { return m_slotsByNotifier.size(); }
+
+    // The timer wheel is created along with the first timer
+    LinuxTimerWheel *timerWheel();
+
+protected:
+    void waitForEventsImpl(int timeout) override;
+
+private:
+    class Ring;
+
+    std::unique_ptr<AbstractPlatformTimer> createPlatformTimerImpl(Timer *timer) override;
+    bool singleShotImpl(std::chrono::microseconds delay, TimerType type, std::function<void()> &callback) override;
+
+    void submitPoll(uint32_t slotIndex);
+    void submitWakeUpPoll();
+    void cancelPoll(uint32_t slotIndex);
+    void dispatchCompletion(uint64_t userData, int32_t result, uint32_t flags);
+
+    std::unique_ptr<Ring> m_ring;
+    std::thread::id m_threadId;
+    int m_wakeUpFd = -1;
+    // Set by the first wakeUp() after the loop last woke up, see LinuxPlatformEventLoop
+    std::atomic<bool> m_wakeUpPending{ false };
+
+    std::unique_ptr<LinuxTimerWheel> m_timerWheel;
+
+    // Registered notifiers. The user data of a poll request combines the index of its
+    // slot with the generation of the slot, so that completions arriving after the
+    // notifier has been unregistered are recognized and dropped.
+    struct Slot {
+        FileDescriptorNotifier *notifier = nullptr;
+        uint32_t generation = 1;
+        // Whether a poll request is in flight
+        bool polling = false;
+    };
+    std::vector<Slot> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    std::unordered_map<FileDescriptorNotifier *, uint32_t> m_slotsByNotifier;
+
+    // Completions copied out of the ring before being dispatched
+    struct Completion {
+        uint64_t userData;
+        int32_t result;
+        uint32_t flags;
+    };
+    std::vector<Completion> m_completions;
+};
+
+} // namespace KDFoundation
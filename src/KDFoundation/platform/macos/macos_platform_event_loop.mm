@@ -43,7 +43,13 @@ void MacOSPlatformEventLoop::waitForEventsImpl(int timeout)
                 return [NSDate distantPast];
             return [NSDate dateWithTimeIntervalSinceNow:static_cast<double>(timeout) / 1000.0];
         }();
+#if KDFOUNDATION_INSTRUMENTATION
+        const auto waitStartTime = std::chrono::steady_clock::now();
+#endif
         NSEvent *event = [NSApp nextEventMatchingMask:NSEventMaskAny untilDate:expiration inMode:NSDefaultRunLoopMode dequeue:YES];
+#if KDFOUNDATION_INSTRUMENTATION
+        m_waitTime.record(std::chrono::steady_clock::now() - waitStartTime);
+#endif
         if (event)
             [NSApp sendEvent:event];
     }
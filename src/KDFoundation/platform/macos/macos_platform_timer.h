@@ -18,6 +18,8 @@
 
 #include <chrono>
 
+#include <kdbindings/signal.h>
+
 namespace KDFoundation {
 
 class Timer;
@@ -34,6 +36,8 @@ private:
     static void timerFired(CFRunLoopTimerRef timer, void *info);
     Timer *const m_handler;
     CFRunLoopTimerRef cfTimer;
+    KDBindings::ScopedConnection m_timerRunningConnection;
+    KDBindings::ScopedConnection m_timerIntervalConnection;
 };
 
 } // namespace KDFoundation
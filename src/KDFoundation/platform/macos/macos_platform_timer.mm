@@ -34,18 +34,21 @@ inline MacOSPlatformEventLoop *eventLoop()
 MacOSPlatformTimer::MacOSPlatformTimer(Timer *timer)
     : m_handler{ timer }, cfTimer{ nullptr }
 {
-    timer->running.valueChanged().connect([this, timer](bool running) {
+    m_timerRunningConnection = timer->running.valueChanged().connect([this, timer](bool running) {
         if (running) {
             arm(timer->interval.get());
         } else {
             disarm();
         }
     });
-    timer->interval.valueChanged().connect([this, timer]() {
+    m_timerIntervalConnection = timer->interval.valueChanged().connect([this, timer]() {
         if (timer->running.get()) {
             arm(timer->interval.get());
         }
     });
+
+    if (timer->running.get())
+        arm(timer->interval.get());
 }
 
 MacOSPlatformTimer::~MacOSPlatformTimer()
@@ -58,7 +61,7 @@ void MacOSPlatformTimer::timerFired(CFRunLoopTimerRef timer, void *)
     MacOSPlatformEventLoop *ev = eventLoop();
     void *key = timer;
     if (auto it = ev->timerMap.find(key); it != ev->timerMap.end()) {
-        it->second->m_handler->timeout.emit();
+        it->second->m_handler->timeout.emit(1);
     }
 }
 
@@ -103,7 +103,13 @@ void Win32PlatformEventLoop::waitForEventsImpl(int timeout)
             pHandles = &m_wakeUpEvent;
         }
         const DWORD dwTimeout = timeout == -1 ? INFINITE : timeout;
+#if KDFOUNDATION_INSTRUMENTATION
+        const auto waitStartTime = std::chrono::steady_clock::now();
+#endif
         const auto waitRet = MsgWaitForMultipleObjects(nCount, pHandles, FALSE, dwTimeout, QS_ALLINPUT);
+#if KDFOUNDATION_INSTRUMENTATION
+        m_waitTime.record(std::chrono::steady_clock::now() - waitStartTime);
+#endif
         if (waitRet == WAIT_OBJECT_0) {
             // wake up event was signaled
             assert(m_wakeUpEvent);
@@ -41,6 +41,9 @@ Win32PlatformTimer::Win32PlatformTimer(Timer *timer)
             arm(timer->interval.get());
         }
     });
+
+    if (timer->running.get())
+        arm(timer->interval.get());
 }
 
 Win32PlatformTimer::~Win32PlatformTimer()
@@ -56,7 +59,7 @@ void CALLBACK Win32PlatformTimer::callback(HWND /*hwnd*/, UINT /*uMsg*/, UINT_PT
     auto timer = eventLoop()->timers[timerId];
     assert(timer);
 
-    timer->m_timer->timeout.emit();
+    timer->m_timer->timeout.emit(1);
 }
 
 void Win32PlatformTimer::arm(std::chrono::microseconds us)
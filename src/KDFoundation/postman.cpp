@@ -14,14 +14,58 @@
 
 #include <KDFoundation/event.h>
 
+#include <algorithm>
+#include <cassert>
+
 using namespace KDFoundation;
 
+namespace {
+// Returns true if a filter accepted the event. Filters may add or remove filters while
+// being called, hence the indexing.
+bool filterEvent(const std::vector<Object *> &filters, EventReceiver *target, Event *event)
+{
+    for (size_t i = 0; i < filters.size(); ++i) {
+        filters[i]->event(target, event);
+        if (event->isAccepted())
+            return true;
+    }
+    return false;
+}
+
+void removeAll(std::vector<Object *> &filters, Object *filter)
+{
+    filters.erase(std::remove(filters.begin(), filters.end(), filter), filters.end());
+}
+} // namespace
+
 void Postman::deliverEvent(EventReceiver *target, Event *event)
 {
+    struct DeliveryScope {
+        Postman *postman;
+        explicit DeliveryScope(Postman *p)
+            : postman(p)
+        {
+            ++postman->m_deliveryDepth;
+        }
+        ~DeliveryScope()
+        {
+            if (--postman->m_deliveryDepth == 0 && postman->m_pruneNeeded)
+                postman->pruneEmptyFilterLists();
+        }
+    };
+    const DeliveryScope scope(this);
+
     // Give the registered event filters first chance to handle the event
-    for (const auto &filter : m_filters) {
-        filter->event(target, event);
-        if (event->isAccepted())
+    if (!m_filters.empty() && filterEvent(m_filters, target, event))
+        return;
+
+    const FilterList *filters = typeFilters(event->type());
+    if (filters != nullptr && !filters->empty() && filterEvent(*filters, target, event))
+        return;
+
+    if (!m_targetFilters.empty()) {
+        const auto it = m_targetFilters.find(target);
+        if (it != m_targetFilters.end() && filterEvent(it->second, target, event))
             return;
     }
 
@@ -29,15 +73,79 @@ void Postman::deliverEvent(EventReceiver *target, Event *event)
     target->event(target, event);
 }
 
+const Postman::FilterList *Postman::typeFilters(Event::Type type) const
+{
+    const auto index = static_cast<size_t>(type);
+    if (index < BuiltInTypeCount)
+        return &m_builtInTypeFilters[index];
+    if (m_userTypeFilters.empty())
+        return nullptr;
+    const auto it = m_userTypeFilters.find(static_cast<uint16_t>(type));
+    return it != m_userTypeFilters.end() ? &it->second : nullptr;
+}
+
 void Postman::addFilter(Object *filter)
 {
     assert(filter != nullptr);
     m_filters.push_back(filter);
 }
 
+void Postman::addFilter(Object *filter, std::initializer_list<Event::Type> types)
+{
+    assert(filter != nullptr);
+    for (const auto type : types) {
+        assert(type != Event::Type::Invalid);
+        const auto index = static_cast<size_t>(type);
+        if (index < BuiltInTypeCount)
+            m_builtInTypeFilters[index].push_back(filter);
+        else
+            m_userTypeFilters[static_cast<uint16_t>(type)].push_back(filter);
+    }
+}
+
+void Postman::addFilter(Object *filter, EventReceiver *target)
+{
+    assert(filter != nullptr);
+    assert(target != nullptr);
+    m_targetFilters[target].push_back(filter);
+}
+
 void Postman::removeFilter(Object *filter)
 {
-    auto it = std::find(m_filters.begin(), m_filters.end(), filter);
-    if (it != m_filters.end())
-        m_filters.erase(it);
+    removeAll(m_filters, filter);
+    for (auto &filters : m_builtInTypeFilters)
+        removeAll(filters, filter);
+    for (auto &[type, filters] : m_userTypeFilters)
+        removeAll(filters, filter);
+    for (auto &[target, filters] : m_targetFilters)
+        removeAll(filters, filter);
+
+    if (m_deliveryDepth > 0)
+        m_pruneNeeded = true;
+    else
+        pruneEmptyFilterLists();
+}
+
+void Postman::removeFiltersFor(const EventReceiver *target)
+{
+    if (m_targetFilters.empty())
+        return;
+    if (m_deliveryDepth == 0) {
+        m_targetFilters.erase(target);
+        return;
+    }
+    const auto it = m_targetFilters.find(target);
+    if (it != m_targetFilters.end()) {
+        it->second.clear();
+        m_pruneNeeded = true;
+    }
+}
+
+void Postman::pruneEmptyFilterLists()
+{
+    m_pruneNeeded = false;
+    for (auto it = m_userTypeFilters.begin(); it != m_userTypeFilters.end();)
+        it = it->second.empty() ? m_userTypeFilters.erase(it) : std::next(it);
+    for (auto it = m_targetFilters.begin(); it != m_targetFilters.end();)
+        it = it->second.empty() ? m_targetFilters.erase(it) : std::next(it);
 }
@@ -12,26 +12,64 @@
 #pragma once
 
 #include "KDFoundation/event_receiver.h"
+#include <KDFoundation/event.h>
 #include <KDFoundation/kdfoundation_global.h>
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <unordered_map>
 #include <vector>
 
 namespace KDFoundation {
 
-class Event;
 class Object;
 
 class KDFOUNDATION_API Postman
 {
 public:
+    // Gives the filters first chance to handle event, then hands it to target unless a
+    // filter accepted it. Catch-all filters are called first, then the filters registered
+    // for the type of event and last the ones registered for target, each in the order
+    // they were added in.
     void deliverEvent(EventReceiver *target, Event *event);
 
+    // Registers a catch-all filter, called for every event
     void addFilter(Object *filter);
+    // Registers a filter only called for events of the given types. Events of other types
+    // don't cost anything for the filter.
+    void addFilter(Object *filter, std::initializer_list<Event::Type> types);
+    // Registers a filter only called for events targeting target. The registration goes
+    // away when target is destroyed.
+    void addFilter(Object *filter, EventReceiver *target);
+    // Unregisters filter from everything it was registered for. A filter added several
+    // times loses all of its registrations at once.
     void removeFilter(Object *filter);
+    // Unregisters the filters registered for target
+    void removeFiltersFor(const EventReceiver *target);
+
+    // The catch-all filters
     const std::vector<Object *> &filters() const { return m_filters; }
 
 private:
-    std::vector<Object *> m_filters;
+    using FilterList = std::vector<Object *>;
+
+    static constexpr size_t BuiltInTypeCount = static_cast<size_t>(Event::Type::Invoke) + 1;
+
+    const FilterList *typeFilters(Event::Type type) const;
+    void pruneEmptyFilterLists();
+
+    FilterList m_filters;
+    // Filters by event type. Built-in types are looked up by index, user defined ones
+    // by hashing.
+    std::array<FilterList, BuiltInTypeCount> m_builtInTypeFilters;
+    std::unordered_map<uint16_t, FilterList> m_userTypeFilters;
+    std::unordered_map<const EventReceiver *, FilterList> m_targetFilters;
+    // Lists emptied while delivering are only erased once delivery is over, as they may
+    // be iterated over at the time
+    int m_deliveryDepth = 0;
+    bool m_pruneNeeded = false;
 };
 
 } // namespace KDFoundation
@@ -0,0 +1,83 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "thread.h"
+#include "event_loop.h"
+
+#include <cassert>
+
+using namespace KDFoundation;
+
+Thread::Thread() = default;
+
+Thread::~Thread()
+{
+    quit();
+    wait();
+}
+
+void Thread::start()
+{
+    assert(!m_thread.joinable() && "Thread has been started already.");
+    m_thread = std::thread([this] { run(); });
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_eventLoopCreated.wait(lock, [this] { return m_eventLoop != nullptr; });
+}
+
+void Thread::quit()
+{
+    // Quit from within the loop, quit() itself is not thread-safe
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_eventLoop)
+        m_eventLoop->postCallback([eventLoop = m_eventLoop] { eventLoop->quit(); }, EventQueue::Priority::High);
+}
+
+void Thread::wait()
+{
+    assert(std::this_thread::get_id() != m_thread.get_id() && "A thread cannot wait for itself.");
+    if (m_thread.joinable())
+        m_thread.join();
+}
+
+bool Thread::isRunning() const
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    return m_eventLoop != nullptr;
+}
+
+EventLoop *Thread::eventLoop() const
+{
+    const std::lock_guard<std::mutex> lock(m_mutex);
+    return m_eventLoop;
+}
+
+void Thread::run()
+{
+    EventLoop eventLoop;
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_eventLoop = &eventLoop;
+    }
+    m_eventLoopCreated.notify_all();
+
+    started.emit();
+    eventLoop.exec();
+    finished.emit();
+
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        m_eventLoop = nullptr;
+    }
+
+    // Deliver what has been posted in the meantime, e.g. deferred deletions of objects
+    // living on this thread
+    eventLoop.processEvents(0);
+}
@@ -0,0 +1,70 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDFoundation/kdfoundation_global.h>
+
+#include <kdbindings/signal.h>
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+namespace KDFoundation {
+
+class EventLoop;
+
+// A thread running an EventLoop of its own. Objects moved to the loop with
+// Object::moveToEventLoop() have their events, deferred deletion and single shots
+// (see Timer::singleShot()) handled on this thread.
+class KDFOUNDATION_API Thread
+{
+public:
+    Thread();
+    // Quits the event loop and waits for the thread to finish
+    ~Thread();
+
+    // Not copyable
+    Thread(const Thread &other) = delete;
+    Thread &operator=(const Thread &other) = delete;
+
+    // Not movable
+    Thread(Thread &&other) = delete;
+    Thread &operator=(Thread &&other) = delete;
+
+    // Starts the thread and returns once its event loop exists. Requires a
+    // CoreApplication, which the loop asks for a platform event loop.
+    void start();
+    // Asks the event loop to quit. May be called from any thread.
+    void quit();
+    // Waits for the thread to finish. Must not be called from the thread itself.
+    void wait();
+
+    bool isRunning() const;
+    std::thread::id id() const { return m_thread.get_id(); }
+
+    // The loop run by the thread. Only valid between start() and the thread finishing.
+    EventLoop *eventLoop() const;
+
+    // Emitted from the thread, right before its event loop starts and after it stopped
+    KDBindings::Signal<> started;
+    KDBindings::Signal<> finished;
+
+private:
+    void run();
+
+    std::thread m_thread;
+    mutable std::mutex m_mutex;
+    std::condition_variable m_eventLoopCreated;
+    EventLoop *m_eventLoop = nullptr;
+};
+
+} // namespace KDFoundation
@@ -0,0 +1,222 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "thread_pool.h"
+
+#include <algorithm>
+
+using namespace KDFoundation;
+
+namespace {
+// The pool the current thread belongs to and its index within the pool
+thread_local ThreadPool *s_currentPool = nullptr;
+thread_local size_t s_currentWorkerIndex = 0;
+
+constexpr int64_t InitialDequeCapacity = 256;
+} // namespace
+
+ThreadPool::WorkStealingDeque::Buffer::Buffer(int64_t capacity)
+    : capacity{ capacity }
+    , items{ std::make_unique<std::atomic<Job *>[]>(static_cast<size_t>(capacity)) }
+{
+}
+
+ThreadPool::WorkStealingDeque::WorkStealingDeque()
+{
+    m_buffers.push_back(std::make_unique<Buffer>(InitialDequeCapacity));
+    m_buffer.store(m_buffers.back().get(), std::memory_order_relaxed);
+}
+
+ThreadPool::WorkStealingDeque::~WorkStealingDeque() = default;
+
+void ThreadPool::WorkStealingDeque::push(Job *job)
+{
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    const int64_t top = m_top.load(std::memory_order_acquire);
+    Buffer *buffer = m_buffer.load(std::memory_order_relaxed);
+    if (bottom - top > buffer->capacity - 1)
+        buffer = grow(buffer, bottom, top);
+    buffer->put(bottom, job);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_bottom.store(bottom + 1, std::memory_order_relaxed);
+}
+
+ThreadPool::Job *ThreadPool::WorkStealingDeque::pop()
+{
+    // Claim the bottom item first, then check whether a thief got there as well
+    const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    Buffer *buffer = m_buffer.load(std::memory_order_relaxed);
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        // Empty
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job *job = buffer->get(bottom);
+    if (top == bottom) {
+        // Last item, race the thieves for it
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            job = nullptr;
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+ThreadPool::Job *ThreadPool::WorkStealingDeque::steal()
+{
+    int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+    if (top >= bottom)
+        return nullptr;
+
+    Buffer *buffer = m_buffer.load(std::memory_order_acquire);
+    Job *job = buffer->get(top);
+    // Lost the race against the owner or another thief
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        return nullptr;
+    return job;
+}
+
+ThreadPool::WorkStealingDeque::Buffer *ThreadPool::WorkStealingDeque::grow(Buffer *buffer, int64_t bottom, int64_t top)
+{
+    auto grown = std::make_unique<Buffer>(buffer->capacity * 2);
+    for (int64_t index = top; index < bottom; ++index)
+        grown->put(index, buffer->get(index));
+    m_buffers.push_back(std::move(grown));
+    m_buffer.store(m_buffers.back().get(), std::memory_order_release);
+    return m_buffers.back().get();
+}
+
+ThreadPool::ThreadPool(size_t threadCount)
+{
+    if (threadCount == 0)
+        threadCount = std::max(1U, std::thread::hardware_concurrency());
+
+    // Create all deques before any thread starts stealing from them
+    m_workers.reserve(threadCount);
+    for (size_t i = 0; i < threadCount; ++i)
+        m_workers.push_back(std::make_unique<Worker>());
+    for (size_t i = 0; i < threadCount; ++i)
+        m_workers[i]->thread = std::thread([this, i] { workerMain(i); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    waitForDone();
+
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_stopRequested = true;
+    }
+    m_wakeUpCondition.notify_all();
+    for (auto &worker : m_workers)
+        worker->thread.join();
+}
+
+ThreadPool *ThreadPool::current()
+{
+    return s_currentPool;
+}
+
+void ThreadPool::run(std::function<void()> work)
+{
+    if (!work)
+        return;
+
+    auto job = new Job(std::move(work));
+    m_pendingJobCount.fetch_add(1);
+    if (s_currentPool == this) {
+        m_workers[s_currentWorkerIndex]->deque.push(job);
+    } else {
+        std::lock_guard<std::mutex> lock(m_injectedJobsMutex);
+        m_injectedJobs.push_back(job);
+    }
+    m_queuedJobCount.fetch_add(1);
+    wakeWorker();
+}
+
+void ThreadPool::waitForDone()
+{
+    assert(s_currentPool != this && "A thread of the pool cannot wait for the pool.");
+    std::unique_lock<std::mutex> lock(m_sleepMutex);
+    m_doneCondition.wait(lock, [this] { return m_pendingJobCount.load() == 0; });
+}
+
+void ThreadPool::workerMain(size_t index)
+{
+    s_currentPool = this;
+    s_currentWorkerIndex = index;
+
+    for (;;) {
+        if (Job *job = takeJob(index)) {
+            runJob(job);
+            continue;
+        }
+
+        // Submitters bump the queued job count before checking for sleeping workers,
+        // and this thread registers as sleeping before checking the count. Either side
+        // therefore sees the other, and no wake-up gets lost.
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_sleepingWorkerCount.fetch_add(1);
+        m_wakeUpCondition.wait(lock, [this] { return m_stopRequested || m_queuedJobCount.load() != 0; });
+        m_sleepingWorkerCount.fetch_sub(1);
+        if (m_stopRequested && m_queuedJobCount.load() == 0)
+            break;
+    }
+
+    s_currentPool = nullptr;
+}
+
+ThreadPool::Job *ThreadPool::takeJob(size_t index)
+{
+    Job *job = m_workers[index]->deque.pop();
+
+    if (!job) {
+        std::lock_guard<std::mutex> lock(m_injectedJobsMutex);
+        if (!m_injectedJobs.empty()) {
+            job = m_injectedJobs.front();
+            m_injectedJobs.pop_front();
+        }
+    }
+
+    // Start with a different victim on every thread so that thieves don't all pile up
+    // on the same deque
+    const size_t workerCount = m_workers.size();
+    for (size_t i = 1; !job && i < workerCount; ++i)
+        job = m_workers[(index + i) % workerCount]->deque.steal();
+
+    if (job)
+        m_queuedJobCount.fetch_sub(1);
+    return job;
+}
+
+void ThreadPool::runJob(Job *job)
+{
+    (*job)();
+    delete job;
+
+    if (m_pendingJobCount.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_doneCondition.notify_all();
+    }
+}
+
+void ThreadPool::wakeWorker()
+{
+    if (m_sleepingWorkerCount.load() == 0)
+        return;
+    std::lock_guard<std::mutex> lock(m_sleepMutex);
+    m_wakeUpCondition.notify_one();
+}
@@ -0,0 +1,177 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDFoundation/kdfoundation_global.h>
+#include <KDFoundation/event_loop.h>
+#include <KDFoundation/future.h>
+
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace KDFoundation {
+
+// Runs work on a fixed set of threads. Every thread of the pool has a deque of its own.
+// Work submitted from one of the pool's threads goes onto that thread's deque, which it
+// works through last in, first out. Threads that run out of work first look at the work
+// submitted from outside of the pool, then steal the oldest items from the deques of
+// the other threads.
+//
+// Completions passed to run() are called on the event loop of the thread that
+// submitted the work. They are dropped if that loop is gone by the time the work is done.
+class KDFOUNDATION_API ThreadPool
+{
+public:
+    // A threadCount of 0 creates one thread per hardware thread
+    explicit ThreadPool(size_t threadCount = 0);
+    // Waits for all submitted work to be done
+    ~ThreadPool();
+
+    // Not copyable
+    ThreadPool(const ThreadPool &other) = delete;
+    ThreadPool &operator=(const ThreadPool &other) = delete;
+
+    // Not movable
+    ThreadPool(ThreadPool &&other) = delete;
+    ThreadPool &operator=(ThreadPool &&other) = delete;
+
+    size_t threadCount() const { return m_workers.size(); }
+
+    // Runs work on one of the threads of the pool
+    void run(std::function<void()> work);
+
+    // Runs work on one of the threads of the pool, then posts completion to the event
+    // loop of the calling thread, unless that loop is gone by then. completion is passed
+    // the result of work, if any.
+    template<typename Work, typename Completion>
+    void run(Work &&work, Completion &&completion)
+    {
+        EventLoop *eventLoop = EventLoop::instance();
+        assert(eventLoop && "Completions need an event loop on the submitting thread.");
+        const EventLoop::Id eventLoopId = eventLoop->id();
+
+        using Result = std::invoke_result_t<Work>;
+        if constexpr (std::is_void_v<Result>) {
+            run([work = std::forward<Work>(work), completion = std::forward<Completion>(completion), eventLoopId]() mutable {
+                work();
+                EventLoop::postCallbackIfAlive(eventLoopId, std::move(completion));
+            });
+        } else {
+            run([work = std::forward<Work>(work), completion = std::forward<Completion>(completion), eventLoopId]() mutable {
+                // std::function wants copyable callables, so share the result instead
+                auto result = std::make_shared<Result>(work());
+                EventLoop::postCallbackIfAlive(eventLoopId, [completion = std::move(completion), result = std::move(result)]() mutable {
+                    completion(std::move(*result));
+                });
+            });
+        }
+    }
+
+    // Runs work on one of the threads of the pool. The returned future gets the result
+    // of work, continuations attached to it run on the event loop of their choice.
+    template<typename Work>
+    Future<std::invoke_result_t<Work>> submit(Work &&work)
+    {
+        using Result = std::invoke_result_t<Work>;
+        Promise<Result> promise;
+        Future<Result> future = promise.future();
+        run([work = std::forward<Work>(work), promise = std::move(promise)]() mutable {
+            if constexpr (std::is_void_v<Result>) {
+                work();
+                promise.setValue();
+            } else {
+                promise.setValue(work());
+            }
+        });
+        return future;
+    }
+
+    // Blocks until all submitted work, including work submitted in the meantime, is
+    // done. Must not be called from one of the threads of the pool.
+    void waitForDone();
+
+    // Returns the pool the calling thread belongs to, if any
+    static ThreadPool *current();
+
+private:
+    using Job = std::function<void()>;
+
+    // Chase-Lev work-stealing deque. Only the owning thread pushes and pops, at the
+    // bottom. Any thread may steal from the top.
+    class WorkStealingDeque
+    {
+    public:
+        WorkStealingDeque();
+        ~WorkStealingDeque();
+
+        void push(Job *job);
+        Job *pop();
+        Job *steal();
+
+    private:
+        struct Buffer {
+            explicit Buffer(int64_t capacity);
+
+            int64_t capacity;
+            std::unique_ptr<std::atomic<Job *>[]> items;
+
+            Job *get(int64_t index) const { return items[index & (capacity - 1)].load(std::memory_order_relaxed); }
+            void put(int64_t index, Job *job) { items[index & (capacity - 1)].store(job, std::memory_order_relaxed); }
+        };
+
+        Buffer *grow(Buffer *buffer, int64_t bottom, int64_t top);
+
+        std::atomic<int64_t> m_top{ 0 };
+        std::atomic<int64_t> m_bottom{ 0 };
+        std::atomic<Buffer *> m_buffer;
+        // Buffers replaced by larger ones. Thieves may still be reading from them, so
+        // they are only freed along with the deque.
+        std::vector<std::unique_ptr<Buffer>> m_buffers;
+    };
+
+    struct Worker {
+        WorkStealingDeque deque;
+        std::thread thread;
+    };
+
+    void workerMain(size_t index);
+    Job *takeJob(size_t index);
+    void runJob(Job *job);
+    void wakeWorker();
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    // Work submitted from outside of the pool
+    std::mutex m_injectedJobsMutex;
+    std::deque<Job *> m_injectedJobs;
+
+    // Jobs submitted but not taken yet, and jobs not done yet
+    std::atomic<size_t> m_queuedJobCount{ 0 };
+    std::atomic<size_t> m_pendingJobCount{ 0 };
+
+    std::mutex m_sleepMutex;
+    std::condition_variable m_wakeUpCondition;
+    std::condition_variable m_doneCondition;
+    std::atomic<size_t> m_sleepingWorkerCount{ 0 };
+    bool m_stopRequested = false;
+};
+
+} // namespace KDFoundation
@@ -12,9 +12,14 @@
 #include "timer.h"
 
 #include "core_application.h"
+#include "event.h"
 #include "event_loop.h"
 #include "platform/abstract_platform_timer.h"
 
+#include <algorithm>
+#include <cassert>
+#include <memory>
+
 using namespace KDFoundation;
 
 namespace {
@@ -29,8 +34,49 @@ std::unique_ptr<AbstractPlatformTimer> createPlatformTimer(Timer *instance)
 Timer::Timer()
     : m_platformTimer(createPlatformTimer(this))
 {
+    // The platform may back timers of different types differently. The new platform
+    // timer picks up where the old one left off if the timer is running.
+    m_timerTypeConnection = timerType.valueChanged().connect([this]() {
+        m_platformTimer.reset();
+        m_platformTimer = createPlatformTimer(this);
+    });
+
+    // Connected before anyone else, so that slots of a single-shot timer find it stopped
+    // and may start it again
+    m_timeoutConnection = timeout.connect([this](uint64_t /*expirations*/) {
+        if (!repeating.get())
+            running = false;
+    });
 }
 
 Timer::~Timer()
 {
 }
+
+void Timer::singleShot(std::chrono::microseconds delay, std::function<void()> callback, TimerType type)
+{
+    auto eventLoop = EventLoop::instance();
+    assert(eventLoop && "Current thread must have an event loop. Create an instance of KDFoundation::EventLoop on the local thread to use a timer.");
+    eventLoop->singleShot(delay, std::move(callback), type);
+}
+
+void Timer::singleShot(std::chrono::microseconds delay, Object *context, std::function<void()> callback, TimerType type)
+{
+    assert(context);
+    EventLoop *eventLoop = context->eventLoop();
+    if (eventLoop == nullptr || eventLoop == EventLoop::instance()) {
+        singleShot(delay, std::move(callback), type);
+        return;
+    }
+
+    // Timers are owned by the thread of their loop, so have the single shot started over
+    // there. The time it takes to get there counts towards the delay. The request targets
+    // context, so that destroying context before it gets there drops it.
+    const auto start = std::chrono::steady_clock::now();
+    auto startSingleShot = [delay, start, callback = std::move(callback), type]() mutable {
+        const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        singleShot(std::max(delay - elapsed, std::chrono::microseconds(0)), std::move(callback), type);
+    };
+    if (!EventLoop::postEventIfAlive(context->eventLoopId(), context, std::make_unique<InvokeEvent>(std::move(startSingleShot)), EventQueue::Priority::High))
+        SPDLOG_ERROR("The EventLoop the context object lives on is gone, cannot start a single shot on it.");
+}
@@ -12,6 +12,9 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
 
 #include <kdbindings/property.h>
 
@@ -20,6 +23,19 @@
 namespace KDFoundation {
 
 class AbstractPlatformTimer;
+class Object;
+
+// How accurately a timer has to fire. Less accurate timers let the event loop fire
+// several timers in the same wake-up. Platforms that cannot make use of this treat all
+// timers as precise.
+enum class TimerType : uint8_t {
+    // Fires as close to the deadline as the platform allows
+    Precise = 0,
+    // May fire up to 5% of the interval late, aligned with other coarse timers
+    Coarse = 1,
+    // Fires on whole seconds only, up to half a second early or late
+    VeryCoarse = 2
+};
 
 class KDFOUNDATION_API Timer
 {
@@ -27,13 +43,33 @@ public:
     explicit Timer();
     ~Timer();
 
-    KDBindings::Signal<> timeout;
+    // Calls callback once after delay has elapsed, without the need for a Timer object.
+    // Must be called from a thread with an event loop, the callback is invoked by that
+    // loop.
+    static void singleShot(std::chrono::microseconds delay, std::function<void()> callback,
+                           TimerType type = TimerType::Precise);
+    // Same, but the callback is invoked by the event loop context lives on, which may be
+    // one of another thread. context has to exist when calling this. Destroying it before
+    // its loop got to start the single shot cancels the single shot, destroying it later
+    // doesn't.
+    static void singleShot(std::chrono::microseconds delay, Object *context, std::function<void()> callback,
+                           TimerType type = TimerType::Precise);
+
+    // Emitted with the number of expirations since the timer last fired. This is more
+    // than 1 if the event loop was late and several expirations were folded into one.
+    // Slots not interested in the count may ignore the argument.
+    KDBindings::Signal<uint64_t> timeout;
 
     KDBindings::Property<bool> running{ false };
     KDBindings::Property<std::chrono::microseconds> interval{};
+    KDBindings::Property<TimerType> timerType{ TimerType::Precise };
+    // A timer that isn't repeating stops after having fired once (single-shot mode)
+    KDBindings::Property<bool> repeating{ true };
 
 private:
     std::unique_ptr<AbstractPlatformTimer> m_platformTimer;
+    KDBindings::ScopedConnection m_timerTypeConnection;
+    KDBindings::ScopedConnection m_timeoutConnection;
 };
 
 } // namespace KDFoundation
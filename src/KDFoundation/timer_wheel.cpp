@@ -0,0 +1,293 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include "timer_wheel.h"
+
+#include <algorithm>
+#include <cassert>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+using namespace KDFoundation;
+
+namespace {
+
+static_assert(TimerWheel::SlotCount == 64, "The slot occupancy of a level is kept in a 64 bit mask");
+
+constexpr TimerWheel::Tick SlotMask = TimerWheel::SlotCount - 1;
+
+int lowestSetBit(uint64_t value)
+{
+    assert(value != 0);
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, value);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(value);
+#endif
+}
+
+constexpr int shiftOfLevel(int level)
+{
+    return level * TimerWheel::SlotBits;
+}
+
+void makeEmpty(TimerWheel::Link &head)
+{
+    head.previous = &head;
+    head.next = &head;
+}
+
+bool isEmptyList(const TimerWheel::Link &head)
+{
+    return head.next == &head;
+}
+
+void append(TimerWheel::Link &head, TimerWheel::Link &link)
+{
+    link.previous = head.previous;
+    link.next = &head;
+    head.previous->next = &link;
+    head.previous = &link;
+}
+
+} // namespace
+
+TimerWheel::TimerWheel(Tick currentTick)
+    : m_currentTick{ currentTick }
+{
+    for (auto &level : m_levels) {
+        for (auto &slot : level)
+            makeEmpty(slot.entries);
+    }
+    makeEmpty(m_overflow.entries);
+}
+
+TimerWheel::~TimerWheel()
+{
+    // Leave the entries that are still scheduled in a state in which they can safely be
+    // destroyed or cancelled later on
+    auto detachAll = [](Slot &slot) {
+        for (Link *link = slot.entries.next; link != &slot.entries;) {
+            auto &entry = static_cast<Entry &>(*link);
+            link = link->next;
+            entry.m_level = Entry::NotScheduled;
+            entry.previous = nullptr;
+            entry.next = nullptr;
+        }
+        makeEmpty(slot.entries);
+    };
+    for (auto &level : m_levels) {
+        for (auto &slot : level)
+            detachAll(slot);
+    }
+    detachAll(m_overflow);
+}
+
+void TimerWheel::schedule(Entry &entry, Tick expiry)
+{
+    if (entry.isScheduled())
+        cancel(entry);
+
+    entry.m_expiry = std::max(expiry, m_currentTick + 1);
+    insert(entry);
+    ++m_size;
+}
+
+void TimerWheel::cancel(Entry &entry)
+{
+    if (!entry.isScheduled())
+        return;
+
+    if (entry.m_level == Entry::Expiring)
+        unlink(entry);
+    else
+        removeFromSlot(entry);
+    entry.m_level = Entry::NotScheduled;
+    --m_size;
+}
+
+std::optional<TimerWheel::Tick> TimerWheel::nextExpiry() const
+{
+    std::optional<Tick> result;
+    auto consider = [&result](Tick tick) {
+        if (!result || tick < *result)
+            result = tick;
+    };
+
+    // Only the first occupied slot of each level matters, later slots of the same level
+    // cover later ticks
+    for (int level = 0; level < LevelCount; ++level) {
+        const uint64_t occupied = m_occupiedSlots[level];
+        if (occupied != 0)
+            consider(m_levels[level][lowestSetBit(occupied)].earliestExpiry);
+    }
+    if (!isEmptyList(m_overflow.entries))
+        consider(m_overflow.earliestExpiry);
+    return result;
+}
+
+size_t TimerWheel::advanceTo(Tick tick)
+{
+    size_t expiredCount = 0;
+
+    // Jump from one occupied slot to the next rather than stepping through every tick
+    std::optional<Tick> next;
+    while ((next = nextSlotStart()) && *next <= tick) {
+        m_currentTick = *next;
+
+        // Reaching the start of a slot on a higher level moves its entries down. Go
+        // from the top so that entries can fall through several levels at once.
+        if ((m_currentTick & ((Tick(1) << shiftOfLevel(LevelCount)) - 1)) == 0 && !isEmptyList(m_overflow.entries))
+            cascade(m_overflow);
+        for (int level = LevelCount - 1; level > 0; --level) {
+            if ((m_currentTick & ((Tick(1) << shiftOfLevel(level)) - 1)) != 0)
+                continue;
+            const auto slotIndex = static_cast<size_t>((m_currentTick >> shiftOfLevel(level)) & SlotMask);
+            if (m_occupiedSlots[level] & (uint64_t(1) << slotIndex))
+                cascade(m_levels[level][slotIndex]);
+        }
+
+        // Everything left in the level 0 slot of the current tick expires now
+        const auto slotIndex = static_cast<size_t>(m_currentTick & SlotMask);
+        if (!(m_occupiedSlots[0] & (uint64_t(1) << slotIndex)))
+            continue;
+
+        // Entries expiring now are kept on a separate list while their expire() is
+        // called, so that they can still be cancelled from within other expire() calls
+        Link expiring;
+        makeEmpty(expiring);
+        Slot &slot = m_levels[0][slotIndex];
+        spliceInto(expiring, slot);
+        m_occupiedSlots[0] &= ~(uint64_t(1) << slotIndex);
+        for (Link *link = expiring.next; link != &expiring; link = link->next)
+            static_cast<Entry *>(link)->m_level = Entry::Expiring;
+
+        while (!isEmptyList(expiring)) {
+            auto &entry = static_cast<Entry &>(*expiring.next);
+            unlink(entry);
+            entry.m_level = Entry::NotScheduled;
+            --m_size;
+            ++expiredCount;
+            entry.expire(tick);
+        }
+    }
+
+    m_currentTick = std::max(m_currentTick, tick);
+    return expiredCount;
+}
+
+void TimerWheel::insert(Entry &entry)
+{
+    // Find the most significant digit in which expiry and the current tick differ
+    const Tick difference = entry.m_expiry ^ m_currentTick;
+    int level = 0;
+    while (level < LevelCount && (difference >> shiftOfLevel(level + 1)) != 0)
+        ++level;
+
+    Slot *slot;
+    if (level == LevelCount) {
+        entry.m_level = Entry::Overflow;
+        entry.m_slot = 0;
+        slot = &m_overflow;
+    } else {
+        const auto slotIndex = static_cast<size_t>((entry.m_expiry >> shiftOfLevel(level)) & SlotMask);
+        entry.m_level = static_cast<uint8_t>(level);
+        entry.m_slot = static_cast<uint8_t>(slotIndex);
+        slot = &m_levels[level][slotIndex];
+        m_occupiedSlots[level] |= uint64_t(1) << slotIndex;
+    }
+
+    if (isEmptyList(slot->entries) || entry.m_expiry < slot->earliestExpiry)
+        slot->earliestExpiry = entry.m_expiry;
+    append(slot->entries, entry);
+}
+
+void TimerWheel::unlink(Link &link)
+{
+    link.previous->next = link.next;
+    link.next->previous = link.previous;
+    link.previous = nullptr;
+    link.next = nullptr;
+}
+
+void TimerWheel::removeFromSlot(Entry &entry)
+{
+    Slot &slot = slotOf(entry);
+    unlink(entry);
+    if (entry.m_level != Entry::Overflow && isEmptyList(slot.entries))
+        m_occupiedSlots[entry.m_level] &= ~(uint64_t(1) << entry.m_slot);
+}
+
+TimerWheel::Slot &TimerWheel::slotOf(const Entry &entry)
+{
+    if (entry.m_level == Entry::Overflow)
+        return m_overflow;
+    return m_levels[entry.m_level][entry.m_slot];
+}
+
+std::optional<TimerWheel::Tick> TimerWheel::nextSlotStart() const
+{
+    // All occupied slots of a level lie after the current tick, within the current
+    // slot of the level above
+    std::optional<Tick> result;
+    for (int level = 0; level < LevelCount; ++level) {
+        const uint64_t occupied = m_occupiedSlots[level];
+        if (occupied == 0)
+            continue;
+        const int shift = shiftOfLevel(level);
+        const Tick parentStart = (m_currentTick >> (shift + SlotBits)) << (shift + SlotBits);
+        const Tick start = parentStart | (Tick(lowestSetBit(occupied)) << shift);
+        if (!result || start < *result)
+            result = start;
+    }
+    if (!isEmptyList(m_overflow.entries)) {
+        const int shift = shiftOfLevel(LevelCount);
+        const Tick start = ((m_currentTick >> shift) + 1) << shift;
+        if (!result || start < *result)
+            result = start;
+    }
+    return result;
+}
+
+void TimerWheel::spliceInto(Link &head, Slot &slot)
+{
+    if (isEmptyList(slot.entries))
+        return;
+    Link *first = slot.entries.next;
+    Link *last = slot.entries.previous;
+    first->previous = head.previous;
+    head.previous->next = first;
+    last->next = &head;
+    head.previous = last;
+    makeEmpty(slot.entries);
+}
+
+void TimerWheel::cascade(Slot &slot)
+{
+    Link entries;
+    makeEmpty(entries);
+    spliceInto(entries, slot);
+    if (&slot != &m_overflow) {
+        const auto &entry = static_cast<const Entry &>(*entries.next);
+        m_occupiedSlots[entry.m_level] &= ~(uint64_t(1) << entry.m_slot);
+    }
+
+    // Relative to the new current tick every entry lands on a lower level, or back in
+    // the overflow list if it still is too far ahead
+    while (!isEmptyList(entries)) {
+        auto &entry = static_cast<Entry &>(*entries.next);
+        unlink(entry);
+        insert(entry);
+    }
+}
@@ -0,0 +1,137 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <KDFoundation/kdfoundation_global.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+namespace KDFoundation {
+
+// Hierarchical timer wheel keeping any number of timers in a single data structure.
+// Time is measured in abstract ticks. It is up to the owner to map ticks to a clock and
+// to call advanceTo() once the tick returned by nextExpiry() has been reached, e.g.
+// from a single OS timer armed to that deadline.
+//
+// There are LevelCount levels of SlotCount slots each. Level 0 has one slot per tick,
+// a slot on level n covers SlotCount^n ticks. A timer is stored on the level of the
+// most significant digit (in base SlotCount) in which its expiry differs from the
+// current tick. When the current tick reaches the start of a slot on a higher level,
+// the timers of that slot are moved down to the lower levels. Timers further ahead
+// than the highest level can represent wait in an overflow list.
+//
+// Scheduling and cancelling a timer are O(1) and never allocate.
+class KDFOUNDATION_API TimerWheel
+{
+public:
+    using Tick = uint64_t;
+
+    static constexpr int SlotBits = 6;
+    static constexpr size_t SlotCount = size_t(1) << SlotBits;
+    static constexpr int LevelCount = 4;
+
+    struct Link {
+        Link *previous = nullptr;
+        Link *next = nullptr;
+    };
+
+    // Base class for anything that can be scheduled on the wheel. Entries are linked
+    // into the wheel intrusively.
+    class KDFOUNDATION_API Entry : private Link
+    {
+    public:
+        Entry() = default;
+        Entry(const Entry &other) = delete;
+        Entry &operator=(const Entry &other) = delete;
+
+        bool isScheduled() const { return m_level != NotScheduled; }
+        Tick expiry() const { return m_expiry; }
+
+    protected:
+        ~Entry() = default;
+
+        // Called once the wheel has advanced past the expiry of the entry. The entry is
+        // no longer scheduled at this point and may schedule itself again or be
+        // destroyed. now is the tick the wheel is being advanced to, which may be later
+        // than the expiry if the wheel was advanced late.
+        virtual void expire(Tick now) = 0;
+
+    private:
+        friend class TimerWheel;
+
+        static constexpr uint8_t NotScheduled = 0xff;
+        static constexpr uint8_t Expiring = 0xfe;
+        static constexpr uint8_t Overflow = LevelCount;
+
+        Tick m_expiry = 0;
+        uint8_t m_level = NotScheduled;
+        uint8_t m_slot = 0;
+    };
+
+    explicit TimerWheel(Tick currentTick = 0);
+    ~TimerWheel();
+
+    // Not copyable
+    TimerWheel(const TimerWheel &other) = delete;
+    TimerWheel &operator=(const TimerWheel &other) = delete;
+
+    // Not movable
+    TimerWheel(TimerWheel &&other) = delete;
+    TimerWheel &operator=(TimerWheel &&other) = delete;
+
+    Tick currentTick() const { return m_currentTick; }
+
+    // Schedules entry to expire at the given tick, rescheduling it if it is scheduled
+    // already. Expiries at or before the current tick are moved to the next tick.
+    void schedule(Entry &entry, Tick expiry);
+    void cancel(Entry &entry);
+
+    // Returns a tick at or before the earliest expiry of all scheduled entries, or
+    // nothing if none is scheduled. Entries on higher levels only contribute a lower
+    // bound which may be early if entries have been cancelled.
+    std::optional<Tick> nextExpiry() const;
+
+    // Expires, in order of expiry, all entries scheduled to expire at or before tick.
+    // Returns the number of expired entries.
+    size_t advanceTo(Tick tick);
+
+    size_t size() const { return m_size; }
+    bool isEmpty() const { return m_size == 0; }
+
+private:
+    struct Slot {
+        Link entries;
+        // Lower bound of the expiries in this slot
+        Tick earliestExpiry = 0;
+    };
+
+    void insert(Entry &entry);
+    static void unlink(Link &link);
+    void removeFromSlot(Entry &entry);
+    Slot &slotOf(const Entry &entry);
+    // Start tick of the next occupied slot on any level, or of the next overflow pass
+    std::optional<Tick> nextSlotStart() const;
+    // Moves all entries of slot onto the list starting at head
+    static void spliceInto(Link &head, Slot &slot);
+    void cascade(Slot &slot);
+
+    Tick m_currentTick;
+    size_t m_size = 0;
+    std::array<std::array<Slot, SlotCount>, LevelCount> m_levels;
+    // Bit n is set if slot n of the level holds entries
+    std::array<uint64_t, LevelCount> m_occupiedSlots{};
+    Slot m_overflow;
+};
+
+} // namespace KDFoundation
@@ -108,6 +108,18 @@ public:
     int64_t xPos() const { return m_xPos; }
     int64_t yPos() const { return m_yPos; }
 
+    /// @brief Only the latest position matters, as long as no button changed in between
+    bool mergeWith(KDFoundation::Event &newer) override
+    {
+        const auto &newerMove = static_cast<const MouseMoveEvent &>(newer);
+        if (newerMove.m_buttons != m_buttons)
+            return false;
+        m_timestamp = newerMove.m_timestamp;
+        m_xPos = newerMove.m_xPos;
+        m_yPos = newerMove.m_yPos;
+        return true;
+    }
+
 private:
     uint32_t m_timestamp;
     MouseButtons m_buttons;
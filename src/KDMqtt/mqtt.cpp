@@ -230,6 +230,7 @@ int MqttClient::disconnect()
     connectionState.set(ConnectionState::DISCONNECTING);
     const auto result = m_mosquitto.client()->disconnect();
     MqttManager::instance().CHECK_AND_LOG_MOSQUITTO_RESULT(result);
+    m_eventLoopHook.setWriteInterest(m_mosquitto.client()->wantWrite());
     return result;
 }
 
@@ -246,6 +247,7 @@ int MqttClient::publish(int *msgId, const std::string &topic, const ByteArray *p
     const auto payloadData = payload ? payload->constData() : nullptr;
     const auto result = m_mosquitto.client()->publish(msgId, topic, payloadlen, payloadData, static_cast<int>(qos), retain);
     MqttManager::instance().CHECK_AND_LOG_MOSQUITTO_RESULT(result);
+    m_eventLoopHook.setWriteInterest(m_mosquitto.client()->wantWrite());
     return result;
 }
 
@@ -264,6 +266,7 @@ int MqttClient::subscribe(const std::string &pattern, QOS qos)
     if (!hasError) {
         const auto topic = std::string(pattern);
         m_subscriptionsRegistry.registerPendingRegistryOperation(topic, msgId);
+        m_eventLoopHook.setWriteInterest(m_mosquitto.client()->wantWrite());
         subscriptionState.set(SubscriptionState::SUBSCRIBING);
     }
     return result;
@@ -284,6 +287,7 @@ int MqttClient::unsubscribe(const std::string &pattern)
     if (!hasError) {
         const auto topic = std::string(pattern);
         m_subscriptionsRegistry.registerPendingRegistryOperation(topic, msgId);
+        m_eventLoopHook.setWriteInterest(m_mosquitto.client()->wantWrite());
         subscriptionState.set(SubscriptionState::UNSUBSCRIBING);
     }
     return result;
@@ -392,6 +396,7 @@ void MqttClient::onWriteOpRequested()
 {
     const auto writeOpIsPending = m_mosquitto.client()->wantWrite();
     if (!writeOpIsPending) {
+        m_eventLoopHook.setWriteInterest(false);
         return;
     }
 
@@ -403,6 +408,9 @@ void MqttClient::onMiscTaskRequested()
 {
     auto result = m_mosquitto.client()->loopMisc();
     MqttManager::instance().CHECK_AND_LOG_MOSQUITTO_RESULT(result);
+
+    // Keep-alive pings may have been queued
+    m_eventLoopHook.setWriteInterest(m_mosquitto.client()->wantWrite());
 }
 
 void MqttClient::establishConnectionTask()
@@ -470,6 +478,12 @@ void MqttClient::EventLoopHook::disengage()
     writeOpNotifier = {};
 }
 
+void MqttClient::EventLoopHook::setWriteInterest(bool interested)
+{
+    if (writeOpNotifier)
+        writeOpNotifier->setEnabled(interested);
+}
+
 bool MqttClient::EventLoopHook::isSetup() const
 {
     return (parent != nullptr);
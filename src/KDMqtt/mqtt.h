@@ -263,6 +263,10 @@ private:
         void engage(int socket);
         void disengage();
 
+        // Enables the write notifier only while mosquitto has data queued, a writable
+        // socket would otherwise wake the event loop up on every iteration
+        void setWriteInterest(bool interested);
+
         [[nodiscard]] bool isSetup() const;
         [[nodiscard]] bool isEngaged() const;
 
@@ -17,10 +17,13 @@
 #include <KDUtils/file.h>
 #include <KDUtils/logging.h>
 
+#include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <thread>
 #include <tuple>
+#include <vector>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest.h>
@@ -65,6 +68,23 @@ TEST_CASE("Event handling")
         REQUIRE(app.eventQueueSize() == 1);
     }
 
+    SUBCASE("can post several events at once")
+    {
+        CoreApplication app;
+        auto obj1 = app.createChild<EventObject>(1, 2);
+        auto obj2 = app.createChild<EventObject>(3, 4);
+        std::vector<EventQueue::TargetedEvent> events;
+        events.emplace_back(obj1, std::make_unique<PayloadEvent>(1, 2));
+        events.emplace_back(obj2, std::make_unique<PayloadEvent>(3, 4));
+        app.postEvents(std::move(events));
+        REQUIRE(app.eventQueueSize() == 2);
+
+        app.processEvents();
+        REQUIRE(obj1->userEventDelivered() == true);
+        REQUIRE(obj2->userEventDelivered() == true);
+        REQUIRE(app.eventQueueSize() == 0);
+    }
+
     SUBCASE("calling processEvents processes an event in the queue")
     {
         CoreApplication app;
@@ -90,6 +110,151 @@ TEST_CASE("Event handling")
         app.processEvents();
     }
 
+    SUBCASE("don't send pending events for objects deleted while processing events")
+    {
+        // GIVEN
+        CoreApplication app;
+        auto deleter = app.createChild<EventObject>(0, 0);
+        auto victim = new EventObject(5, 6);
+        bool victimCallbackCalled = false;
+        app.postEvent(deleter, std::make_unique<CallbackEvent>([victim] { delete victim; }));
+        app.postEvent(victim, std::make_unique<CallbackEvent>([&] { victimCallbackCalled = true; }));
+        auto survivor = app.createChild<EventObject>(5, 6);
+        app.postEvent(survivor, std::make_unique<PayloadEvent>(5, 6));
+
+        // WHEN
+        app.processEvents();
+
+        // THEN
+        CHECK(!victimCallbackCalled);
+        CHECK(survivor->userEventDelivered());
+        CHECK(app.eventQueueSize() == 0);
+    }
+
+    SUBCASE("events posted while processing events are delivered on the next iteration")
+    {
+        // GIVEN
+        CoreApplication app;
+        auto obj = app.createChild<EventObject>(5, 6);
+        app.postEvent(obj, std::make_unique<CallbackEvent>([&app, obj] {
+            app.postEvent(obj, std::make_unique<PayloadEvent>(5, 6));
+        }));
+
+        // WHEN
+        app.processEvents();
+
+        // THEN
+        CHECK(!obj->userEventDelivered());
+        CHECK(app.eventQueueSize() == 1);
+
+        // WHEN
+        app.processEvents();
+
+        // THEN
+        CHECK(obj->userEventDelivered());
+        CHECK(app.eventQueueSize() == 0);
+    }
+
+    SUBCASE("delivers events in priority order")
+    {
+        // GIVEN
+        CoreApplication app;
+        auto obj = app.createChild<EventObject>(0, 0);
+        std::vector<EventQueue::Priority> deliveryOrder;
+        const auto postWithPriority = [&](EventQueue::Priority priority) {
+            app.postEvent(obj, std::make_unique<CallbackEvent>([&deliveryOrder, priority] { deliveryOrder.push_back(priority); }), priority);
+        };
+        postWithPriority(EventQueue::Priority::Low);
+        postWithPriority(EventQueue::Priority::Normal);
+        postWithPriority(EventQueue::Priority::High);
+        REQUIRE(app.eventQueueSize() == 3);
+        REQUIRE(app.eventQueueSize(EventQueue::Priority::High) == 1);
+        REQUIRE(app.eventQueueSize(EventQueue::Priority::Normal) == 1);
+        REQUIRE(app.eventQueueSize(EventQueue::Priority::Low) == 1);
+        REQUIRE(app.eventQueueSize(EventQueue::Priority::Idle) == 0);
+
+        // WHEN
+        app.processEvents();
+
+        // THEN
+        REQUIRE(deliveryOrder == std::vector<EventQueue::Priority>{ EventQueue::Priority::High, EventQueue::Priority::Normal, EventQueue::Priority::Low });
+        REQUIRE(app.eventQueueSize() == 0);
+    }
+
+    SUBCASE("high priority events cut in line")
+    {
+        // GIVEN
+        CoreApplication app;
+        auto obj = app.createChild<EventObject>(0, 0);
+        std::vector<int> deliveryOrder;
+        app.postEvent(obj, std::make_unique<CallbackEvent>([&] {
+            deliveryOrder.push_back(1);
+            app.postEvent(obj, std::make_unique<CallbackEvent>([&] { deliveryOrder.push_back(3); }), EventQueue::Priority::High);
+        }));
+        app.postEvent(obj, std::make_unique<CallbackEvent>([&] { deliveryOrder.push_back(2); }), EventQueue::Priority::Low);
+        app.postEvent(obj, std::make_unique<CallbackEvent>([&] { deliveryOrder.push_back(4); }), EventQueue::Priority::Low);
+
+        // WHEN
+        app.processEvents();
+
+        // THEN -> the high priority event posted during delivery doesn't wait for the next iteration
+        REQUIRE(deliveryOrder == std::vector<int>{ 1, 3, 2, 4 });
+    }
+
+    SUBCASE("idle events are delivered once nothing else is pending, but are not starved")
+    {
+        // GIVEN
+        CoreApplication app;
+        auto obj = app.createChild<EventObject>(0, 0);
+        bool idleEventDelivered = false;
+        app.postEvent(obj, std::make_unique<CallbackEvent>([&] { idleEventDelivered = true; }), EventQueue::Priority::Idle);
+
+        // Keep the loop busy by re-posting a normal event from its own handler
+        std::function<void()> keepBusy = [&] {
+            app.postEvent(obj, std::make_unique<CallbackEvent>(keepBusy));
+        };
+        app.postEvent(obj, std::make_unique<CallbackEvent>(keepBusy));
+
+        // WHEN
+        app.processEvents();
+
+        // THEN
+        CHECK(!idleEventDelivered);
+
+        // WHEN
+        int iterations = 1;
+        while (!idleEventDelivered && iterations < 100) {
+            app.processEvents();
+            ++iterations;
+        }
+
+        // THEN
+        CHECK(idleEventDelivered);
+        CHECK(iterations < 100);
+        keepBusy = [] {};
+    }
+
+    SUBCASE("can coalesce pending events")
+    {
+        // GIVEN
+        CoreApplication app;
+        app.eventLoop()->setEventCoalescingEnabled(true);
+        auto obj = std::make_unique<RecursiveEventPosterObject>(std::thread::id{}, 2);
+
+        // WHEN
+        for (int i = 0; i < 10; ++i)
+            app.postEvent(obj.get(), std::make_unique<UpdateEvent>());
+
+        // THEN
+        REQUIRE(app.eventQueueSize() == 1);
+
+        // WHEN
+        app.processEvents();
+
+        // THEN
+        CHECK(obj->eventsProcessed() == 1);
+    }
+
     SUBCASE("don't end up in infinite loop")
     {
         // GIVEN
@@ -118,6 +283,282 @@ TEST_CASE("Event handling")
     }
 }
 
+TEST_CASE("Idle handlers")
+{
+    using IdleStatus = EventLoop::IdleStatus;
+
+    SUBCASE("run only when the loop would block")
+    {
+        // GIVEN
+        CoreApplication app;
+        int idleRuns = 0;
+        app.eventLoop()->addIdleHandler([&](std::chrono::steady_clock::time_point) {
+            ++idleRuns;
+            return IdleStatus::Done;
+        });
+
+        // WHEN
+        app.processEvents(0);
+
+        // THEN -> not while polling
+        CHECK(idleRuns == 0);
+
+        // WHEN
+        auto obj = app.createChild<EventObject>(0, 0);
+        app.postEvent(obj, std::make_unique<CallbackEvent>([&] {
+            app.postEvent(obj, std::make_unique<UpdateEvent>());
+        }));
+        app.processEvents(10);
+
+        // THEN -> not while events are pending
+        CHECK(idleRuns == 0);
+
+        // WHEN
+        app.processEvents(10);
+
+        // THEN
+        CHECK(idleRuns == 1);
+    }
+
+    SUBCASE("keep the loop from blocking while more work is pending")
+    {
+        // GIVEN
+        CoreApplication app;
+        int remainingWork = 3;
+        app.eventLoop()->addIdleHandler([&](std::chrono::steady_clock::time_point) {
+            --remainingWork;
+            return remainingWork > 0 ? IdleStatus::MoreWorkPending : IdleStatus::Done;
+        });
+
+        // WHEN
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 3; ++i)
+            app.processEvents(1000);
+
+        // THEN -> the first two iterations only polled and the last one slept
+        CHECK(remainingWork == 0);
+        CHECK(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(900));
+    }
+
+    SUBCASE("take turns within the time budget")
+    {
+        // GIVEN
+        CoreApplication app;
+        app.eventLoop()->setIdleTimeBudget(std::chrono::milliseconds(1));
+        std::vector<int> runs;
+        std::chrono::steady_clock::time_point firstDeadline;
+        for (int i = 0; i < 3; ++i) {
+            app.eventLoop()->addIdleHandler([&, i](std::chrono::steady_clock::time_point deadline) {
+                if (runs.empty())
+                    firstDeadline = deadline;
+                runs.push_back(i);
+                // Use up the budget
+                while (std::chrono::steady_clock::now() < deadline) { }
+                return IdleStatus::MoreWorkPending;
+            });
+        }
+
+        // WHEN
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < 3; ++i)
+            app.processEvents(1000);
+
+        // THEN -> one handler per iteration, each using up the budget
+        CHECK(runs == std::vector<int>{ 0, 1, 2 });
+        CHECK(firstDeadline >= start + std::chrono::milliseconds(1));
+        CHECK(std::chrono::steady_clock::now() - start < std::chrono::milliseconds(900));
+    }
+
+    SUBCASE("can be removed, also while running")
+    {
+        // GIVEN
+        CoreApplication app;
+        int runs = 0;
+        EventLoop::IdleHandlerId id = 0;
+        id = app.eventLoop()->addIdleHandler([&](std::chrono::steady_clock::time_point) {
+            ++runs;
+            CHECK(app.eventLoop()->removeIdleHandler(id));
+            return IdleStatus::MoreWorkPending;
+        });
+        const auto otherId = app.eventLoop()->addIdleHandler([&](std::chrono::steady_clock::time_point) {
+            return IdleStatus::Done;
+        });
+
+        // WHEN
+        app.processEvents(10);
+        app.processEvents(10);
+
+        // THEN
+        CHECK(runs == 1);
+        CHECK(!app.eventLoop()->removeIdleHandler(id));
+        CHECK(app.eventLoop()->removeIdleHandler(otherId));
+    }
+}
+
+namespace {
+class UpdateCountingObject : public Object
+{
+public:
+    int updates = 0;
+    std::function<void()> onUpdate;
+
+protected:
+    void event(EventReceiver *target, Event *ev) override
+    {
+        if (target == this && ev->type() == Event::Type::Update) {
+            ++updates;
+            ev->setAccepted(true);
+            if (onUpdate)
+                onUpdate();
+        }
+        Object::event(target, ev);
+    }
+};
+} // namespace
+
+TEST_CASE("Frame pacing")
+{
+    using namespace std::literals::chrono_literals;
+
+    SUBCASE("coalesces updates into one per target and frame")
+    {
+        // GIVEN
+        CoreApplication app;
+        app.eventLoop()->setFramePeriod(50ms);
+        auto first = app.createChild<UpdateCountingObject>();
+        auto second = app.createChild<UpdateCountingObject>();
+        auto other = app.createChild<EventObject>(0, 0);
+        bool otherEventDelivered = false;
+
+        // WHEN
+        for (int i = 0; i < 3; ++i) {
+            app.postEvent(first, std::make_unique<UpdateEvent>());
+            app.postEvent(second, std::make_unique<UpdateEvent>());
+        }
+        app.processEvents(0);
+
+        // THEN -> the first frame starts right away
+        CHECK(first->updates == 1);
+        CHECK(second->updates == 1);
+        CHECK(app.eventLoop()->frameCount() == 1);
+
+        // WHEN
+        app.postEvent(first, std::make_unique<UpdateEvent>());
+        app.postEvent(first, std::make_unique<UpdateEvent>());
+        app.postEvent(other, std::make_unique<CallbackEvent>([&] { otherEventDelivered = true; }));
+        app.processEvents(0);
+
+        // THEN -> other events don't wait for the next frame
+        CHECK(otherEventDelivered);
+        CHECK(first->updates == 1);
+
+        // WHEN
+        const auto start = std::chrono::steady_clock::now();
+        app.processEvents(-1);
+
+        // THEN -> the wait ends at the next frame deadline
+        CHECK(first->updates == 2);
+        CHECK(second->updates == 1);
+        CHECK(app.eventLoop()->frameCount() == 2);
+        CHECK(std::chrono::steady_clock::now() - start < 1s);
+    }
+
+    SUBCASE("delivers frames at the frame rate")
+    {
+        // GIVEN
+        CoreApplication app;
+        app.eventLoop()->setFramePeriod(10ms);
+        auto obj = app.createChild<UpdateCountingObject>();
+        obj->onUpdate = [&] {
+            app.postEvent(obj, std::make_unique<UpdateEvent>());
+        };
+        app.postEvent(obj, std::make_unique<UpdateEvent>());
+
+        // WHEN
+        const auto start = std::chrono::steady_clock::now();
+        while (obj->updates < 10)
+            app.processEvents(-1);
+
+        // THEN
+        CHECK(std::chrono::steady_clock::now() - start >= 90ms);
+        CHECK(app.eventLoop()->frameCount() == 10);
+    }
+
+    SUBCASE("reports frame overruns")
+    {
+        // GIVEN
+        CoreApplication app;
+        app.eventLoop()->setFramePeriod(10ms);
+        auto obj = app.createChild<UpdateCountingObject>();
+        obj->onUpdate = [] { std::this_thread::sleep_for(35ms); };
+        uint64_t reportedMissedFrames = 0;
+        std::ignore = app.eventLoop()->frameOverrun.connect([&](uint64_t missedFrames) {
+            reportedMissedFrames += missedFrames;
+        });
+
+        // WHEN
+        app.postEvent(obj, std::make_unique<UpdateEvent>());
+        app.processEvents(0);
+
+        // THEN
+        CHECK(reportedMissedFrames >= 3);
+        CHECK(app.eventLoop()->missedFrameCount() == reportedMissedFrames);
+
+        // WHEN
+        obj->onUpdate = {};
+        app.postEvent(obj, std::make_unique<UpdateEvent>());
+        app.processEvents(0);
+
+        // THEN -> the next frame waits for the next deadline rather than catching up
+        CHECK(obj->updates == 1);
+        app.processEvents(-1);
+        CHECK(obj->updates == 2);
+    }
+
+    SUBCASE("drops the updates of destroyed receivers")
+    {
+        // GIVEN
+        CoreApplication app;
+        app.eventLoop()->setFramePeriod(50ms);
+        auto first = app.createChild<UpdateCountingObject>();
+        auto second = app.createChild<UpdateCountingObject>();
+        app.postEvent(first, std::make_unique<UpdateEvent>());
+        app.postEvent(second, std::make_unique<UpdateEvent>());
+        app.processEvents(0);
+        app.postEvent(first, std::make_unique<UpdateEvent>());
+        app.postEvent(second, std::make_unique<UpdateEvent>());
+        app.processEvents(0);
+
+        // WHEN
+        app.removeAllEventsTargeting(*first);
+        app.processEvents(-1);
+
+        // THEN
+        CHECK(first->updates == 1);
+        CHECK(second->updates == 2);
+    }
+
+    SUBCASE("delivers the held back updates once turned off")
+    {
+        // GIVEN
+        CoreApplication app;
+        app.eventLoop()->setFramePeriod(1s);
+        auto obj = app.createChild<UpdateCountingObject>();
+        app.postEvent(obj, std::make_unique<UpdateEvent>());
+        app.processEvents(0);
+        app.postEvent(obj, std::make_unique<UpdateEvent>());
+        app.processEvents(0);
+        REQUIRE(obj->updates == 1);
+
+        // WHEN
+        app.eventLoop()->setFramePeriod(0ms);
+        app.processEvents(0);
+
+        // THEN
+        CHECK(obj->updates == 2);
+    }
+}
+
 namespace {
 /// macOS on GitHub runners is super slow and timeouts
 template<typename T>
@@ -206,6 +647,97 @@ TEST_CASE("Timer handling" * doctest::timeout(120))
         app.processEvents(adjustTimeout(100));
         REQUIRE(fired == true);
     }
+
+    SUBCASE("single-shot timer fires once")
+    {
+        using namespace std::chrono_literals;
+
+        CoreApplication app;
+        Timer timer;
+        timer.repeating = false;
+        timer.interval = adjustTimeout(20ms);
+
+        int timeout = 0;
+        std::ignore = timer.timeout.connect([&] {
+            // The timer has already stopped
+            REQUIRE(timer.running.get() == false);
+            ++timeout;
+        });
+
+        // WHEN
+        timer.running = true;
+        const auto startTime = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - startTime < adjustTimeout(200ms))
+            app.processEvents(adjustTimeout(50));
+
+        // THEN
+        REQUIRE(timeout == 1);
+        REQUIRE(timer.running.get() == false);
+
+        // WHEN -> it can be started again
+        timer.running = true;
+        while (timeout == 1)
+            app.processEvents(adjustTimeout(50));
+
+        // THEN
+        REQUIRE(timeout == 2);
+    }
+
+    SUBCASE("single shot calls back once")
+    {
+        using namespace std::chrono_literals;
+
+        CoreApplication app;
+        std::vector<int> calls;
+
+        // WHEN
+        Timer::singleShot(adjustTimeout(40ms), [&calls] { calls.push_back(2); });
+        Timer::singleShot(adjustTimeout(10ms), [&calls] {
+            calls.push_back(1);
+            // Single shots may be chained
+            Timer::singleShot(adjustTimeout(50ms), [&calls] { calls.push_back(3); });
+        });
+
+        const auto startTime = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - startTime < adjustTimeout(300ms))
+            app.processEvents(adjustTimeout(50));
+
+        // THEN
+        REQUIRE(calls == std::vector<int>{ 1, 2, 3 });
+    }
+
+    SUBCASE("timer keeps running when its type changes")
+    {
+        using namespace std::chrono_literals;
+
+        CoreApplication app;
+        Timer timer;
+        timer.interval = adjustTimeout(50ms);
+        timer.running = true;
+
+        int timeout = 0;
+        std::ignore = timer.timeout.connect([&] {
+            ++timeout;
+        });
+
+        // WHEN
+        timer.timerType = TimerType::Coarse;
+
+        // THEN
+        REQUIRE(timer.running.get());
+        const auto startTime = std::chrono::steady_clock::now();
+        while (timeout == 0 && std::chrono::steady_clock::now() - startTime < adjustTimeout(1000ms))
+            app.processEvents(adjustTimeout(100));
+        REQUIRE(timeout > 0);
+
+        // WHEN
+        timer.running = false;
+        timeout = 0;
+        app.processEvents(adjustTimeout(100));
+
+        // THEN
+        REQUIRE(timeout == 0);
+    }
 }
 
 TEST_CASE("Main event loop")
@@ -0,0 +1,390 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/coroutine.h>
+#include <KDFoundation/core_application.h>
+#include <KDFoundation/thread.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <unistd.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDFoundation;
+using namespace std::chrono_literals;
+
+static_assert(!std::is_copy_constructible<Task<int>>{});
+static_assert(std::is_move_constructible<Task<int>>{});
+
+namespace {
+Task<int> answer()
+{
+    co_return 42;
+}
+
+Task<int> sum(int count)
+{
+    int result = 0;
+    for (int i = 0; i < count; ++i)
+        result += co_await answer();
+    co_return result;
+}
+
+Task<void> fail()
+{
+    throw std::runtime_error("failed");
+    co_return;
+}
+
+void runUntilDone(CoreApplication &app, const Task<> &task)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    while (!task.isDone() && std::chrono::steady_clock::now() - startTime < 5s)
+        app.processEvents(100);
+}
+} // namespace
+
+TEST_CASE("Tasks")
+{
+    SUBCASE("are lazy and produce their value once run")
+    {
+        // GIVEN
+        auto task = sum(3);
+        REQUIRE(task.isValid());
+        REQUIRE(!task.isDone());
+
+        // WHEN
+        task.start();
+
+        // THEN
+        REQUIRE(task.isDone());
+        REQUIRE(task.result() == 126);
+    }
+
+    SUBCASE("pass exceptions on to the awaiting coroutine")
+    {
+        // GIVEN
+        std::string error;
+        // Coroutine lambdas refer to their captures through the closure, keep it alive
+        auto coroutine = [&]() -> Task<> {
+            try {
+                co_await fail();
+            } catch (const std::runtime_error &e) {
+                error = e.what();
+            }
+        };
+        auto task = coroutine();
+
+        // WHEN
+        task.start();
+
+        // THEN
+        REQUIRE(task.isDone());
+        REQUIRE(error == "failed");
+    }
+
+    SUBCASE("can be moved")
+    {
+        // GIVEN
+        auto task = answer();
+
+        // WHEN
+        Task<int> other = std::move(task);
+        other.start();
+
+        // THEN
+        REQUIRE(!task.isValid());
+        REQUIRE(other.result() == 42);
+    }
+}
+
+TEST_CASE("Awaiting the event loop")
+{
+    SUBCASE("sleeping resumes after the delay")
+    {
+        // GIVEN
+        CoreApplication app;
+        std::chrono::steady_clock::duration elapsed{};
+        auto coroutine = [&]() -> Task<> {
+            const auto startTime = std::chrono::steady_clock::now();
+            co_await sleepFor(20ms);
+            elapsed = std::chrono::steady_clock::now() - startTime;
+        };
+        auto task = coroutine();
+
+        // WHEN
+        task.start();
+        REQUIRE(!task.isDone());
+        runUntilDone(app, task);
+
+        // THEN
+        REQUIRE(task.isDone());
+        REQUIRE(elapsed >= 20ms);
+    }
+
+    SUBCASE("yielding lets posted work run first")
+    {
+        // GIVEN
+        CoreApplication app;
+        std::vector<std::string> steps;
+        auto coroutine = [&]() -> Task<> {
+            steps.push_back("before");
+            co_await yieldToEventLoop();
+            steps.push_back("after");
+        };
+        auto task = coroutine();
+
+        // WHEN
+        app.eventLoop()->postCallback([&] { steps.push_back("posted"); });
+        task.start();
+        runUntilDone(app, task);
+
+        // THEN
+        REQUIRE(steps == std::vector<std::string>{ "before", "posted", "after" });
+    }
+
+    SUBCASE("abandoning a sleeping task stops its timer")
+    {
+        // GIVEN
+        CoreApplication app;
+        bool resumed = false;
+        auto coroutine = [&]() -> Task<> {
+            co_await sleepFor(1ms);
+            resumed = true;
+        };
+        auto task = coroutine();
+        task.start();
+
+        // WHEN
+        task = {};
+        std::this_thread::sleep_for(10ms);
+        app.processEvents(10);
+        app.processEvents(10);
+
+        // THEN
+        REQUIRE(!resumed);
+        REQUIRE(app.eventQueueSize() == 0);
+    }
+
+    SUBCASE("abandoning a yielding task drops its resumption")
+    {
+        // GIVEN
+        CoreApplication app;
+        bool resumed = false;
+        auto coroutine = [&]() -> Task<> {
+            co_await yieldToEventLoop();
+            resumed = true;
+        };
+        auto task = coroutine();
+        task.start();
+        REQUIRE(app.eventQueueSize() == 1);
+
+        // WHEN
+        task = {};
+        app.processEvents(10);
+
+        // THEN
+        REQUIRE(!resumed);
+        REQUIRE(app.eventQueueSize() == 0);
+    }
+
+    SUBCASE("waiting for a file descriptor resumes once it is ready")
+    {
+        // GIVEN
+        CoreApplication app;
+        std::array<int, 2> fds;
+        REQUIRE(pipe(fds.data()) == 0);
+        char received = 0;
+        auto coroutine = [&]() -> Task<> {
+            co_await waitForReadable(fds[0]);
+            REQUIRE(read(fds[0], &received, 1) == 1);
+        };
+        auto task = coroutine();
+
+        // WHEN
+        task.start();
+        app.processEvents(10);
+
+        // THEN
+        REQUIRE(!task.isDone());
+
+        // WHEN
+        std::thread writer([fd = fds[1]] {
+            std::this_thread::sleep_for(20ms);
+            const char byte = 'x';
+            REQUIRE(write(fd, &byte, 1) == 1);
+        });
+        runUntilDone(app, task);
+        writer.join();
+
+        // THEN
+        REQUIRE(task.isDone());
+        REQUIRE(received == 'x');
+
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    SUBCASE("abandoning a task waiting for a file descriptor unregisters its notifier")
+    {
+        // GIVEN
+        CoreApplication app;
+        std::array<int, 2> fds;
+        REQUIRE(pipe(fds.data()) == 0);
+        bool resumed = false;
+        auto coroutine = [&]() -> Task<> {
+            co_await waitForReadable(fds[0]);
+            resumed = true;
+        };
+        auto task = coroutine();
+        task.start();
+
+        // WHEN
+        task = {};
+        const char byte = 'x';
+        REQUIRE(write(fds[1], &byte, 1) == 1);
+        app.processEvents(10);
+        app.processEvents(10);
+
+        // THEN
+        REQUIRE(!resumed);
+
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    SUBCASE("abandoning a task whose file descriptor is ready drops its resumption")
+    {
+        // GIVEN
+        CoreApplication app;
+        std::array<int, 2> fds;
+        REQUIRE(pipe(fds.data()) == 0);
+        bool resumed = false;
+        auto coroutine = [&]() -> Task<> {
+            co_await waitForReadable(fds[0]);
+            resumed = true;
+        };
+        auto task = coroutine();
+        const char byte = 'x';
+        REQUIRE(write(fds[1], &byte, 1) == 1);
+        task.start();
+
+        // WHEN -> notified, the resumption is posted
+        app.processEvents(10);
+
+        // THEN
+        REQUIRE(!resumed);
+        REQUIRE(app.eventQueueSize() == 1);
+
+        // WHEN
+        task = {};
+        app.processEvents(10);
+
+        // THEN
+        REQUIRE(app.eventQueueSize() == 0);
+        REQUIRE(!resumed);
+
+        close(fds[0]);
+        close(fds[1]);
+    }
+
+    SUBCASE("resuming on another event loop moves the coroutine to its thread")
+    {
+        // GIVEN
+        CoreApplication app;
+        Thread thread;
+        thread.start();
+        std::thread::id resumedOn;
+        auto coroutine = [&]() -> Task<> {
+            co_await resumeOn(thread.eventLoop());
+            resumedOn = std::this_thread::get_id();
+            co_await resumeOn(app.eventLoop());
+        };
+        auto task = coroutine();
+
+        // WHEN
+        task.start();
+        runUntilDone(app, task);
+
+        // THEN
+        REQUIRE(task.isDone());
+        REQUIRE(resumedOn == thread.id());
+    }
+
+    SUBCASE("abandoning a task waiting to resume on another event loop drops its resumption")
+    {
+        // GIVEN
+        CoreApplication app;
+        Thread thread;
+        thread.start();
+        std::atomic<bool> resumed = false;
+        auto coroutine = [&]() -> Task<> {
+            co_await resumeOn(thread.eventLoop());
+            resumed = true;
+        };
+        auto task = coroutine();
+
+        // WHEN -> the thread abandons the task before getting to its resumption
+        std::atomic<bool> blocking = false;
+        std::atomic<bool> started = false;
+        std::atomic<bool> abandoned = false;
+        thread.eventLoop()->postCallback([&] {
+            blocking = true;
+            while (!started)
+                std::this_thread::yield();
+            task = {};
+            abandoned = true;
+        },
+                                         EventQueue::Priority::High);
+        while (!blocking)
+            std::this_thread::yield();
+        task.start();
+        started = true;
+        const auto startTime = std::chrono::steady_clock::now();
+        while (!abandoned && std::chrono::steady_clock::now() - startTime < 5s)
+            std::this_thread::sleep_for(1ms);
+        std::this_thread::sleep_for(10ms);
+
+        // THEN
+        REQUIRE(abandoned);
+        REQUIRE(!resumed);
+
+        thread.quit();
+        thread.wait();
+    }
+
+    SUBCASE("detached tasks clean up after themselves")
+    {
+        // GIVEN
+        CoreApplication app;
+        bool done = false;
+        auto coroutine = [&]() -> Task<> {
+            co_await yieldToEventLoop();
+            done = true;
+        };
+        auto task = coroutine();
+
+        // WHEN
+        task.detach();
+        app.processEvents(0);
+
+        // THEN
+        REQUIRE(!task.isValid());
+        REQUIRE(done);
+    }
+}
@@ -11,6 +11,8 @@
 
 #include <KDFoundation/event.h>
 
+#include <array>
+#include <cstdint>
 #include <numeric>
 #include <string>
 
@@ -108,3 +110,44 @@ TEST_CASE("Accepting events")
         REQUIRE_FALSE(ev->isAccepted());
     }
 }
+
+TEST_CASE("Event allocation")
+{
+    SUBCASE("recycles the memory of deleted events")
+    {
+        auto ev = std::make_unique<PayloadEvent>(1, 2);
+        const void *address = ev.get();
+        ev.reset();
+
+        auto otherEv = std::make_unique<PayloadEvent>(3, 4);
+        REQUIRE(static_cast<const void *>(otherEv.get()) == address);
+        REQUIRE(otherEv->m_x == 3);
+    }
+
+    SUBCASE("can allocate large and over-aligned events")
+    {
+        class LargeEvent : public Event
+        {
+        public:
+            LargeEvent()
+                : Event(Event::Type::UserType)
+            {
+            }
+            std::array<char, 4096> m_data{};
+        };
+
+        class alignas(64) AlignedEvent : public Event
+        {
+        public:
+            AlignedEvent()
+                : Event(Event::Type::UserType)
+            {
+            }
+        };
+
+        auto largeEv = std::make_unique<LargeEvent>();
+        REQUIRE(largeEv->m_data.back() == 0);
+        auto alignedEv = std::make_unique<AlignedEvent>();
+        REQUIRE(reinterpret_cast<std::uintptr_t>(alignedEv.get()) % 64 == 0);
+    }
+}
@@ -13,8 +13,10 @@
 #include <KDFoundation/event_queue.h>
 #include <KDFoundation/object.h>
 
+#include <algorithm>
 #include <numeric>
 #include <string>
+#include <thread>
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include <doctest.h>
@@ -195,3 +197,387 @@ TEST_CASE("Single-threaded use")
         REQUIRE(eventQueue.isEmpty());
     }
 }
+
+TEST_CASE("Lock-free backend")
+{
+    SUBCASE("uses the requested backend")
+    {
+        EventQueue lockingQueue(EventQueue::Backend::Locking);
+        EventQueue lockFreeQueue(EventQueue::Backend::LockFree);
+
+        REQUIRE(lockingQueue.backend() == EventQueue::Backend::Locking);
+        REQUIRE(lockFreeQueue.backend() == EventQueue::Backend::LockFree);
+    }
+
+    SUBCASE("can push multiple events and then pop them in the correct order")
+    {
+        EventQueue eventQueue(EventQueue::Backend::LockFree);
+        std::vector<PayloadEvent *> events;
+        std::vector<std::unique_ptr<Object>> targets;
+        const int n = 10;
+
+        populateEventQueueWithNEvents(eventQueue, n, events, targets);
+
+        REQUIRE(eventQueue.size() == n);
+        REQUIRE(eventQueue.peek()->wrappedEvent() == events.front());
+        for (int i = 0; i < n; ++i) {
+            auto postedEvent = eventQueue.tryPop();
+            REQUIRE(postedEvent != std::unique_ptr<PostedEvent>());
+            REQUIRE(eventQueue.size() == n - i - 1);
+            REQUIRE(postedEvent->target() == targets[i].get());
+            REQUIRE(postedEvent->wrappedEvent() == events[i]);
+        }
+
+        REQUIRE(eventQueue.isEmpty());
+        REQUIRE(eventQueue.tryPop() == std::unique_ptr<PostedEvent>());
+    }
+
+    SUBCASE("can remove events targeting a receiver")
+    {
+        EventQueue eventQueue(EventQueue::Backend::LockFree);
+        std::vector<PayloadEvent *> events;
+        std::vector<std::unique_ptr<Object>> targets;
+        int n = 10;
+
+        populateEventQueueWithNEvents(eventQueue, n, events, targets);
+
+        eventQueue.removeAllEventsTargeting(*targets.front());
+        eventQueue.removeAllEventsTargeting(*targets.back());
+        REQUIRE(eventQueue.size() == (n - 2));
+
+        events.erase(events.begin());
+        targets.erase(targets.begin());
+        events.erase(events.end() - 1);
+        targets.erase(targets.end() - 1);
+
+        n -= 2;
+        for (int i = 0; i < n; ++i) {
+            auto postedEvent = eventQueue.tryPop();
+            REQUIRE(postedEvent->target() == targets[i].get());
+            REQUIRE(postedEvent->wrappedEvent() == events[i]);
+        }
+        REQUIRE(eventQueue.isEmpty());
+    }
+
+    SUBCASE("keeps the order of each producer and loses no event")
+    {
+        EventQueue eventQueue(EventQueue::Backend::LockFree);
+        const int producerCount = 4;
+        const int eventsPerProducer = 10000;
+        std::vector<std::unique_ptr<Object>> targets;
+        for (int i = 0; i < producerCount; ++i)
+            targets.push_back(std::make_unique<Object>());
+
+        std::vector<std::thread> producers;
+        for (int p = 0; p < producerCount; ++p) {
+            producers.emplace_back([&eventQueue, target = targets[p].get()] {
+                for (int i = 0; i < eventsPerProducer; ++i)
+                    eventQueue.push(target, std::make_unique<PayloadEvent>(i, 0));
+            });
+        }
+
+        std::vector<int> nextExpected(producerCount, 0);
+        int received = 0;
+        while (received < producerCount * eventsPerProducer) {
+            auto postedEvent = eventQueue.tryPop();
+            if (!postedEvent)
+                continue;
+            const auto producer = std::distance(targets.begin(),
+                                                std::find_if(targets.begin(), targets.end(), [&postedEvent](const auto &target) {
+                                                    return target.get() == postedEvent->target();
+                                                }));
+            REQUIRE(producer < producerCount);
+            const auto payload = static_cast<PayloadEvent *>(postedEvent->wrappedEvent());
+            REQUIRE(payload->m_x == nextExpected[producer]);
+            ++nextExpected[producer];
+            ++received;
+        }
+
+        for (auto &producer : producers)
+            producer.join();
+
+        REQUIRE(eventQueue.isEmpty());
+    }
+}
+
+TEST_CASE("Taking all events at once")
+{
+    for (const auto backend : { EventQueue::Backend::Locking, EventQueue::Backend::LockFree }) {
+        EventQueue eventQueue(backend);
+        std::vector<PayloadEvent *> events;
+        std::vector<std::unique_ptr<Object>> targets;
+        const int n = 10;
+
+        populateEventQueueWithNEvents(eventQueue, n, events, targets);
+
+        // WHEN
+        EventQueue::EventList batch;
+        eventQueue.takeAll(batch);
+
+        // THEN
+        REQUIRE(eventQueue.isEmpty());
+        REQUIRE(batch.size() == n);
+        for (int i = 0; i < n; ++i) {
+            REQUIRE(batch[i].target() == targets[i].get());
+            REQUIRE(batch[i].wrappedEvent() == events[i]);
+        }
+
+        // WHEN -> events are appended to a non-empty batch
+        auto lateTarget = std::make_unique<Object>();
+        eventQueue.push(lateTarget.get(), std::make_unique<MyEvent>());
+        eventQueue.takeAll(batch);
+
+        // THEN
+        REQUIRE(eventQueue.isEmpty());
+        REQUIRE(batch.size() == n + 1);
+        REQUIRE(batch.front().wrappedEvent() == events.front());
+        REQUIRE(batch.back().target() == lateTarget.get());
+
+        // WHEN -> nothing is pending
+        eventQueue.takeAll(batch);
+
+        // THEN
+        REQUIRE(batch.size() == n + 1);
+    }
+}
+
+TEST_CASE("Pushing a batch of events")
+{
+    for (const auto backend : { EventQueue::Backend::Locking, EventQueue::Backend::LockFree }) {
+        EventQueue eventQueue(backend);
+        auto firstTarget = std::make_unique<Object>();
+        eventQueue.push(firstTarget.get(), std::make_unique<MyEvent>());
+
+        std::vector<std::unique_ptr<Object>> targets;
+        std::vector<Event *> events;
+        std::vector<EventQueue::TargetedEvent> batch;
+        const int n = 10;
+        for (int i = 0; i < n; ++i) {
+            targets.push_back(std::make_unique<Object>());
+            auto ev = std::make_unique<PayloadEvent>(i, 0);
+            events.push_back(ev.get());
+            batch.emplace_back(targets.back().get(), std::move(ev));
+        }
+
+        // WHEN
+        eventQueue.push(std::move(batch));
+
+        // THEN
+        REQUIRE(batch.empty());
+        REQUIRE(eventQueue.size() == n + 1);
+        REQUIRE(eventQueue.tryPop()->target() == firstTarget.get());
+        for (int i = 0; i < n; ++i) {
+            auto postedEvent = eventQueue.tryPop();
+            REQUIRE(postedEvent->target() == targets[i].get());
+            REQUIRE(postedEvent->wrappedEvent() == events[i]);
+        }
+        REQUIRE(eventQueue.isEmpty());
+
+        // WHEN -> an empty batch is pushed
+        eventQueue.push(std::vector<EventQueue::TargetedEvent>{});
+
+        // THEN
+        REQUIRE(eventQueue.isEmpty());
+    }
+}
+
+TEST_CASE("Priorities")
+{
+    for (const auto backend : { EventQueue::Backend::Locking, EventQueue::Backend::LockFree }) {
+        EventQueue eventQueue(backend);
+        auto target = std::make_unique<Object>();
+
+        // WHEN
+        eventQueue.push(target.get(), std::make_unique<PayloadEvent>(0, 0), EventQueue::Priority::Idle);
+        eventQueue.push(target.get(), std::make_unique<PayloadEvent>(1, 0), EventQueue::Priority::Low);
+        eventQueue.push(target.get(), std::make_unique<PayloadEvent>(2, 0));
+        eventQueue.push(target.get(), std::make_unique<PayloadEvent>(3, 0), EventQueue::Priority::High);
+        eventQueue.push(target.get(), std::make_unique<PayloadEvent>(4, 0));
+
+        // THEN
+        REQUIRE(eventQueue.size() == 5);
+        REQUIRE(eventQueue.size(EventQueue::Priority::High) == 1);
+        REQUIRE(eventQueue.size(EventQueue::Priority::Normal) == 2);
+        REQUIRE(eventQueue.size(EventQueue::Priority::Low) == 1);
+        REQUIRE(eventQueue.size(EventQueue::Priority::Idle) == 1);
+        REQUIRE(static_cast<PayloadEvent *>(eventQueue.peek()->wrappedEvent())->m_x == 3);
+
+        // WHEN -> a single lane is taken
+        EventQueue::EventList normalEvents;
+        eventQueue.takeAll(EventQueue::Priority::Normal, normalEvents);
+
+        // THEN
+        REQUIRE(normalEvents.size() == 2);
+        REQUIRE(static_cast<PayloadEvent *>(normalEvents[0].wrappedEvent())->m_x == 2);
+        REQUIRE(static_cast<PayloadEvent *>(normalEvents[1].wrappedEvent())->m_x == 4);
+        REQUIRE(eventQueue.size() == 3);
+        REQUIRE(eventQueue.size(EventQueue::Priority::Normal) == 0);
+
+        // WHEN -> the remaining events are popped
+        std::vector<int> order;
+        while (auto postedEvent = eventQueue.tryPop())
+            order.push_back(static_cast<PayloadEvent *>(postedEvent->wrappedEvent())->m_x);
+
+        // THEN -> highest priority first
+        REQUIRE(order == std::vector<int>{ 3, 1, 0 });
+        REQUIRE(eventQueue.isEmpty());
+        REQUIRE(eventQueue.size(EventQueue::Priority::Idle) == 0);
+    }
+}
+
+TEST_CASE("Coalescing")
+{
+    for (const auto backend : { EventQueue::Backend::Locking, EventQueue::Backend::LockFree }) {
+        EventQueue eventQueue(backend);
+        auto target1 = std::make_unique<Object>();
+        auto target2 = std::make_unique<Object>();
+
+        SUBCASE("is disabled by default")
+        {
+            REQUIRE_FALSE(eventQueue.isCoalescingEnabled());
+            eventQueue.push(target1.get(), std::make_unique<UpdateEvent>());
+            eventQueue.push(target1.get(), std::make_unique<UpdateEvent>());
+            REQUIRE(eventQueue.size() == 2);
+        }
+
+        SUBCASE("merges events of the same type for the same target")
+        {
+            eventQueue.setCoalescingEnabled(true);
+            REQUIRE(eventQueue.isCoalescingEnabled());
+
+            // WHEN
+            auto firstResize = std::make_unique<ResizeEvent>(10, 20);
+            Event *firstResizePtr = firstResize.get();
+            eventQueue.push(target1.get(), std::move(firstResize));
+            eventQueue.push(target1.get(), std::make_unique<UpdateEvent>());
+            eventQueue.push(target2.get(), std::make_unique<UpdateEvent>());
+            eventQueue.push(target1.get(), std::make_unique<ResizeEvent>(30, 40));
+            eventQueue.push(target1.get(), std::make_unique<UpdateEvent>());
+            eventQueue.push(target1.get(), std::make_unique<UpdateEvent>(), EventQueue::Priority::Low);
+
+            // THEN
+            EventQueue::EventList events;
+            eventQueue.takeAll(events);
+            REQUIRE(events.size() == 4);
+            REQUIRE(eventQueue.isEmpty());
+
+            // The waiting resize event keeps its place and takes the latest size
+            REQUIRE(events[0].wrappedEvent() == firstResizePtr);
+            REQUIRE(static_cast<ResizeEvent *>(events[0].wrappedEvent())->width() == 30);
+            REQUIRE(static_cast<ResizeEvent *>(events[0].wrappedEvent())->height() == 40);
+            REQUIRE(events[1].target() == target1.get());
+            REQUIRE(events[1].wrappedEvent()->type() == Event::Type::Update);
+            REQUIRE(events[2].target() == target2.get());
+            REQUIRE(events[3].target() == target1.get());
+            REQUIRE(events[3].wrappedEvent()->type() == Event::Type::Update);
+        }
+
+        SUBCASE("queues events that can't be merged separately")
+        {
+            eventQueue.setCoalescingEnabled(true);
+            eventQueue.push(target1.get(), std::make_unique<MyEvent>());
+            eventQueue.push(target1.get(), std::make_unique<MyEvent>());
+            REQUIRE(eventQueue.size() == 2);
+        }
+
+        SUBCASE("doesn't merge into events that were taken out of the queue")
+        {
+            eventQueue.setCoalescingEnabled(true);
+            eventQueue.push(target1.get(), std::make_unique<UpdateEvent>());
+            auto postedEvent = eventQueue.tryPop();
+            REQUIRE(postedEvent);
+
+            eventQueue.push(target1.get(), std::make_unique<UpdateEvent>());
+            REQUIRE(eventQueue.size() == 1);
+
+            eventQueue.removeAllEventsTargeting(*target1);
+            eventQueue.push(target1.get(), std::make_unique<UpdateEvent>());
+            REQUIRE(eventQueue.size() == 1);
+        }
+    }
+}
+
+TEST_CASE("Removing events of a receiver")
+{
+    for (const auto backend : { EventQueue::Backend::Locking, EventQueue::Backend::LockFree }) {
+        EventQueue eventQueue(backend);
+        auto target1 = std::make_unique<Object>();
+        auto target2 = std::make_unique<Object>();
+
+        SUBCASE("skips removed events while keeping the order of the others")
+        {
+            for (int i = 0; i < 6; ++i)
+                eventQueue.push(i % 2 ? target2.get() : target1.get(), std::make_unique<PayloadEvent>(i, 0));
+            eventQueue.push(target1.get(), std::make_unique<PayloadEvent>(6, 0), EventQueue::Priority::Low);
+
+            // WHEN
+            eventQueue.removeAllEventsTargeting(*target1);
+
+            // THEN
+            REQUIRE(eventQueue.size() == 3);
+            REQUIRE(eventQueue.size(EventQueue::Priority::Normal) == 3);
+            REQUIRE(eventQueue.size(EventQueue::Priority::Low) == 0);
+            REQUIRE(static_cast<PayloadEvent *>(eventQueue.peek()->wrappedEvent())->m_x == 1);
+
+            std::vector<int> remaining;
+            while (auto postedEvent = eventQueue.tryPop()) {
+                REQUIRE(postedEvent->target() == target2.get());
+                remaining.push_back(static_cast<PayloadEvent *>(postedEvent->wrappedEvent())->m_x);
+            }
+            REQUIRE(remaining == std::vector<int>{ 1, 3, 5 });
+            REQUIRE(eventQueue.isEmpty());
+        }
+
+        SUBCASE("keeps events posted to the same address after the removal")
+        {
+            eventQueue.push(target1.get(), std::make_unique<PayloadEvent>(0, 0));
+            eventQueue.push(target2.get(), std::make_unique<PayloadEvent>(1, 0));
+            eventQueue.removeAllEventsTargeting(*target1);
+
+            // WHEN -> e.g. a new receiver got allocated at the same address
+            eventQueue.push(target1.get(), std::make_unique<PayloadEvent>(2, 0));
+
+            // THEN
+            REQUIRE(eventQueue.size() == 2);
+            EventQueue::EventList events;
+            eventQueue.takeAll(events);
+            REQUIRE(events.size() == 2);
+            REQUIRE(static_cast<PayloadEvent *>(events[0].wrappedEvent())->m_x == 1);
+            REQUIRE(static_cast<PayloadEvent *>(events[1].wrappedEvent())->m_x == 2);
+
+            // WHEN -> removed again
+            eventQueue.push(target1.get(), std::make_unique<PayloadEvent>(3, 0));
+            eventQueue.push(target2.get(), std::make_unique<PayloadEvent>(4, 0));
+            eventQueue.removeAllEventsTargeting(*target1);
+            eventQueue.push(target1.get(), std::make_unique<PayloadEvent>(5, 0));
+            eventQueue.removeAllEventsTargeting(*target1);
+
+            // THEN
+            REQUIRE(eventQueue.size() == 1);
+            REQUIRE(eventQueue.tryPop()->target() == target2.get());
+            REQUIRE(eventQueue.tryPop() == std::unique_ptr<PostedEvent>());
+        }
+
+        SUBCASE("handles many receivers")
+        {
+            const int n = 1000;
+            std::vector<std::unique_ptr<Object>> targets;
+            for (int i = 0; i < n; ++i) {
+                targets.push_back(std::make_unique<Object>());
+                eventQueue.push(targets.back().get(), std::make_unique<PayloadEvent>(i, 0));
+            }
+
+            // WHEN
+            for (int i = 0; i < n; i += 2)
+                eventQueue.removeAllEventsTargeting(*targets[i]);
+
+            // THEN
+            REQUIRE(eventQueue.size() == n / 2);
+            EventQueue::EventList events;
+            eventQueue.takeAll(events);
+            REQUIRE(events.size() == n / 2);
+            for (int i = 0; i < n / 2; ++i)
+                REQUIRE(events[i].target() == targets[2 * i + 1].get());
+        }
+    }
+}
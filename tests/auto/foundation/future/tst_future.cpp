@@ -0,0 +1,342 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/future.h>
+#include <KDFoundation/core_application.h>
+#include <KDFoundation/thread.h>
+
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDFoundation;
+using namespace std::chrono_literals;
+
+static_assert(!std::is_copy_constructible<Future<int>>{});
+static_assert(std::is_move_constructible<Future<int>>{});
+static_assert(std::is_copy_constructible<Promise<int>>{});
+
+namespace {
+template<typename T>
+void processUntilFinished(CoreApplication &app, const Future<T> &future)
+{
+    const auto startTime = std::chrono::steady_clock::now();
+    while (!future.isFinished() && std::chrono::steady_clock::now() - startTime < 5s)
+        app.processEvents(100);
+}
+} // namespace
+
+TEST_CASE("Promises")
+{
+    SUBCASE("make their future ready")
+    {
+        // GIVEN
+        Promise<std::string> promise;
+        auto future = promise.future();
+        REQUIRE(future.isValid());
+        REQUIRE(!future.isFinished());
+
+        // WHEN
+        promise.setValue("done");
+
+        // THEN
+        REQUIRE(future.isReady());
+        REQUIRE(future.result() == "done");
+    }
+
+    SUBCASE("keep the first value set")
+    {
+        // GIVEN
+        Promise<int> promise;
+        Promise<int> copy = promise;
+        auto future = promise.future();
+
+        // WHEN
+        copy.setValue(1);
+        promise.setValue(2);
+
+        // THEN
+        REQUIRE(future.result() == 1);
+    }
+
+    SUBCASE("cancel their future once all of them are gone")
+    {
+        // GIVEN
+        Future<int> future;
+        {
+            Promise<int> promise;
+            future = promise.future();
+            Promise<int> copy = promise;
+        }
+
+        // THEN
+        REQUIRE(future.isCanceled());
+    }
+}
+
+TEST_CASE("Continuations")
+{
+    SUBCASE("are called on the event loop, not right away")
+    {
+        // GIVEN
+        CoreApplication app;
+        int result = 0;
+        auto ready = makeReadyFuture(21);
+
+        // WHEN
+        auto future = std::move(ready).then([&](int value) {
+            result = value;
+            return value * 2;
+        });
+
+        // THEN
+        REQUIRE(!ready.isValid());
+        REQUIRE(result == 0);
+        REQUIRE(!future.isFinished());
+
+        // WHEN
+        app.processEvents();
+
+        // THEN
+        REQUIRE(result == 21);
+        REQUIRE(future.result() == 42);
+    }
+
+    SUBCASE("can be chained, waiting for the futures they return")
+    {
+        // GIVEN
+        CoreApplication app;
+        Promise<int> first;
+        Promise<std::string> second;
+        std::vector<std::string> steps;
+
+        // WHEN
+        auto future = first.future()
+                              .then([&](int value) {
+                                  steps.push_back("first " + std::to_string(value));
+                                  return second.future();
+                              })
+                              .then([&](std::string &&value) {
+                                  steps.push_back("second " + value);
+                              });
+        first.setValue(1);
+        app.processEvents();
+
+        // THEN
+        REQUIRE(steps == std::vector<std::string>{ "first 1" });
+        REQUIRE(!future.isFinished());
+
+        // WHEN
+        second.setValue("done");
+        processUntilFinished(app, future);
+
+        // THEN
+        REQUIRE(future.isReady());
+        REQUIRE(steps == std::vector<std::string>{ "first 1", "second done" });
+    }
+
+    SUBCASE("are skipped for canceled futures")
+    {
+        // GIVEN
+        CoreApplication app;
+        bool called = false;
+        auto promise = std::make_unique<Promise<void>>();
+        auto future = promise->future().then([&] { called = true; }).then([&] { called = true; });
+
+        // WHEN
+        promise.reset();
+        app.processEvents();
+        app.processEvents();
+
+        // THEN
+        REQUIRE(future.isCanceled());
+        REQUIRE(!called);
+    }
+
+    SUBCASE("run on the event loop they are given")
+    {
+        // GIVEN
+        CoreApplication app;
+        Thread thread;
+        thread.start();
+        Promise<void> promise;
+
+        // WHEN
+        auto future = promise.future()
+                              .then(thread.eventLoop(), [] { return std::this_thread::get_id(); })
+                              .then([](std::thread::id id) { return id; });
+        promise.setValue();
+        processUntilFinished(app, future);
+
+        // THEN
+        REQUIRE(future.isReady());
+        REQUIRE(future.result() == thread.id());
+    }
+
+    SUBCASE("cancel their future if their event loop is gone")
+    {
+        // GIVEN
+        CoreApplication app;
+        Promise<void> promise;
+        Future<void> future;
+        {
+            Thread thread;
+            thread.start();
+            future = promise.future().then(thread.eventLoop(), [] {});
+        }
+
+        // WHEN
+        promise.setValue();
+
+        // THEN
+        REQUIRE(future.isCanceled());
+    }
+}
+
+TEST_CASE("Combinators")
+{
+    SUBCASE("whenAll collects all values in order")
+    {
+        // GIVEN
+        CoreApplication app;
+        std::vector<Promise<int>> promises(3);
+        std::vector<Future<int>> futures;
+        for (auto &promise : promises)
+            futures.push_back(promise.future());
+
+        // WHEN
+        auto all = whenAll(std::move(futures));
+        promises[2].setValue(3);
+        promises[0].setValue(1);
+
+        // THEN
+        REQUIRE(!all.isFinished());
+
+        // WHEN
+        promises[1].setValue(2);
+
+        // THEN
+        REQUIRE(all.isReady());
+        REQUIRE(all.result() == std::vector<int>{ 1, 2, 3 });
+    }
+
+    SUBCASE("whenAll is canceled along with any of the futures")
+    {
+        // GIVEN
+        Promise<void> promise;
+        std::vector<Future<void>> futures;
+        futures.push_back(makeReadyFuture());
+        futures.push_back(promise.future());
+
+        // WHEN
+        auto all = whenAll(std::move(futures));
+        promise.cancel();
+
+        // THEN
+        REQUIRE(all.isCanceled());
+    }
+
+    SUBCASE("whenAll of nothing is ready right away")
+    {
+        REQUIRE(whenAll(std::vector<Future<int>>{}).isReady());
+    }
+
+    SUBCASE("whenAny passes on the first value")
+    {
+        // GIVEN
+        std::vector<Promise<std::string>> promises(3);
+        std::vector<Future<std::string>> futures;
+        for (auto &promise : promises)
+            futures.push_back(promise.future());
+
+        // WHEN
+        auto any = whenAny(std::move(futures));
+        promises[0].cancel();
+        promises[2].setValue("two");
+        promises[1].setValue("one");
+
+        // THEN
+        REQUIRE(any.isReady());
+        REQUIRE(any.result().first == 2);
+        REQUIRE(any.result().second == "two");
+    }
+
+    SUBCASE("whenAny is canceled if all of the futures are")
+    {
+        // GIVEN
+        std::vector<Promise<void>> promises(2);
+        std::vector<Future<void>> futures;
+        for (auto &promise : promises)
+            futures.push_back(promise.future());
+
+        // WHEN
+        auto any = whenAny(std::move(futures));
+        promises.clear();
+
+        // THEN
+        REQUIRE(any.isCanceled());
+        REQUIRE(whenAny(std::vector<Future<int>>{}).isCanceled());
+    }
+}
+
+TEST_CASE("Timeouts")
+{
+    SUBCASE("delay is ready after the given time")
+    {
+        // GIVEN
+        CoreApplication app;
+        const auto startTime = std::chrono::steady_clock::now();
+
+        // WHEN
+        auto future = delay(20ms);
+        processUntilFinished(app, future);
+
+        // THEN
+        REQUIRE(future.isReady());
+        REQUIRE(std::chrono::steady_clock::now() - startTime >= 20ms);
+    }
+
+    SUBCASE("withTimeout passes on values arriving in time")
+    {
+        // GIVEN
+        CoreApplication app;
+        Promise<int> promise;
+
+        // WHEN
+        auto future = withTimeout(promise.future(), 5s);
+        promise.setValue(42);
+
+        // THEN
+        REQUIRE(future.isReady());
+        REQUIRE(future.result() == std::optional<int>(42));
+    }
+
+    SUBCASE("withTimeout gives up after the timeout")
+    {
+        // GIVEN
+        CoreApplication app;
+        Promise<void> promise;
+
+        // WHEN
+        auto future = withTimeout(promise.future(), 20ms);
+        processUntilFinished(app, future);
+        promise.setValue();
+
+        // THEN
+        REQUIRE(future.isReady());
+        REQUIRE(future.result() == false);
+    }
+}
@@ -0,0 +1,134 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/latency_histogram.h>
+#include <KDFoundation/config.h>
+#include <KDFoundation/core_application.h>
+#include <KDFoundation/event_loop.h>
+#include <KDFoundation/platform/abstract_platform_event_loop.h>
+
+#include <algorithm>
+#include <chrono>
+#include <initializer_list>
+#include <thread>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDFoundation;
+using namespace std::chrono_literals;
+
+TEST_CASE("Latency histograms")
+{
+    SUBCASE("map values to buckets of bounded relative width")
+    {
+        for (const uint64_t value : std::initializer_list<uint64_t>{ 0, 1, 31, 32, 33, 1000, 123456789, LatencyHistogram::MaxValue }) {
+            const size_t bucket = LatencyHistogram::bucketIndex(value);
+            REQUIRE(bucket < LatencyHistogram::BucketCount);
+            REQUIRE(LatencyHistogram::bucketLowerBound(bucket) <= value);
+            REQUIRE(LatencyHistogram::bucketUpperBound(bucket) >= value);
+            const uint64_t width = LatencyHistogram::bucketUpperBound(bucket) - LatencyHistogram::bucketLowerBound(bucket) + 1;
+            REQUIRE(width * (LatencyHistogram::SubBucketCount / 2) <= std::max<uint64_t>(value, LatencyHistogram::SubBucketCount));
+        }
+        REQUIRE(LatencyHistogram::bucketIndex(LatencyHistogram::MaxValue) == LatencyHistogram::BucketCount - 1);
+        REQUIRE(LatencyHistogram::bucketIndex(UINT64_MAX) == LatencyHistogram::BucketCount - 1);
+    }
+
+    SUBCASE("buckets are contiguous")
+    {
+        for (size_t bucket = 1; bucket < LatencyHistogram::BucketCount; ++bucket)
+            REQUIRE(LatencyHistogram::bucketLowerBound(bucket) == LatencyHistogram::bucketUpperBound(bucket - 1) + 1);
+    }
+
+    SUBCASE("summarize the recorded values")
+    {
+        // GIVEN
+        LatencyHistogram histogram;
+        REQUIRE(histogram.count() == 0);
+        REQUIRE(histogram.valueAtPercentile(50) == 0);
+
+        // WHEN
+        for (uint64_t value = 1; value <= 1000; ++value)
+            histogram.record(value);
+
+        // THEN
+        REQUIRE(histogram.count() == 1000);
+        REQUIRE(histogram.min() == 1);
+        REQUIRE(histogram.max() == 1000);
+        REQUIRE(histogram.mean() == doctest::Approx(500.5));
+        REQUIRE(histogram.valueAtPercentile(0) == 1);
+        REQUIRE(histogram.valueAtPercentile(100) == 1000);
+        const uint64_t median = histogram.valueAtPercentile(50);
+        REQUIRE(median >= 500);
+        REQUIRE(median <= 500 + 500 / 16);
+        const uint64_t p99 = histogram.valueAtPercentile(99);
+        REQUIRE(p99 >= 990);
+        REQUIRE(p99 <= 1000);
+
+        // WHEN
+        histogram.reset();
+
+        // THEN
+        REQUIRE(histogram.count() == 0);
+        REQUIRE(histogram.min() == 0);
+        REQUIRE(histogram.max() == 0);
+    }
+
+    SUBCASE("record durations in nanoseconds")
+    {
+        // GIVEN
+        LatencyHistogram histogram;
+
+        // WHEN
+        histogram.record(2ms);
+        histogram.record(-1ms);
+
+        // THEN
+        REQUIRE(histogram.count() == 2);
+        REQUIRE(histogram.min() == 0);
+        REQUIRE(histogram.max() == 2000000);
+    }
+}
+
+#if KDFOUNDATION_INSTRUMENTATION
+TEST_CASE("Event loop statistics")
+{
+    // GIVEN
+    CoreApplication app;
+    EventLoop *loop = app.eventLoop();
+    loop->resetStatistics();
+    const auto &statistics = loop->statistics();
+
+    // WHEN
+    loop->postCallback([] { std::this_thread::sleep_for(5ms); });
+    loop->postCallback([] {});
+    app.processEvents(20);
+
+    // THEN
+    REQUIRE(statistics.iterationTime.count() == 1);
+    REQUIRE(statistics.iterationTime.min() >= 5000000);
+    REQUIRE(statistics.queueDepth.max() == 2);
+    REQUIRE(statistics.deliveryLatency.count() == 2);
+    // The second callback waited for the first one
+    REQUIRE(statistics.deliveryLatency.max() >= 5000000);
+    REQUIRE(statistics.handlerTime(Event::Type::Invoke).count() == 2);
+    REQUIRE(statistics.handlerTime(Event::Type::Invoke).max() >= 5000000);
+    REQUIRE(statistics.handlerTime(Event::Type::UserType).count() == 0);
+    REQUIRE(loop->platformEventLoop()->waitTime().count() == 1);
+
+    // WHEN
+    loop->resetStatistics();
+
+    // THEN
+    REQUIRE(statistics.iterationTime.count() == 0);
+    REQUIRE(statistics.handlerTime(Event::Type::Invoke).count() == 0);
+    REQUIRE(loop->platformEventLoop()->waitTime().count() == 0);
+}
+#endif
@@ -10,16 +10,23 @@
 */
 
 #include <KDFoundation/platform/linux/linux_platform_event_loop.h>
+#include <KDFoundation/event_loop.h>
 #include <KDFoundation/file_descriptor_notifier.h>
 #include <KDFoundation/object.h>
 #include <KDFoundation/postman.h>
+#include <KDFoundation/timer.h>
 
 #include <KDUtils/logging.h>
 
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
+#include <cstdio>
+#include <fstream>
+#include <functional>
 #include <mutex>
 #include <numeric>
+#include <optional>
 #include <string>
 #include <thread>
 #include <tuple>
@@ -36,6 +43,23 @@ static_assert(!std::is_copy_assignable<LinuxPlatformEventLoop>{});
 static_assert(!std::is_move_constructible<LinuxPlatformEventLoop>{});
 static_assert(!std::is_move_assignable<LinuxPlatformEventLoop>{});
 
+namespace {
+// The events fd is registered for in the epoll instance epollHandle, as reported by the
+// kernel, or nothing if it isn't registered
+std::optional<uint32_t> epollRegistration(int epollHandle, int fd)
+{
+    std::ifstream fdInfo("/proc/self/fdinfo/" + std::to_string(epollHandle));
+    std::string line;
+    while (std::getline(fdInfo, line)) {
+        int registeredFd = -1;
+        unsigned int events = 0;
+        if (std::sscanf(line.c_str(), "tfd: %d events: %x", &registeredFd, &events) == 2 && registeredFd == fd)
+            return events;
+    }
+    return std::nullopt;
+}
+} // namespace
+
 TEST_CASE("Register and unregister for events")
 {
     spdlog::set_level(spdlog::level::debug);
@@ -377,6 +401,33 @@ TEST_CASE("Wait for events")
         // Be nice!
         t1.join();
     }
+
+    SUBCASE("coalesces wake-ups until the loop woke up")
+    {
+        LinuxPlatformEventLoop loop;
+
+        // WHEN
+        loop.wakeUp();
+        loop.wakeUp();
+        loop.wakeUp();
+
+        auto startTime = std::chrono::steady_clock::now();
+        loop.waitForEvents(10000);
+        auto elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+
+        // THEN
+        REQUIRE(elapsedTime < 10000);
+
+        // WHEN -> the pending wake-up was consumed, so a new one must kick the loop again
+        loop.wakeUp();
+
+        startTime = std::chrono::steady_clock::now();
+        loop.waitForEvents(10000);
+        elapsedTime = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+
+        // THEN
+        REQUIRE(elapsedTime < 10000);
+    }
 }
 
 TEST_CASE("Notifies about events")
@@ -441,3 +492,447 @@ TEST_CASE("Notifies about events")
         t1.join();
     }
 }
+
+TEST_CASE("Timer wheel")
+{
+    using namespace std::chrono_literals;
+
+    auto platformLoop = std::make_unique<LinuxPlatformEventLoop>();
+    LinuxPlatformEventLoop *linuxLoop = platformLoop.get();
+    linuxLoop->setTimerBackend(LinuxPlatformEventLoop::TimerBackend::TimerWheel);
+    EventLoop loop(std::move(platformLoop));
+
+    SUBCASE("timers share a single file descriptor")
+    {
+        // GIVEN
+        const size_t timerCount = 1000;
+        std::vector<std::unique_ptr<Timer>> timers;
+        std::vector<int> timeouts(timerCount, 0);
+        for (size_t i = 0; i < timerCount; ++i) {
+            auto timer = std::make_unique<Timer>();
+            timer->interval = std::chrono::milliseconds(10 + i % 50);
+            std::ignore = timer->timeout.connect([&timeouts, i]() { ++timeouts[i]; });
+            timers.push_back(std::move(timer));
+        }
+
+        // WHEN
+        for (auto &timer : timers)
+            timer->running = true;
+
+        // THEN
+        REQUIRE(linuxLoop->registeredFileDescriptorCount() == 0);
+        REQUIRE(linuxLoop->timerWheel()->timerCount() == timerCount);
+
+        // WHEN
+        const auto startTime = std::chrono::steady_clock::now();
+        while (std::chrono::steady_clock::now() - startTime < 200ms)
+            loop.processEvents(10);
+
+        // THEN
+        for (const int timeout : timeouts) {
+            REQUIRE(timeout > 0);
+            REQUIRE(timeout <= 20);
+        }
+
+        // WHEN
+        for (auto &timer : timers)
+            timer->running = false;
+
+        // THEN
+        REQUIRE(linuxLoop->timerWheel()->timerCount() == 0);
+    }
+
+    SUBCASE("timers fire in order of their intervals")
+    {
+        // GIVEN
+        std::vector<int> fired;
+        std::vector<std::unique_ptr<Timer>> timers;
+        for (const int interval : { 60, 20, 40 }) {
+            auto timer = std::make_unique<Timer>();
+            timer->interval = std::chrono::milliseconds(interval);
+            std::ignore = timer->timeout.connect([&fired, interval, t = timer.get()]() {
+                fired.push_back(interval);
+                t->running = false;
+            });
+            timers.push_back(std::move(timer));
+        }
+
+        // WHEN
+        const auto startTime = std::chrono::steady_clock::now();
+        for (auto &timer : timers)
+            timer->running = true;
+        while (fired.size() < timers.size())
+            loop.processEvents(100);
+        const auto elapsedTime = std::chrono::steady_clock::now() - startTime;
+
+        // THEN
+        REQUIRE(fired == std::vector<int>{ 20, 40, 60 });
+        REQUIRE(elapsedTime >= 60ms);
+    }
+
+    SUBCASE("stopped timers do not fire")
+    {
+        // GIVEN
+        Timer stopped;
+        Timer other;
+        bool stoppedFired = false;
+        bool otherFired = false;
+        std::ignore = stopped.timeout.connect([&]() { stoppedFired = true; });
+        std::ignore = other.timeout.connect([&]() { otherFired = true; });
+        stopped.interval = 20ms;
+        other.interval = 50ms;
+        stopped.running = true;
+        other.running = true;
+
+        // WHEN
+        stopped.running = false;
+        while (!otherFired)
+            loop.processEvents(100);
+
+        // THEN
+        REQUIRE(!stoppedFired);
+    }
+}
+
+TEST_CASE("Timer types")
+{
+    using namespace std::chrono_literals;
+
+    SUBCASE("coarse expiries are aligned within the slack")
+    {
+        // Precise timers are never moved
+        REQUIRE(LinuxTimerWheel::coalescedExpiry(1234, 1000, TimerType::Precise) == 1234);
+
+        // Coarse timers may be up to 5% late and prefer round ticks
+        REQUIRE(LinuxTimerWheel::coalescedExpiry(1234, 1000, TimerType::Coarse) == 1250);
+        REQUIRE(LinuxTimerWheel::coalescedExpiry(1960, 1000, TimerType::Coarse) == 2000);
+        REQUIRE(LinuxTimerWheel::coalescedExpiry(1234, 100, TimerType::Coarse) == 1235);
+        REQUIRE(LinuxTimerWheel::coalescedExpiry(1233, 10, TimerType::Coarse) == 1233);
+        for (TimerWheel::Tick deadline = 1000; deadline < 3000; ++deadline) {
+            const auto expiry = LinuxTimerWheel::coalescedExpiry(deadline, 200, TimerType::Coarse);
+            REQUIRE(expiry >= deadline);
+            REQUIRE(expiry <= deadline + 10);
+            REQUIRE(expiry % 5 == 0);
+        }
+
+        // Very coarse timers fire on the nearest second
+        REQUIRE(LinuxTimerWheel::coalescedExpiry(1499, 1000, TimerType::VeryCoarse) == 1000);
+        REQUIRE(LinuxTimerWheel::coalescedExpiry(1500, 1000, TimerType::VeryCoarse) == 2000);
+    }
+
+    SUBCASE("coarse timers use the timer wheel and share wake-ups")
+    {
+        // GIVEN
+        auto platformLoop = std::make_unique<LinuxPlatformEventLoop>();
+        LinuxPlatformEventLoop *linuxLoop = platformLoop.get();
+        linuxLoop->setTimerBackend(LinuxPlatformEventLoop::TimerBackend::TimerFd);
+        EventLoop loop(std::move(platformLoop));
+
+        const size_t timerCount = 20;
+        int iteration = 0;
+        std::vector<int> firedInIteration(timerCount, -1);
+        std::vector<std::unique_ptr<Timer>> timers;
+        for (size_t i = 0; i < timerCount; ++i) {
+            auto timer = std::make_unique<Timer>();
+            timer->timerType = TimerType::Coarse;
+            timer->interval = 400ms;
+            std::ignore = timer->timeout.connect([&firedInIteration, &iteration, i, t = timer.get()]() {
+                firedInIteration[i] = iteration;
+                t->running = false;
+            });
+            timers.push_back(std::move(timer));
+        }
+
+        // WHEN -> timers started with slightly different phases
+        for (auto &timer : timers) {
+            timer->running = true;
+            std::this_thread::sleep_for(1ms);
+        }
+
+        // THEN
+        REQUIRE(linuxLoop->registeredFileDescriptorCount() == 0);
+        REQUIRE(linuxLoop->timerWheel()->timerCount() == timerCount);
+
+        // WHEN
+        while (std::find(firedInIteration.begin(), firedInIteration.end(), -1) != firedInIteration.end()) {
+            ++iteration;
+            loop.processEvents(1000);
+        }
+
+        // THEN -> at most a few wake-ups were needed for all of them
+        std::vector<int> iterations = firedInIteration;
+        std::sort(iterations.begin(), iterations.end());
+        const auto wakeUpCount = std::distance(iterations.begin(), std::unique(iterations.begin(), iterations.end()));
+        REQUIRE(wakeUpCount <= 3);
+    }
+
+    SUBCASE("precise timers keep a timerfd of their own")
+    {
+        // GIVEN
+        auto platformLoop = std::make_unique<LinuxPlatformEventLoop>();
+        LinuxPlatformEventLoop *linuxLoop = platformLoop.get();
+        linuxLoop->setTimerBackend(LinuxPlatformEventLoop::TimerBackend::TimerFd);
+        EventLoop loop(std::move(platformLoop));
+
+        // WHEN
+        Timer timer;
+
+        // THEN
+        REQUIRE(linuxLoop->registeredFileDescriptorCount() == 1);
+
+        // WHEN
+        timer.timerType = TimerType::VeryCoarse;
+
+        // THEN
+        REQUIRE(linuxLoop->registeredFileDescriptorCount() == 0);
+    }
+}
+
+TEST_CASE("Timer expirations")
+{
+    using namespace std::chrono_literals;
+
+    for (const auto backend : { LinuxPlatformEventLoop::TimerBackend::TimerFd, LinuxPlatformEventLoop::TimerBackend::TimerWheel }) {
+        // GIVEN
+        auto platformLoop = std::make_unique<LinuxPlatformEventLoop>();
+        platformLoop->setTimerBackend(backend);
+        EventLoop loop(std::move(platformLoop));
+
+        Timer timer;
+        timer.interval = 20ms;
+        std::vector<uint64_t> expirations;
+        std::ignore = timer.timeout.connect([&expirations](uint64_t count) { expirations.push_back(count); });
+
+        // WHEN -> the loop is late
+        timer.running = true;
+        std::this_thread::sleep_for(110ms);
+        loop.processEvents(0);
+
+        // THEN -> the missed expirations are reported at once
+        REQUIRE(expirations.size() == 1);
+        REQUIRE(expirations[0] >= 5);
+
+        // WHEN
+        while (expirations.size() < 2)
+            loop.processEvents(100);
+
+        // THEN -> the timer stayed in phase
+        REQUIRE(expirations[1] == 1);
+    }
+}
+
+TEST_CASE("Single shots")
+{
+    using namespace std::chrono_literals;
+
+    auto platformLoop = std::make_unique<LinuxPlatformEventLoop>();
+    LinuxPlatformEventLoop *linuxLoop = platformLoop.get();
+    EventLoop loop(std::move(platformLoop));
+
+    SUBCASE("use the timer wheel")
+    {
+        // GIVEN
+        int calls = 0;
+
+        // WHEN
+        for (int i = 0; i < 100; ++i)
+            Timer::singleShot(std::chrono::milliseconds(i % 10), [&calls] { ++calls; });
+
+        // THEN
+        REQUIRE(linuxLoop->registeredFileDescriptorCount() == 0);
+        REQUIRE(linuxLoop->timerWheel()->timerCount() == 100);
+
+        // WHEN
+        while (calls < 100)
+            loop.processEvents(100);
+
+        // THEN
+        REQUIRE(linuxLoop->timerWheel()->timerCount() == 0);
+    }
+
+    SUBCASE("recycle their wheel entries")
+    {
+        // GIVEN
+        int calls = 0;
+        std::function<void()> callAgain = [&]() {
+            if (++calls < 10)
+                Timer::singleShot(1ms, callAgain);
+        };
+
+        // WHEN
+        Timer::singleShot(1ms, callAgain);
+        while (calls < 10)
+            loop.processEvents(100);
+
+        // THEN
+        REQUIRE(linuxLoop->timerWheel()->timerCount() == 0);
+    }
+}
+
+TEST_CASE("Pending single shots are dropped along with the loop")
+{
+    using namespace std::chrono_literals;
+
+    // GIVEN
+    bool called = false;
+    {
+        EventLoop loop(std::make_unique<LinuxPlatformEventLoop>());
+        Timer::singleShot(1ms, [&called] { called = true; });
+
+        // WHEN
+        std::this_thread::sleep_for(10ms);
+    }
+
+    // THEN
+    REQUIRE(!called);
+}
+
+TEST_CASE("Trigger modes")
+{
+    auto platformLoop = std::make_unique<LinuxPlatformEventLoop>();
+    LinuxPlatformEventLoop *linuxLoop = platformLoop.get();
+    EventLoop loop(std::move(platformLoop));
+
+    std::array<int, 2> fds;
+    REQUIRE(pipe(fds.data()) == 0);
+    int notifications = 0;
+    auto createNotifier = [&](FileDescriptorNotifier::NotificationType type, FileDescriptorNotifier::TriggerMode mode) {
+        auto notifier = std::make_unique<FileDescriptorNotifier>(type == FileDescriptorNotifier::NotificationType::Read ? fds[0] : fds[1], type, mode);
+        std::ignore = notifier->triggered.connect([&notifications](const int &) { ++notifications; });
+        return notifier;
+    };
+    const char byte = 'x';
+
+    SUBCASE("level-triggered notifiers fire while the fd is ready")
+    {
+        // GIVEN
+        auto notifier = createNotifier(FileDescriptorNotifier::NotificationType::Read, FileDescriptorNotifier::TriggerMode::Level);
+        REQUIRE(write(fds[1], &byte, 1) == 1);
+
+        // WHEN
+        linuxLoop->waitForEvents(0);
+        linuxLoop->waitForEvents(0);
+
+        // THEN
+        REQUIRE(notifications == 2);
+    }
+
+    SUBCASE("edge-triggered notifiers fire when the fd becomes ready")
+    {
+        // GIVEN
+        auto notifier = createNotifier(FileDescriptorNotifier::NotificationType::Read, FileDescriptorNotifier::TriggerMode::Edge);
+        REQUIRE(write(fds[1], &byte, 1) == 1);
+
+        // WHEN
+        linuxLoop->waitForEvents(0);
+        linuxLoop->waitForEvents(0);
+
+        // THEN
+        REQUIRE(notifications == 1);
+
+        // WHEN
+        REQUIRE(write(fds[1], &byte, 1) == 1);
+        linuxLoop->waitForEvents(0);
+
+        // THEN
+        REQUIRE(notifications == 2);
+    }
+
+    SUBCASE("one-shot notifiers fire once until rearmed")
+    {
+        // GIVEN
+        auto notifier = createNotifier(FileDescriptorNotifier::NotificationType::Read, FileDescriptorNotifier::TriggerMode::OneShot);
+        REQUIRE(write(fds[1], &byte, 1) == 1);
+
+        // WHEN
+        linuxLoop->waitForEvents(0);
+        linuxLoop->waitForEvents(0);
+
+        // THEN
+        REQUIRE(notifications == 1);
+        REQUIRE(!notifier->isEnabled());
+        REQUIRE(linuxLoop->registeredFileDescriptorCount() == 1);
+
+        // WHEN
+        notifier->rearm();
+        linuxLoop->waitForEvents(0);
+
+        // THEN
+        REQUIRE(notifications == 2);
+        REQUIRE(!notifier->isEnabled());
+    }
+
+    SUBCASE("one-shot notifiers stay registered while disarmed")
+    {
+        // GIVEN
+        auto notifier = createNotifier(FileDescriptorNotifier::NotificationType::Read, FileDescriptorNotifier::TriggerMode::OneShot);
+        REQUIRE(write(fds[1], &byte, 1) == 1);
+
+        // WHEN
+        linuxLoop->waitForEvents(0);
+
+        // THEN -> disarmed by the kernel, but not removed from epoll
+        REQUIRE(notifications == 1);
+        const auto disarmed = epollRegistration(linuxLoop->epollHandle(), fds[0]);
+        REQUIRE(disarmed.has_value());
+        REQUIRE((*disarmed & EPOLLIN) == 0);
+
+        // WHEN
+        notifier->rearm();
+
+        // THEN -> re-armed in place, with a single EPOLL_CTL_MOD on the kept registration
+        const auto rearmed = epollRegistration(linuxLoop->epollHandle(), fds[0]);
+        REQUIRE(rearmed.has_value());
+        REQUIRE((*rearmed & EPOLLIN) != 0);
+        REQUIRE((*rearmed & EPOLLONESHOT) != 0);
+
+        // WHEN
+        notifier.reset();
+
+        // THEN
+        REQUIRE(!epollRegistration(linuxLoop->epollHandle(), fds[0]).has_value());
+    }
+
+    SUBCASE("disabled notifiers stay registered but do not fire")
+    {
+        // GIVEN
+        auto notifier = createNotifier(FileDescriptorNotifier::NotificationType::Write, FileDescriptorNotifier::TriggerMode::Level);
+        linuxLoop->waitForEvents(0);
+        REQUIRE(notifications == 1);
+
+        // WHEN
+        notifier->setEnabled(false);
+        linuxLoop->waitForEvents(0);
+
+        // THEN
+        REQUIRE(notifications == 1);
+        REQUIRE(linuxLoop->registeredFileDescriptorCount() == 1);
+
+        // WHEN
+        notifier->setEnabled(true);
+        linuxLoop->waitForEvents(0);
+
+        // THEN
+        REQUIRE(notifications == 2);
+    }
+
+    SUBCASE("mixed modes on one fd fall back to level triggering")
+    {
+        // GIVEN
+        auto readNotifier = createNotifier(FileDescriptorNotifier::NotificationType::Read, FileDescriptorNotifier::TriggerMode::Edge);
+        int readNotifications = 0;
+        std::ignore = readNotifier->triggered.connect([&readNotifications](const int &) { ++readNotifications; });
+        auto exceptionNotifier = std::make_unique<FileDescriptorNotifier>(fds[0], FileDescriptorNotifier::NotificationType::Exception, FileDescriptorNotifier::TriggerMode::OneShot);
+        REQUIRE(write(fds[1], &byte, 1) == 1);
+
+        // WHEN
+        linuxLoop->waitForEvents(0);
+        linuxLoop->waitForEvents(0);
+
+        // THEN
+        REQUIRE(readNotifications == 2);
+    }
+
+    close(fds[0]);
+    close(fds[1]);
+}
@@ -0,0 +1,407 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/platform/linux/linux_uring_platform_event_loop.h>
+#include <KDFoundation/platform/linux/linux_platform_integration.h>
+#include <KDFoundation/event_loop.h>
+#include <KDFoundation/file_descriptor_notifier.h>
+#include <KDFoundation/postman.h>
+#include <KDFoundation/timer.h>
+
+#include <KDUtils/logging.h>
+
+#include <array>
+#include <chrono>
+#include <thread>
+#include <tuple>
+
+#include <unistd.h>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDFoundation;
+using namespace std::chrono_literals;
+
+static_assert(std::is_destructible<LinuxUringPlatformEventLoop>{});
+static_assert(std::is_default_constructible<LinuxUringPlatformEventLoop>{});
+static_assert(!std::is_copy_constructible<LinuxUringPlatformEventLoop>{});
+static_assert(!std::is_copy_assignable<LinuxUringPlatformEventLoop>{});
+static_assert(!std::is_move_constructible<LinuxUringPlatformEventLoop>{});
+static_assert(!std::is_move_assignable<LinuxUringPlatformEventLoop>{});
+
+namespace {
+// io_uring may be unavailable, e.g. in containers that forbid its system calls
+bool skipUnlessSupported()
+{
+    if (LinuxUringPlatformEventLoop::isSupported())
+        return false;
+    MESSAGE("io_uring is not supported, skipping");
+    return true;
+}
+
+long long elapsedMilliseconds(std::chrono::steady_clock::time_point since)
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - since).count();
+}
+} // namespace
+
+TEST_CASE("Backend selection")
+{
+    // GIVEN
+    LinuxPlatformIntegration integration;
+    REQUIRE(integration.eventLoopBackend() == LinuxPlatformIntegration::defaultEventLoopBackend());
+
+    // WHEN
+    integration.setEventLoopBackend(LinuxPlatformIntegration::EventLoopBackend::Epoll);
+    auto epollLoop = integration.createPlatformEventLoop();
+
+    // THEN
+    REQUIRE(dynamic_cast<LinuxPlatformEventLoop *>(epollLoop.get()) != nullptr);
+
+    // WHEN
+    integration.setEventLoopBackend(LinuxPlatformIntegration::EventLoopBackend::IoUring);
+    auto uringLoop = integration.createPlatformEventLoop();
+
+    // THEN -> falls back to epoll without kernel support
+    if (LinuxUringPlatformEventLoop::isSupported())
+        REQUIRE(dynamic_cast<LinuxUringPlatformEventLoop *>(uringLoop.get()) != nullptr);
+    else
+        REQUIRE(dynamic_cast<LinuxPlatformEventLoop *>(uringLoop.get()) != nullptr);
+}
+
+TEST_CASE("Wait for events")
+{
+    if (skipUnlessSupported())
+        return;
+
+    SUBCASE("can poll for events (0ms timeout)")
+    {
+        LinuxUringPlatformEventLoop loop;
+        const auto startTime = std::chrono::steady_clock::now();
+        loop.waitForEvents(0);
+        REQUIRE(elapsedMilliseconds(startTime) < 100);
+    }
+
+    SUBCASE("can wait for events (100 ms timeout)")
+    {
+        LinuxUringPlatformEventLoop loop;
+        const auto startTime = std::chrono::steady_clock::now();
+        loop.waitForEvents(100);
+        REQUIRE(elapsedMilliseconds(startTime) >= 100);
+    }
+
+    SUBCASE("can wake up by calling wakeUp from another thread")
+    {
+        // GIVEN
+        LinuxUringPlatformEventLoop loop;
+        std::thread waker([&loop] {
+            std::this_thread::sleep_for(100ms);
+            loop.wakeUp();
+        });
+
+        // WHEN
+        const auto startTime = std::chrono::steady_clock::now();
+        loop.waitForEvents(10000);
+
+        // THEN
+        REQUIRE(elapsedMilliseconds(startTime) < 10000);
+        waker.join();
+    }
+
+    SUBCASE("can be woken up by other threads repeatedly")
+    {
+        // GIVEN -> with a postman, so that the loop consumes its wake-ups
+        Postman postman;
+        LinuxUringPlatformEventLoop loop;
+        loop.setPostman(&postman);
+
+        for (int i = 0; i < 3; ++i) {
+            std::thread waker([&loop] {
+                std::this_thread::sleep_for(50ms);
+                loop.wakeUp();
+            });
+
+            // WHEN
+            const auto startTime = std::chrono::steady_clock::now();
+            loop.waitForEvents(10000);
+
+            // THEN
+            REQUIRE(elapsedMilliseconds(startTime) < 10000);
+            waker.join();
+        }
+    }
+
+    SUBCASE("can be woken up by a thread running an io_uring loop of its own")
+    {
+        // GIVEN
+        Postman postman;
+        LinuxUringPlatformEventLoop loop;
+        loop.setPostman(&postman);
+        std::thread waker([&loop] {
+            const LinuxUringPlatformEventLoop wakerLoop;
+            std::this_thread::sleep_for(100ms);
+            loop.wakeUp();
+        });
+
+        // WHEN
+        const auto startTime = std::chrono::steady_clock::now();
+        loop.waitForEvents(10000);
+
+        // THEN
+        REQUIRE(elapsedMilliseconds(startTime) < 10000);
+        waker.join();
+    }
+
+    SUBCASE("can wake up by calling wakeUp from its own thread")
+    {
+        // GIVEN
+        LinuxUringPlatformEventLoop loop;
+
+        // WHEN
+        loop.wakeUp();
+        loop.wakeUp();
+        auto startTime = std::chrono::steady_clock::now();
+        loop.waitForEvents(10000);
+
+        // THEN
+        REQUIRE(elapsedMilliseconds(startTime) < 10000);
+
+        // WHEN -> the pending wake-up was consumed, so a new one must kick the loop again
+        loop.wakeUp();
+        startTime = std::chrono::steady_clock::now();
+        loop.waitForEvents(10000);
+
+        // THEN
+        REQUIRE(elapsedMilliseconds(startTime) < 10000);
+    }
+}
+
+TEST_CASE("Notifies about events")
+{
+    if (skipUnlessSupported())
+        return;
+
+    // GIVEN
+    LinuxUringPlatformEventLoop loop;
+    Postman postman;
+    loop.setPostman(&postman);
+    std::array<int, 2> fds;
+    REQUIRE(pipe(fds.data()) == 0);
+    FileDescriptorNotifier notifier(fds[0], FileDescriptorNotifier::NotificationType::Read);
+    int notifications = 0;
+    std::ignore = notifier.triggered.connect([&notifications](const int &) { ++notifications; });
+
+    SUBCASE("of readable file descriptors")
+    {
+        // WHEN
+        REQUIRE(loop.registerNotifier(&notifier));
+        std::thread writer([fd = fds[1]] {
+            std::this_thread::sleep_for(100ms);
+            const int n = 42;
+            std::ignore = write(fd, &n, sizeof(n));
+        });
+        const auto startTime = std::chrono::steady_clock::now();
+        while (notifications == 0 && elapsedMilliseconds(startTime) < 10000)
+            loop.waitForEvents(10000);
+        writer.join();
+
+        // THEN
+        REQUIRE(notifications == 1);
+        REQUIRE(loop.registeredNotifierCount() == 1);
+
+        // WHEN -> the poll is re-armed
+        int n = 0;
+        std::ignore = read(fds[0], &n, sizeof(n));
+        std::ignore = write(fds[1], &n, sizeof(n));
+        while (notifications == 1 && elapsedMilliseconds(startTime) < 10000)
+            loop.waitForEvents(10000);
+
+        // THEN
+        REQUIRE(notifications == 2);
+    }
+
+    SUBCASE("not after unregistering")
+    {
+        // GIVEN
+        REQUIRE(loop.registerNotifier(&notifier));
+        REQUIRE(!loop.registerNotifier(&notifier));
+
+        // WHEN
+        REQUIRE(loop.unregisterNotifier(&notifier));
+        const int n = 42;
+        std::ignore = write(fds[1], &n, sizeof(n));
+        loop.waitForEvents(50);
+
+        // THEN
+        REQUIRE(notifications == 0);
+        REQUIRE(loop.registeredNotifierCount() == 0);
+        REQUIRE(!loop.unregisterNotifier(&notifier));
+    }
+
+    close(fds[0]);
+    close(fds[1]);
+}
+
+TEST_CASE("Timers")
+{
+    if (skipUnlessSupported())
+        return;
+
+    auto platformLoop = std::make_unique<LinuxUringPlatformEventLoop>();
+    LinuxUringPlatformEventLoop *uringLoop = platformLoop.get();
+    EventLoop loop(std::move(platformLoop));
+
+    SUBCASE("fire without file descriptors of their own")
+    {
+        // GIVEN
+        Timer timer;
+        timer.interval = 20ms;
+        int timeouts = 0;
+        std::ignore = timer.timeout.connect([&timeouts]() { ++timeouts; });
+
+        // WHEN
+        const auto startTime = std::chrono::steady_clock::now();
+        timer.running = true;
+        while (timeouts < 3)
+            loop.processEvents(1000);
+
+        // THEN
+        REQUIRE(elapsedMilliseconds(startTime) >= 60);
+        REQUIRE(uringLoop->registeredNotifierCount() == 0);
+        REQUIRE(uringLoop->timerWheel()->fileDescriptor() == -1);
+    }
+
+    SUBCASE("single shots fire once")
+    {
+        // GIVEN
+        int calls = 0;
+
+        // WHEN
+        const auto startTime = std::chrono::steady_clock::now();
+        Timer::singleShot(20ms, [&calls] { ++calls; });
+        while (calls == 0)
+            loop.processEvents(1000);
+        loop.processEvents(50);
+
+        // THEN
+        REQUIRE(calls == 1);
+        REQUIRE(elapsedMilliseconds(startTime) >= 20);
+        REQUIRE(uringLoop->timerWheel()->timerCount() == 0);
+    }
+}
+
+TEST_CASE("Trigger modes")
+{
+    if (skipUnlessSupported())
+        return;
+
+    auto platformLoop = std::make_unique<LinuxUringPlatformEventLoop>();
+    LinuxUringPlatformEventLoop *uringLoop = platformLoop.get();
+    EventLoop loop(std::move(platformLoop));
+
+    std::array<int, 2> fds;
+    REQUIRE(pipe(fds.data()) == 0);
+    int notifications = 0;
+    auto createNotifier = [&](FileDescriptorNotifier::TriggerMode mode) {
+        auto notifier = std::make_unique<FileDescriptorNotifier>(fds[0], FileDescriptorNotifier::NotificationType::Read, mode);
+        std::ignore = notifier->triggered.connect([&notifications](const int &) { ++notifications; });
+        return notifier;
+    };
+    // Submissions of the loop go to the kernel along with the next wait. Give the kernel
+    // a moment to complete them before looking.
+    auto waitTwice = [uringLoop] {
+        uringLoop->waitForEvents(0);
+        uringLoop->waitForEvents(10);
+    };
+    const char byte = 'x';
+
+    SUBCASE("level-triggered notifiers fire while the fd is ready")
+    {
+        // GIVEN
+        auto notifier = createNotifier(FileDescriptorNotifier::TriggerMode::Level);
+        REQUIRE(write(fds[1], &byte, 1) == 1);
+
+        // WHEN
+        waitTwice();
+        waitTwice();
+
+        // THEN
+        REQUIRE(notifications >= 2);
+    }
+
+    SUBCASE("edge-triggered notifiers fire when the fd becomes ready")
+    {
+        // GIVEN
+        auto notifier = createNotifier(FileDescriptorNotifier::TriggerMode::Edge);
+        REQUIRE(write(fds[1], &byte, 1) == 1);
+
+        // WHEN
+        waitTwice();
+        waitTwice();
+
+        // THEN
+        REQUIRE(notifications == 1);
+
+        // WHEN
+        REQUIRE(write(fds[1], &byte, 1) == 1);
+        waitTwice();
+
+        // THEN
+        REQUIRE(notifications == 2);
+    }
+
+    SUBCASE("one-shot notifiers fire once until rearmed")
+    {
+        // GIVEN
+        auto notifier = createNotifier(FileDescriptorNotifier::TriggerMode::OneShot);
+        REQUIRE(write(fds[1], &byte, 1) == 1);
+
+        // WHEN
+        waitTwice();
+        waitTwice();
+
+        // THEN
+        REQUIRE(notifications == 1);
+        REQUIRE(!notifier->isEnabled());
+
+        // WHEN
+        notifier->rearm();
+        waitTwice();
+
+        // THEN
+        REQUIRE(notifications == 2);
+    }
+
+    SUBCASE("disabled notifiers stay registered but do not fire")
+    {
+        // GIVEN
+        auto notifier = createNotifier(FileDescriptorNotifier::TriggerMode::Level);
+        notifier->setEnabled(false);
+        REQUIRE(write(fds[1], &byte, 1) == 1);
+
+        // WHEN
+        waitTwice();
+
+        // THEN
+        REQUIRE(notifications == 0);
+        REQUIRE(uringLoop->registeredNotifierCount() == 1);
+
+        // WHEN
+        notifier->setEnabled(true);
+        waitTwice();
+
+        // THEN
+        REQUIRE(notifications >= 1);
+    }
+
+    close(fds[0]);
+    close(fds[1]);
+}
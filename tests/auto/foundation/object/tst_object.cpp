@@ -11,12 +11,16 @@
 
 #include "KDFoundation/core_application.h"
 #include <KDFoundation/object.h>
+#include <KDFoundation/object_arena.h>
 #include <KDFoundation/event.h>
 #include <KDFoundation/kdfoundation_global.h>
 #include <signal_spy.h>
 
 #include <kdbindings/signal.h>
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
 #include <numeric>
 #include <string>
 #include <tuple>
@@ -287,6 +291,134 @@ TEST_CASE("Parenting")
             REQUIRE(c->parent() == parent.get());
         }
     }
+
+    SUBCASE("can take children in any order")
+    {
+        // GIVEN
+        auto parent = std::make_unique<Object>();
+        std::vector<Object *> children;
+        for (int i = 0; i < 10; ++i)
+            children.push_back(parent->createChild<Object>());
+        auto otherParent = std::make_unique<Object>();
+        auto otherChild = otherParent->createChild<Object>();
+
+        // WHEN
+        auto notTaken = parent->takeChild(otherChild);
+
+        // THEN
+        REQUIRE(notTaken == nullptr);
+        REQUIRE(otherChild->parent() == otherParent.get());
+
+        // WHEN
+        for (const int i : { 4, 0, 9, 5, 1, 8, 2, 7, 3, 6 }) {
+            auto taken = parent->takeChild(children[i]);
+
+            // THEN
+            REQUIRE(taken.get() == children[i]);
+            REQUIRE(taken->parent() == nullptr);
+            REQUIRE(std::none_of(parent->children().begin(), parent->children().end(), [&taken](const auto &child) {
+                return child.get() == taken.get();
+            }));
+            for (const auto &child : parent->children())
+                REQUIRE(child->parent() == parent.get());
+        }
+
+        // THEN
+        REQUIRE(parent->children().empty());
+    }
+
+    SUBCASE("taking a child moves the last child into its slot")
+    {
+        // GIVEN
+        auto parent = std::make_unique<Object>();
+        std::vector<Object *> children;
+        std::vector<Object *> destructionOrder;
+        for (int i = 0; i < 4; ++i) {
+            children.push_back(parent->createChild<Object>());
+            std::ignore = children.back()->destroyed.connect([&destructionOrder](Object *object) {
+                destructionOrder.push_back(object);
+            });
+        }
+
+        // WHEN
+        auto taken = parent->takeChild(children[1]);
+
+        // THEN
+        REQUIRE(parent->children().size() == 3);
+        REQUIRE(parent->children()[0].get() == children[0]);
+        REQUIRE(parent->children()[1].get() == children[3]);
+        REQUIRE(parent->children()[2].get() == children[2]);
+
+        // WHEN
+        parent.reset();
+
+        // THEN -> in reverse of the order of the remaining children
+        REQUIRE(destructionOrder == std::vector<Object *>{ children[2], children[3], children[0] });
+    }
+}
+
+TEST_CASE("Child lookup")
+{
+    // GIVEN
+    auto root = std::make_unique<Object>();
+    auto a = root->createChild<Object>();
+    a->setObjectName("a");
+    auto b = root->createChild<IntObject>(1);
+    b->setObjectName("b");
+    auto c = a->createChild<IntObject>(2);
+    c->setObjectName("c");
+    auto d = a->createChild<Object>();
+    d->setObjectName("b");
+
+    SUBCASE("can find a child by name and type")
+    {
+        // THEN
+        REQUIRE(root->findChild<Object>("a") == a);
+        REQUIRE(root->findChild<IntObject>("a") == nullptr);
+        REQUIRE(root->findChild<IntObject>("b") == b);
+        REQUIRE(root->findChild<Object>("c") == c);
+        REQUIRE(root->findChild<Object>("c", Object::ChildLookup::DirectChildrenOnly) == nullptr);
+        REQUIRE(root->findChild<CountedObject>("c") == nullptr);
+        REQUIRE(root->findChild<Object>("z") == nullptr);
+        REQUIRE(a->findChild<IntObject>() == c);
+    }
+
+    SUBCASE("can find children by name and type")
+    {
+        // THEN
+        REQUIRE(root->findChildren<IntObject>() == std::vector<IntObject *>{ c, b });
+        REQUIRE(root->findChildren<IntObject>({}, Object::ChildLookup::DirectChildrenOnly) == std::vector<IntObject *>{ b });
+        REQUIRE(root->findChildren<Object>().size() == 4);
+        REQUIRE(root->findChildren<Object>("b") == std::vector<Object *>{ d, b });
+        REQUIRE(root->findChildren<Object>("b", Object::ChildLookup::DirectChildrenOnly) == std::vector<Object *>{ b });
+    }
+
+    SUBCASE("keeps the name index up to date")
+    {
+        // GIVEN
+        REQUIRE(root->findChild<Object>("a", Object::ChildLookup::DirectChildrenOnly) == a);
+
+        // WHEN
+        a->setObjectName("renamed");
+
+        // THEN
+        REQUIRE(root->findChild<Object>("a", Object::ChildLookup::DirectChildrenOnly) == nullptr);
+        REQUIRE(root->findChild<Object>("renamed", Object::ChildLookup::DirectChildrenOnly) == a);
+
+        // WHEN
+        auto taken = root->takeChild(a);
+
+        // THEN
+        REQUIRE(root->findChild<Object>("renamed") == nullptr);
+        REQUIRE(root->findChild<Object>("c") == nullptr);
+
+        // WHEN
+        root->addChild(std::move(taken));
+
+        // THEN
+        REQUIRE(root->findChild<Object>("renamed", Object::ChildLookup::DirectChildrenOnly) == a);
+        REQUIRE(root->findChild<IntObject>("c") == c);
+    }
 }
 
 TEST_CASE("Object destruction")
@@ -354,6 +486,151 @@ TEST_CASE("Object destruction")
     }
 }
 
+TEST_CASE("Arena allocation")
+{
+    SUBCASE("can create a tree from an arena")
+    {
+        // GIVEN
+        ObjectArena arena;
+
+        {
+            // WHEN
+            auto root = arena.create<Object>();
+            auto child = root->createChild<IntObject>(42);
+            auto grandChild = child->createChild<CountedObject>();
+            auto heapChild = std::make_unique<Object>();
+
+            // THEN
+            REQUIRE(root->arena() == &arena);
+            REQUIRE(child->arena() == &arena);
+            REQUIRE(grandChild->arena() == &arena);
+            REQUIRE(heapChild->arena() == nullptr);
+            REQUIRE(child->value() == 42);
+            REQUIRE(CountedObject::ms_objectCount == 1);
+            REQUIRE(arena.allocationCount() == 3);
+
+            // WHEN
+            root->addChild(std::move(heapChild));
+
+            // THEN
+            REQUIRE(root->children().size() == 2);
+        }
+
+        // THEN
+        REQUIRE(CountedObject::ms_objectCount == 0);
+        REQUIRE(arena.allocationCount() == 0);
+    }
+
+    SUBCASE("can allocate a child of a heap allocated object from an arena")
+    {
+        // GIVEN
+        ObjectArena arena;
+        auto parent = std::make_unique<Object>();
+
+        // WHEN
+        auto child = parent->createChild<Object>(arena);
+        auto sibling = parent->createChild<Object>();
+
+        // THEN
+        REQUIRE(parent->arena() == nullptr);
+        REQUIRE(child->arena() == &arena);
+        REQUIRE(sibling->arena() == nullptr);
+        REQUIRE(arena.allocationCount() == 1);
+
+        // WHEN
+        auto takenChild = parent->takeChild(child);
+        takenChild.reset();
+
+        // THEN
+        REQUIRE(arena.allocationCount() == 0);
+    }
+
+    SUBCASE("recycles the memory of destroyed objects")
+    {
+        // GIVEN
+        ObjectArena arena;
+        auto root = arena.create<Object>();
+        for (int i = 0; i < 100; ++i)
+            root->createChild<Object>();
+        const size_t reservedSize = arena.reservedSize();
+
+        // WHEN
+        for (int i = 0; i < 100; ++i)
+            root->takeChild(root->children().back().get());
+        for (int i = 0; i < 100; ++i)
+            root->createChild<Object>();
+
+        // THEN
+        REQUIRE(arena.reservedSize() == reservedSize);
+    }
+
+    SUBCASE("objects are handed back to the arena they come from")
+    {
+        // GIVEN
+        struct LargeObject : public Object {
+            std::array<std::byte, 2 * ObjectArena::MaxPooledSize> payload{};
+        };
+        struct Payload {
+            virtual ~Payload() = default;
+            int value = 0;
+        };
+        struct OffsetObject : public Payload, public Object {
+        };
+        ObjectArena arena;
+        auto root = arena.create<Object>();
+        root->createChild<Object>();
+        auto largeChild = root->createChild<LargeObject>();
+        auto offsetChild = root->createChild<OffsetObject>();
+        root->addChild(std::make_unique<Object>());
+
+        // THEN
+        REQUIRE(static_cast<void *>(static_cast<Object *>(offsetChild)) != static_cast<void *>(offsetChild));
+        REQUIRE(root->children().back()->arena() == nullptr);
+        REQUIRE(arena.allocationCount() == 4);
+
+        // WHEN
+        root->takeChild(largeChild).reset();
+        root->takeChild(offsetChild).reset();
+
+        // THEN
+        REQUIRE(arena.allocationCount() == 2);
+
+        // WHEN -> the heap allocated child is deleted while deleting root
+        root.reset();
+
+        // THEN
+        REQUIRE(arena.allocationCount() == 0);
+    }
+
+    SUBCASE("keeps destruction order and signals")
+    {
+        // GIVEN
+        ObjectArena arena;
+        auto root = arena.create<Object>();
+        const SignalSpy childRemovedSpy(root->childRemoved);
+        SignalSpy<Object *> destroyedSpy(root->destroyed);
+
+        std::vector<int> destructionOrder;
+        for (int i = 0; i < 10; ++i) {
+            auto child = root->createChild<IntObject>(i);
+            std::ignore = child->aboutToBeDestroyed.connect([&destructionOrder](const int &value) {
+                destructionOrder.push_back(value);
+            });
+        }
+
+        // WHEN
+        root.reset();
+
+        // THEN
+        REQUIRE(destroyedSpy.count() == 1);
+        REQUIRE(childRemovedSpy.count() == 10);
+        std::vector<int> expectedDestructionOrder(10);
+        std::iota(expectedDestructionOrder.rbegin(), expectedDestructionOrder.rend(), 0);
+        REQUIRE(destructionOrder == expectedDestructionOrder);
+        REQUIRE(arena.allocationCount() == 0);
+    }
+}
+
 TEST_CASE("Deferred object destruction")
 {
 
@@ -409,6 +686,96 @@ TEST_CASE("Deferred object destruction")
         REQUIRE(objectDestroyedSpy.count() == 1);
         REQUIRE(std::get<0>(objectDestroyedSpy.args()) == obj);
     }
+
+    SUBCASE("deferred deletions don't go through the event queue")
+    {
+        // GIVEN
+        CoreApplication app;
+        std::vector<std::unique_ptr<CountedObject>> objects;
+        for (int i = 0; i < 100; ++i)
+            objects.push_back(std::make_unique<CountedObject>());
+
+        // WHEN
+        for (auto &object : objects)
+            object.release()->deleteLater();
+
+        // THEN
+        REQUIRE(app.eventQueueSize() == 0);
+        REQUIRE(CountedObject::ms_objectCount == 100);
+
+        // WHEN
+        app.processEvents();
+
+        // THEN
+        REQUIRE(CountedObject::ms_objectCount == 0);
+    }
+
+    SUBCASE("children of an object deleted in the same pass are deleted along with it")
+    {
+        // GIVEN
+        CoreApplication app;
+        auto root = std::make_unique<Object>();
+        auto parent = root->createChild<Object>();
+        auto child = parent->createChild<Object>();
+        auto grandChild = child->createChild<Object>();
+        SignalSpy<Object *, Object *> rootChildRemovedSpy(root->childRemoved);
+        SignalSpy<Object *, Object *> parentChildRemovedSpy(parent->childRemoved);
+        SignalSpy<Object *> grandChildDestroyedSpy(grandChild->destroyed);
+
+        // WHEN
+        grandChild->deleteLater();
+        child->deleteLater();
+        parent->deleteLater();
+        app.processEvents();
+
+        // THEN
+        REQUIRE(root->children().empty());
+        REQUIRE(rootChildRemovedSpy.count() == 1);
+        REQUIRE(std::get<1>(rootChildRemovedSpy.args()) == parent);
+        REQUIRE(parentChildRemovedSpy.count() == 1);
+        REQUIRE(grandChildDestroyedSpy.count() == 1);
+    }
+
+    SUBCASE("object destroyed before control returns to event loop is not deleted again")
+    {
+        // GIVEN
+        CoreApplication app;
+        auto obj = std::make_unique<CountedObject>();
+        auto sibling = new CountedObject();
+
+        // WHEN
+        obj->deleteLater();
+        sibling->deleteLater();
+        obj.reset();
+        app.processEvents();
+
+        // THEN
+        REQUIRE(CountedObject::ms_objectCount == 0);
+    }
+
+    SUBCASE("objects scheduled for deletion while deleting are deleted on the next iteration")
+    {
+        // GIVEN
+        CoreApplication app;
+        auto obj = new Object();
+        auto other = new CountedObject();
+        std::ignore = obj->destroyed.connect([other](Object *) {
+            other->deleteLater();
+        });
+
+        // WHEN
+        obj->deleteLater();
+        app.processEvents();
+
+        // THEN
+        REQUIRE(CountedObject::ms_objectCount == 1);
+
+        // WHEN
+        app.processEvents();
+
+        // THEN
+        REQUIRE(CountedObject::ms_objectCount == 0);
+    }
 }
 
 TEST_CASE("Threaded object destruction" * skipOnMacOS())
@@ -0,0 +1,174 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/event.h>
+#include <KDFoundation/object.h>
+#include <KDFoundation/postman.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDFoundation;
+
+namespace {
+const auto userType = static_cast<Event::Type>(static_cast<uint16_t>(Event::Type::UserType) + 1);
+
+class RecordingObject : public Object
+{
+public:
+    void event(EventReceiver *target, Event *ev) override
+    {
+        types.push_back(ev->type());
+        if (acceptEvents)
+            ev->setAccepted(true);
+        if (onEvent)
+            onEvent();
+    }
+
+    std::vector<Event::Type> types;
+    bool acceptEvents = false;
+    std::function<void()> onEvent;
+};
+} // namespace
+
+TEST_CASE("Catch-all filters")
+{
+    Postman postman;
+    RecordingObject filter;
+    RecordingObject target;
+    postman.addFilter(&filter);
+    REQUIRE(postman.filters().size() == 1);
+
+    Event keyPress(Event::Type::KeyPress);
+    postman.deliverEvent(&target, &keyPress);
+    Event user(userType);
+    postman.deliverEvent(&target, &user);
+
+    CHECK(filter.types == std::vector<Event::Type>{ Event::Type::KeyPress, userType });
+    CHECK(target.types == std::vector<Event::Type>{ Event::Type::KeyPress, userType });
+
+    postman.removeFilter(&filter);
+    CHECK(postman.filters().empty());
+}
+
+TEST_CASE("Removing a filter")
+{
+    Postman postman;
+    RecordingObject filter;
+    RecordingObject target;
+    postman.addFilter(&filter);
+    postman.addFilter(&filter);
+    postman.addFilter(&filter, { Event::Type::KeyPress });
+    postman.addFilter(&filter, &target);
+    REQUIRE(postman.filters().size() == 2);
+
+    // Drops all of its registrations, not just the first one
+    postman.removeFilter(&filter);
+    CHECK(postman.filters().empty());
+
+    Event keyPress(Event::Type::KeyPress);
+    postman.deliverEvent(&target, &keyPress);
+    CHECK(filter.types.empty());
+    CHECK(target.types == std::vector<Event::Type>{ Event::Type::KeyPress });
+}
+
+TEST_CASE("Filters by event type")
+{
+    Postman postman;
+    RecordingObject keyFilter;
+    RecordingObject userFilter;
+    RecordingObject target;
+    postman.addFilter(&keyFilter, { Event::Type::KeyPress, Event::Type::KeyRelease });
+    postman.addFilter(&userFilter, { userType });
+
+    SUBCASE("only see the events of their types")
+    {
+        for (const auto type : { Event::Type::Timer, Event::Type::KeyPress, userType, Event::Type::KeyRelease }) {
+            Event ev(type);
+            postman.deliverEvent(&target, &ev);
+        }
+
+        CHECK(keyFilter.types == std::vector<Event::Type>{ Event::Type::KeyPress, Event::Type::KeyRelease });
+        CHECK(userFilter.types == std::vector<Event::Type>{ userType });
+        CHECK(target.types.size() == 4);
+        CHECK(postman.filters().empty());
+    }
+
+    SUBCASE("can stop events from reaching the target")
+    {
+        keyFilter.acceptEvents = true;
+        Event ev(Event::Type::KeyPress);
+        postman.deliverEvent(&target, &ev);
+        CHECK(keyFilter.types.size() == 1);
+        CHECK(target.types.empty());
+    }
+
+    SUBCASE("are called after the catch-all filters")
+    {
+        RecordingObject catchAllFilter;
+        catchAllFilter.acceptEvents = true;
+        postman.addFilter(&catchAllFilter);
+        Event ev(Event::Type::KeyPress);
+        postman.deliverEvent(&target, &ev);
+        CHECK(catchAllFilter.types.size() == 1);
+        CHECK(keyFilter.types.empty());
+    }
+
+    SUBCASE("can be removed")
+    {
+        postman.removeFilter(&keyFilter);
+        postman.removeFilter(&userFilter);
+        for (const auto type : { Event::Type::KeyPress, userType }) {
+            Event ev(type);
+            postman.deliverEvent(&target, &ev);
+        }
+        CHECK(keyFilter.types.empty());
+        CHECK(userFilter.types.empty());
+        CHECK(target.types.size() == 2);
+    }
+
+    SUBCASE("can be removed while filtering")
+    {
+        keyFilter.onEvent = [&] { postman.removeFilter(&keyFilter); };
+        RecordingObject otherKeyFilter;
+        postman.addFilter(&otherKeyFilter, { Event::Type::KeyPress });
+        for (int i = 0; i < 2; ++i) {
+            Event ev(Event::Type::KeyPress);
+            postman.deliverEvent(&target, &ev);
+        }
+        CHECK(keyFilter.types.size() == 1);
+        CHECK(target.types.size() == 2);
+    }
+}
+
+TEST_CASE("Filters by target")
+{
+    Postman postman;
+    RecordingObject filter;
+    RecordingObject target;
+    RecordingObject otherTarget;
+    postman.addFilter(&filter, &target);
+
+    Event ev(Event::Type::Update);
+    postman.deliverEvent(&target, &ev);
+    Event otherEv(Event::Type::Update);
+    postman.deliverEvent(&otherTarget, &otherEv);
+    CHECK(filter.types.size() == 1);
+
+    postman.removeFiltersFor(&target);
+    Event lastEv(Event::Type::Update);
+    postman.deliverEvent(&target, &lastEv);
+    CHECK(filter.types.size() == 1);
+    CHECK(target.types.size() == 2);
+}
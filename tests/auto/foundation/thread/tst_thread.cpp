@@ -0,0 +1,418 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/core_application.h>
+#include <KDFoundation/thread.h>
+#include <KDFoundation/timer.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <optional>
+#include <thread>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+#include <signal_spy.h>
+
+using namespace KDFoundation;
+
+static_assert(std::is_destructible<Thread>{});
+static_assert(std::is_default_constructible<Thread>{});
+static_assert(!std::is_copy_constructible<Thread>{});
+static_assert(!std::is_copy_assignable<Thread>{});
+static_assert(!std::is_move_constructible<Thread>{});
+static_assert(!std::is_move_assignable<Thread>{});
+
+namespace {
+// Records the thread events are delivered on and lets the test wait for them
+class ThreadObject : public Object
+{
+public:
+    void waitForEvents(int count)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_condition.wait_for(lock, std::chrono::seconds(5), [this, count] { return m_eventCount >= count; });
+    }
+
+    std::thread::id eventThread() const
+    {
+        const std::lock_guard<std::mutex> lock(m_mutex);
+        return m_eventThread;
+    }
+
+protected:
+    void event(EventReceiver *target, Event *ev) override
+    {
+        Object::event(target, ev);
+        if (ev->type() == Event::Type::Update) {
+            const std::lock_guard<std::mutex> lock(m_mutex);
+            m_eventThread = std::this_thread::get_id();
+            ++m_eventCount;
+            m_condition.notify_all();
+        }
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::thread::id m_eventThread;
+    int m_eventCount = 0;
+};
+} // namespace
+
+TEST_CASE("Lifetime")
+{
+    SUBCASE("runs an event loop of its own")
+    {
+        // GIVEN
+        CoreApplication app;
+        Thread thread;
+        SignalSpy<> startedSpy(thread.started);
+        SignalSpy<> finishedSpy(thread.finished);
+        REQUIRE(!thread.isRunning());
+        REQUIRE(thread.eventLoop() == nullptr);
+
+        // WHEN
+        thread.start();
+
+        // THEN
+        REQUIRE(thread.isRunning());
+        REQUIRE(thread.eventLoop() != nullptr);
+        REQUIRE(thread.eventLoop() != app.eventLoop());
+        REQUIRE(thread.id() != std::this_thread::get_id());
+
+        // WHEN
+        thread.quit();
+        thread.wait();
+
+        // THEN
+        REQUIRE(!thread.isRunning());
+        REQUIRE(startedSpy.count() == 1);
+        REQUIRE(finishedSpy.count() == 1);
+    }
+
+    SUBCASE("destroying a running thread stops it")
+    {
+        // GIVEN
+        CoreApplication app;
+        auto thread = std::make_unique<Thread>();
+        SignalSpy<> finishedSpy(thread->finished);
+        thread->start();
+
+        // WHEN
+        thread.reset();
+
+        // THEN
+        REQUIRE(finishedSpy.count() == 1);
+    }
+}
+
+TEST_CASE("Object affinity")
+{
+    SUBCASE("objects live on the loop of the thread that created them")
+    {
+        // GIVEN
+        CoreApplication app;
+        Object obj;
+        EventLoop *workerLoop = nullptr;
+        EventLoop *workerObjectLoop = nullptr;
+
+        // WHEN
+        std::thread worker([&] {
+            EventLoop loop;
+            const Object workerObject;
+            workerLoop = &loop;
+            workerObjectLoop = workerObject.eventLoop();
+        });
+        worker.join();
+
+        // THEN
+        REQUIRE(app.eventLoop() == static_cast<EventReceiver &>(app).eventLoop());
+        REQUIRE(obj.eventLoop() == app.eventLoop());
+        REQUIRE(workerObjectLoop == workerLoop);
+    }
+
+    SUBCASE("children move along with their parent")
+    {
+        // GIVEN
+        CoreApplication app;
+        Thread thread;
+        thread.start();
+        auto parent = std::make_unique<Object>();
+        auto child = parent->createChild<Object>();
+
+        // WHEN
+        parent->moveToEventLoop(thread.eventLoop());
+
+        // THEN
+        REQUIRE(parent->eventLoop() == thread.eventLoop());
+        REQUIRE(child->eventLoop() == thread.eventLoop());
+
+        // WHEN
+        auto newChild = parent->createChild<Object>();
+
+        // THEN
+        REQUIRE(newChild->eventLoop() == thread.eventLoop());
+    }
+
+    SUBCASE("posted events are delivered on the thread of the receiver")
+    {
+        // GIVEN
+        CoreApplication app;
+        Thread thread;
+        thread.start();
+        auto obj = std::make_unique<ThreadObject>();
+        obj->moveToEventLoop(thread.eventLoop());
+
+        // WHEN
+        app.postEvent(obj.get(), std::make_unique<UpdateEvent>());
+        obj->waitForEvents(1);
+
+        // THEN
+        REQUIRE(app.eventQueueSize() == 0);
+        REQUIRE(obj->eventThread() == thread.id());
+
+        thread.quit();
+        thread.wait();
+    }
+
+    SUBCASE("deleteLater deletes on the thread of the object")
+    {
+        // GIVEN
+        CoreApplication app;
+        Thread thread;
+        thread.start();
+        auto obj = new Object();
+        obj->moveToEventLoop(thread.eventLoop());
+        std::mutex mutex;
+        std::condition_variable condition;
+        std::thread::id deletionThread;
+        std::ignore = obj->destroyed.connect([&](Object *) {
+            const std::lock_guard<std::mutex> lock(mutex);
+            deletionThread = std::this_thread::get_id();
+            condition.notify_all();
+        });
+
+        // WHEN
+        obj->deleteLater();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait_for(lock, std::chrono::seconds(5), [&] { return deletionThread != std::thread::id(); });
+        }
+
+        // THEN
+        REQUIRE(deletionThread == thread.id());
+        REQUIRE(app.eventQueueSize() == 0);
+    }
+
+    SUBCASE("a pending deferred deletion moves along with the object")
+    {
+        // GIVEN
+        CoreApplication app;
+        Thread thread;
+        thread.start();
+        auto obj = new Object();
+        std::mutex mutex;
+        std::condition_variable condition;
+        int destructions = 0;
+        std::thread::id deletionThread;
+        std::ignore = obj->destroyed.connect([&](Object *) {
+            const std::lock_guard<std::mutex> lock(mutex);
+            ++destructions;
+            deletionThread = std::this_thread::get_id();
+            condition.notify_all();
+        });
+
+        // WHEN
+        obj->deleteLater();
+        obj->moveToEventLoop(thread.eventLoop());
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait_for(lock, std::chrono::seconds(5), [&] { return destructions != 0; });
+        }
+        app.processEvents();
+
+        // THEN -> deleted once, by the loop the object moved to
+        const std::lock_guard<std::mutex> lock(mutex);
+        REQUIRE(destructions == 1);
+        REQUIRE(deletionThread == thread.id());
+    }
+
+    SUBCASE("deleteLater from another thread takes the object from its parent")
+    {
+        // GIVEN
+        CoreApplication app;
+        Thread thread;
+        thread.start();
+        auto parent = std::make_unique<Object>();
+        auto child = parent->createChild<Object>();
+        parent->moveToEventLoop(thread.eventLoop());
+        std::mutex mutex;
+        std::condition_variable condition;
+        int destructions = 0;
+        std::ignore = child->destroyed.connect([&](Object *) {
+            const std::lock_guard<std::mutex> lock(mutex);
+            ++destructions;
+            condition.notify_all();
+        });
+
+        // WHEN
+        child->deleteLater();
+        child->deleteLater();
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            condition.wait_for(lock, std::chrono::seconds(5), [&] { return destructions != 0; });
+        }
+        thread.quit();
+        thread.wait();
+
+        // THEN -> deleted once, and not again along with its parent
+        REQUIRE(parent->children().empty());
+        parent.reset();
+        REQUIRE(destructions == 1);
+    }
+
+    SUBCASE("single shots fire on the thread of the context object")
+    {
+        // GIVEN
+        CoreApplication app;
+        Thread thread;
+        thread.start();
+        Object context;
+        context.moveToEventLoop(thread.eventLoop());
+        std::atomic<bool> fired = false;
+        std::thread::id firedOn;
+
+        // WHEN
+        Timer::singleShot(std::chrono::milliseconds(10), &context, [&] {
+            firedOn = std::this_thread::get_id();
+            fired = true;
+        });
+        const auto start = std::chrono::steady_clock::now();
+        while (!fired && std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        // THEN
+        REQUIRE(fired);
+        REQUIRE(firedOn == thread.id());
+        REQUIRE(std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(10));
+
+        thread.quit();
+        thread.wait();
+    }
+
+    SUBCASE("single shots don't depend on the event handling of the context object")
+    {
+        // GIVEN
+        class DeafObject : public Object
+        {
+        protected:
+            void event(EventReceiver *, Event *) override { }
+        };
+        CoreApplication app;
+        Thread thread;
+        thread.start();
+        DeafObject context;
+        context.moveToEventLoop(thread.eventLoop());
+        std::atomic<bool> fired = false;
+
+        // WHEN
+        Timer::singleShot(std::chrono::milliseconds(1), &context, [&] { fired = true; });
+        const auto start = std::chrono::steady_clock::now();
+        while (!fired && std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+        // THEN
+        REQUIRE(fired);
+
+        thread.quit();
+        thread.wait();
+    }
+
+    SUBCASE("single shots are canceled by destroying the context object before they start")
+    {
+        // GIVEN
+        CoreApplication app;
+        Thread thread;
+        thread.start();
+        auto context = new Object();
+        context->moveToEventLoop(thread.eventLoop());
+        std::atomic<bool> released = false;
+        std::atomic<bool> contextDestroyed = false;
+        std::atomic<bool> fired = false;
+
+        // WHEN -> the loop of the thread destroys context before it gets to the single shot
+        thread.eventLoop()->postCallback([&] {
+            while (!released)
+                std::this_thread::yield();
+            delete context;
+            contextDestroyed = true;
+        },
+                                         EventQueue::Priority::High);
+        Timer::singleShot(std::chrono::milliseconds(1), context, [&] { fired = true; });
+        released = true;
+        const auto start = std::chrono::steady_clock::now();
+        while (!contextDestroyed && std::chrono::steady_clock::now() - start < std::chrono::seconds(5))
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+        // THEN
+        REQUIRE(contextDestroyed);
+        REQUIRE(!fired);
+
+        thread.quit();
+        thread.wait();
+    }
+
+    SUBCASE("events for receivers on a finished thread are dropped")
+    {
+        // GIVEN
+        CoreApplication app;
+        auto thread = std::make_unique<Thread>();
+        thread->start();
+        Object obj;
+        obj.moveToEventLoop(thread->eventLoop());
+        thread.reset();
+
+        // WHEN
+        app.postEvent(&obj, std::make_unique<UpdateEvent>());
+
+        // THEN
+        REQUIRE(app.eventQueueSize() == 0);
+    }
+
+    SUBCASE("events for receivers on a destroyed loop aren't delivered to a loop reusing its address")
+    {
+        // GIVEN
+        CoreApplication app;
+        std::thread worker([&] {
+            std::optional<EventLoop> loop;
+            loop.emplace();
+            Object obj;
+            const auto oldLoopId = loop->id();
+            loop.reset();
+            loop.emplace();
+            REQUIRE(obj.eventLoop() == &*loop);
+            REQUIRE(loop->id() != oldLoopId);
+
+            // WHEN
+            app.postEvent(&obj, std::make_unique<UpdateEvent>());
+            const bool callbackPosted = EventLoop::postCallbackIfAlive(oldLoopId, [] { });
+
+            // THEN
+            REQUIRE(!callbackPosted);
+            REQUIRE(loop->eventQueueSize() == 0);
+            REQUIRE(app.eventQueueSize() == 0);
+        });
+        worker.join();
+    }
+}
@@ -0,0 +1,260 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/core_application.h>
+#include <KDFoundation/thread_pool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDFoundation;
+
+static_assert(std::is_destructible<ThreadPool>{});
+static_assert(std::is_default_constructible<ThreadPool>{});
+static_assert(!std::is_copy_constructible<ThreadPool>{});
+static_assert(!std::is_copy_assignable<ThreadPool>{});
+static_assert(!std::is_move_constructible<ThreadPool>{});
+static_assert(!std::is_move_assignable<ThreadPool>{});
+
+TEST_CASE("Creation")
+{
+    SUBCASE("defaults to one thread per hardware thread")
+    {
+        const ThreadPool pool;
+        REQUIRE(pool.threadCount() == std::max(1U, std::thread::hardware_concurrency()));
+    }
+
+    SUBCASE("can be given a thread count")
+    {
+        const ThreadPool pool(3);
+        REQUIRE(pool.threadCount() == 3);
+        REQUIRE(ThreadPool::current() == nullptr);
+    }
+}
+
+TEST_CASE("Running work")
+{
+    SUBCASE("runs all work on the threads of the pool")
+    {
+        // GIVEN
+        ThreadPool pool(4);
+        std::atomic<int> count = 0;
+        std::atomic<bool> ranOnPool = true;
+
+        // WHEN
+        for (int i = 0; i < 1000; ++i) {
+            pool.run([&] {
+                if (ThreadPool::current() != &pool)
+                    ranOnPool = false;
+                ++count;
+            });
+        }
+        pool.waitForDone();
+
+        // THEN
+        REQUIRE(count == 1000);
+        REQUIRE(ranOnPool);
+    }
+
+    SUBCASE("runs work submitted from the threads of the pool")
+    {
+        // GIVEN
+        ThreadPool pool(4);
+        std::atomic<int> count = 0;
+
+        // WHEN
+        std::function<void(int)> split = [&](int depth) {
+            ++count;
+            if (depth == 0)
+                return;
+            pool.run([&split, depth] { split(depth - 1); });
+            pool.run([&split, depth] { split(depth - 1); });
+        };
+        pool.run([&] { split(10); });
+        pool.waitForDone();
+
+        // THEN
+        REQUIRE(count == (1 << 11) - 1);
+    }
+
+    SUBCASE("idle threads steal work")
+    {
+        // GIVEN
+        ThreadPool pool(4);
+        std::mutex mutex;
+        std::set<std::thread::id> threads;
+
+        // WHEN
+        pool.run([&] {
+            // All of these go onto the deque of the current thread
+            for (int i = 0; i < 64; ++i) {
+                pool.run([&] {
+                    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                    std::lock_guard<std::mutex> lock(mutex);
+                    threads.insert(std::this_thread::get_id());
+                });
+            }
+        });
+        pool.waitForDone();
+
+        // THEN
+        REQUIRE(threads.size() > 1);
+    }
+
+    SUBCASE("destroying the pool waits for the work")
+    {
+        // GIVEN
+        std::atomic<int> count = 0;
+
+        // WHEN
+        {
+            ThreadPool pool(2);
+            for (int i = 0; i < 100; ++i) {
+                pool.run([&] {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    ++count;
+                });
+            }
+        }
+
+        // THEN
+        REQUIRE(count == 100);
+    }
+}
+
+TEST_CASE("Completions")
+{
+    SUBCASE("are called on the event loop of the submitting thread")
+    {
+        // GIVEN
+        CoreApplication app;
+        ThreadPool pool(4);
+        const auto mainThread = std::this_thread::get_id();
+        int completedCount = 0;
+        bool completedOnMainThread = true;
+
+        // WHEN
+        for (int i = 0; i < 100; ++i) {
+            pool.run([] {}, [&] {
+                if (std::this_thread::get_id() != mainThread)
+                    completedOnMainThread = false;
+                ++completedCount;
+            });
+        }
+        pool.waitForDone();
+
+        // THEN
+        REQUIRE(completedCount == 0);
+
+        // WHEN
+        app.processEvents();
+
+        // THEN
+        REQUIRE(completedCount == 100);
+        REQUIRE(completedOnMainThread);
+    }
+
+    SUBCASE("are passed the result of the work")
+    {
+        // GIVEN
+        CoreApplication app;
+        ThreadPool pool(2);
+        std::vector<int> results;
+
+        // WHEN
+        pool.run([] { return 6 * 7; }, [&](int result) { results.push_back(result); });
+        pool.run([] { return std::vector<int>{ 1, 2, 3 }; }, [&](std::vector<int> result) { results.insert(results.end(), result.begin(), result.end()); });
+        pool.waitForDone();
+        app.processEvents();
+
+        // THEN
+        REQUIRE(results.size() == 4);
+        REQUIRE(std::count(results.begin(), results.end(), 42) == 1);
+    }
+
+    SUBCASE("wake the event loop up")
+    {
+        // GIVEN
+        CoreApplication app;
+        ThreadPool pool(1);
+        bool completed = false;
+
+        // WHEN
+        pool.run([] { std::this_thread::sleep_for(std::chrono::milliseconds(10)); }, [&] { completed = true; });
+        const auto start = std::chrono::steady_clock::now();
+        app.processEvents(5000);
+
+        // THEN
+        REQUIRE(std::chrono::steady_clock::now() - start < std::chrono::seconds(4));
+
+        // WHEN
+        app.processEvents();
+
+        // THEN
+        REQUIRE(completed);
+    }
+
+    SUBCASE("are dropped if the event loop of the submitting thread is gone")
+    {
+        // GIVEN
+        auto app = std::make_unique<CoreApplication>();
+        ThreadPool pool(1);
+        std::atomic<bool> released = false;
+        std::atomic<bool> completed = false;
+        const auto work = [&] {
+            while (!released)
+                std::this_thread::yield();
+        };
+
+        // WHEN
+        pool.run(work, [&] { completed = true; });
+        app.reset();
+        released = true;
+        pool.waitForDone();
+
+        // THEN
+        REQUIRE(!completed);
+    }
+}
+
+TEST_CASE("Submitting work")
+{
+    SUBCASE("returns a future for the result of the work")
+    {
+        // GIVEN
+        CoreApplication app;
+        ThreadPool pool(2);
+        int result = 0;
+        bool voidCompleted = false;
+
+        // WHEN
+        auto future = pool.submit([] { return 6 * 7; }).then([&](int value) { result = value; });
+        auto voidFuture = pool.submit([] {}).then([&] { voidCompleted = true; });
+        pool.waitForDone();
+        app.processEvents();
+        app.processEvents();
+
+        // THEN
+        REQUIRE(future.isReady());
+        REQUIRE(voidFuture.isReady());
+        REQUIRE(result == 42);
+        REQUIRE(voidCompleted);
+    }
+}
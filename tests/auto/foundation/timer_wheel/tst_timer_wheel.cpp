@@ -0,0 +1,284 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/timer_wheel.h>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <random>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDFoundation;
+
+static_assert(std::is_destructible<TimerWheel>{});
+static_assert(std::is_default_constructible<TimerWheel>{});
+static_assert(!std::is_copy_constructible<TimerWheel>{});
+static_assert(!std::is_copy_assignable<TimerWheel>{});
+static_assert(!std::is_move_constructible<TimerWheel>{});
+static_assert(!std::is_move_assignable<TimerWheel>{});
+
+namespace {
+class TestEntry final : public TimerWheel::Entry
+{
+public:
+    explicit TestEntry(int id = 0)
+        : m_id{ id }
+    {
+    }
+
+    int id() const { return m_id; }
+
+    std::function<void(TimerWheel::Tick)> onExpire;
+
+protected:
+    void expire(TimerWheel::Tick now) override
+    {
+        if (onExpire)
+            onExpire(now);
+    }
+
+private:
+    int m_id;
+};
+} // namespace
+
+TEST_CASE("Scheduling and cancelling")
+{
+    SUBCASE("entries expire once their tick has been reached")
+    {
+        // GIVEN
+        TimerWheel wheel;
+        std::vector<int> expired;
+        TestEntry a(1);
+        TestEntry b(2);
+        a.onExpire = [&](TimerWheel::Tick) { expired.push_back(a.id()); };
+        b.onExpire = [&](TimerWheel::Tick) { expired.push_back(b.id()); };
+
+        // WHEN
+        wheel.schedule(b, 20);
+        wheel.schedule(a, 10);
+
+        // THEN
+        REQUIRE(wheel.size() == 2);
+        REQUIRE(a.isScheduled());
+        REQUIRE(a.expiry() == 10);
+        REQUIRE(wheel.nextExpiry() == TimerWheel::Tick(10));
+
+        // WHEN
+        REQUIRE(wheel.advanceTo(9) == 0);
+
+        // THEN
+        REQUIRE(expired.empty());
+
+        // WHEN
+        REQUIRE(wheel.advanceTo(30) == 2);
+
+        // THEN
+        REQUIRE(expired == std::vector<int>{ 1, 2 });
+        REQUIRE(!a.isScheduled());
+        REQUIRE(wheel.isEmpty());
+        REQUIRE(!wheel.nextExpiry().has_value());
+        REQUIRE(wheel.currentTick() == 30);
+    }
+
+    SUBCASE("cancelled entries do not expire")
+    {
+        // GIVEN
+        TimerWheel wheel;
+        int expiredCount = 0;
+        TestEntry a;
+        TestEntry b;
+        a.onExpire = [&](TimerWheel::Tick) { ++expiredCount; };
+        b.onExpire = [&](TimerWheel::Tick) { ++expiredCount; };
+        wheel.schedule(a, 5);
+        wheel.schedule(b, 5000);
+
+        // WHEN
+        wheel.cancel(a);
+        wheel.cancel(b);
+        wheel.cancel(b);
+
+        // THEN
+        REQUIRE(wheel.isEmpty());
+        REQUIRE(!wheel.nextExpiry().has_value());
+        REQUIRE(wheel.advanceTo(10000) == 0);
+        REQUIRE(expiredCount == 0);
+    }
+
+    SUBCASE("rescheduling moves the entry")
+    {
+        // GIVEN
+        TimerWheel wheel;
+        TimerWheel::Tick expiredAt = 0;
+        TestEntry a;
+        a.onExpire = [&](TimerWheel::Tick now) { expiredAt = now; };
+        wheel.schedule(a, 100);
+
+        // WHEN
+        wheel.schedule(a, 50);
+
+        // THEN
+        REQUIRE(wheel.size() == 1);
+        wheel.advanceTo(50);
+        REQUIRE(expiredAt == 50);
+        REQUIRE(wheel.advanceTo(200) == 0);
+    }
+
+    SUBCASE("expiries in the past are moved to the next tick")
+    {
+        // GIVEN
+        TimerWheel wheel(1000);
+        TestEntry a;
+
+        // WHEN
+        wheel.schedule(a, 10);
+
+        // THEN
+        REQUIRE(a.expiry() == 1001);
+        REQUIRE(wheel.advanceTo(1001) == 1);
+    }
+
+    SUBCASE("entries can be destroyed after the wheel")
+    {
+        // GIVEN
+        TestEntry a;
+        auto wheel = std::make_unique<TimerWheel>();
+        wheel->schedule(a, 100000);
+
+        // WHEN
+        wheel.reset();
+
+        // THEN
+        REQUIRE(!a.isScheduled());
+    }
+}
+
+TEST_CASE("Expiries on all levels")
+{
+    // GIVEN
+    TimerWheel wheel(17);
+    std::mt19937_64 random(42);
+    std::vector<TimerWheel::Tick> expiries{ 18, 63, 64, 65, 127, 128, 4095, 4096, 4097, 262143, 262144,
+                                            (TimerWheel::Tick(1) << 24) - 1, TimerWheel::Tick(1) << 24,
+                                            (TimerWheel::Tick(1) << 24) + 1, TimerWheel::Tick(1) << 30 };
+    for (int i = 0; i < 500; ++i)
+        expiries.push_back(18 + random() % (TimerWheel::Tick(1) << 26));
+
+    std::vector<std::unique_ptr<TestEntry>> entries;
+    std::vector<TimerWheel::Tick> expiredAt(expiries.size(), 0);
+    for (size_t i = 0; i < expiries.size(); ++i) {
+        auto entry = std::make_unique<TestEntry>(static_cast<int>(i));
+        entry->onExpire = [&expiredAt, &wheel, i](TimerWheel::Tick now) {
+            REQUIRE(now == wheel.currentTick());
+            expiredAt[i] = now;
+        };
+        wheel.schedule(*entry, expiries[i]);
+        entries.push_back(std::move(entry));
+    }
+
+    // WHEN
+    std::vector<TimerWheel::Tick> sortedExpiries = expiries;
+    std::sort(sortedExpiries.begin(), sortedExpiries.end());
+    sortedExpiries.erase(std::unique(sortedExpiries.begin(), sortedExpiries.end()), sortedExpiries.end());
+
+    // THEN
+    for (const TimerWheel::Tick expiry : sortedExpiries) {
+        // The wheel never reports an expiry later than the earliest one
+        const auto nextExpiry = wheel.nextExpiry();
+        REQUIRE(nextExpiry.has_value());
+        REQUIRE(*nextExpiry <= expiry);
+
+        // Nothing expires early
+        wheel.advanceTo(expiry - 1);
+        for (size_t i = 0; i < expiries.size(); ++i)
+            REQUIRE((expiredAt[i] != 0) == (expiries[i] < expiry));
+
+        // Everything expires on time
+        wheel.advanceTo(expiry);
+        for (size_t i = 0; i < expiries.size(); ++i) {
+            if (expiries[i] == expiry)
+                REQUIRE(expiredAt[i] == expiry);
+        }
+    }
+    REQUIRE(wheel.isEmpty());
+}
+
+TEST_CASE("Advancing late")
+{
+    SUBCASE("expires entries in order of expiry")
+    {
+        // GIVEN
+        TimerWheel wheel;
+        std::vector<int> expired;
+        std::vector<std::unique_ptr<TestEntry>> entries;
+        const std::vector<TimerWheel::Tick> expiries{ 70000, 3, 5000, 64, 200, 1 };
+        for (size_t i = 0; i < expiries.size(); ++i) {
+            auto entry = std::make_unique<TestEntry>(static_cast<int>(expiries[i]));
+            entry->onExpire = [&expired, id = entry->id()](TimerWheel::Tick) { expired.push_back(id); };
+            wheel.schedule(*entry, expiries[i]);
+            entries.push_back(std::move(entry));
+        }
+
+        // WHEN
+        REQUIRE(wheel.advanceTo(100000) == expiries.size());
+
+        // THEN
+        REQUIRE(expired == std::vector<int>{ 1, 3, 64, 200, 5000, 70000 });
+    }
+
+    SUBCASE("entries can reschedule themselves")
+    {
+        // GIVEN
+        TimerWheel wheel;
+        std::vector<TimerWheel::Tick> expired;
+        TestEntry periodic;
+        periodic.onExpire = [&](TimerWheel::Tick now) {
+            expired.push_back(now);
+            wheel.schedule(periodic, now + 10);
+        };
+        wheel.schedule(periodic, 10);
+
+        // WHEN
+        for (TimerWheel::Tick tick = 0; tick <= 100; ++tick)
+            wheel.advanceTo(tick);
+
+        // THEN
+        REQUIRE(expired == std::vector<TimerWheel::Tick>{ 10, 20, 30, 40, 50, 60, 70, 80, 90, 100 });
+        REQUIRE(periodic.isScheduled());
+    }
+
+    SUBCASE("entries can cancel entries expiring on the same tick")
+    {
+        // GIVEN
+        TimerWheel wheel;
+        int expiredCount = 0;
+        TestEntry a;
+        TestEntry b;
+        a.onExpire = [&](TimerWheel::Tick) {
+            ++expiredCount;
+            wheel.cancel(b);
+        };
+        b.onExpire = [&](TimerWheel::Tick) { ++expiredCount; };
+        wheel.schedule(a, 300);
+        wheel.schedule(b, 300);
+
+        // WHEN
+        wheel.advanceTo(300);
+
+        // THEN
+        REQUIRE(expiredCount == 1);
+        REQUIRE(!b.isScheduled());
+        REQUIRE(wheel.isEmpty());
+    }
+}
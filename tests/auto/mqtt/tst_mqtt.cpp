@@ -554,6 +554,7 @@ TEST_SUITE("Mqtt")
 
         muth.createMosquittoClientMockAndInjectIntoMqttClient(mqttClient);
         Fake(Method(muth.clientMock(), disconnect));
+        Fake(Method(muth.clientMock(), wantWrite));
 
         SUBCASE("returns MOSQ_ERR_UNKNOWN if connection state is DISCONNECTING")
         {
@@ -611,6 +612,7 @@ TEST_SUITE("Mqtt")
 
         muth.createMosquittoClientMockAndInjectIntoMqttClient(mqttClient);
         Fake(Method(muth.clientMock(), publish));
+        Fake(Method(muth.clientMock(), wantWrite));
 
         int msgId{ 0 };
         const ByteArray payload{ "payload" };
@@ -658,6 +660,7 @@ TEST_SUITE("Mqtt")
 
         muth.createMosquittoClientMockAndInjectIntoMqttClient(mqttClient);
         Fake(Method(muth.clientMock(), subscribe));
+        Fake(Method(muth.clientMock(), wantWrite));
 
         const std::string pattern{ "pattern" };
         const IMqttClient::QOS qos{ IMqttClient::QOS::AT_MOST_ONCE };
@@ -721,6 +724,7 @@ TEST_SUITE("Mqtt")
 
         muth.createMosquittoClientMockAndInjectIntoMqttClient(mqttClient);
         Fake(Method(muth.clientMock(), unsubscribe));
+        Fake(Method(muth.clientMock(), wantWrite));
 
         const std::string pattern{ "pattern" };
 
@@ -893,6 +897,7 @@ TEST_SUITE("Mqtt")
         const std::string topic{ "testTopic" };
 
         When(Method(muth.clientMock(), subscribe)).AlwaysReturnAndSet(MOSQ_ERR_SUCCESS, msgId);
+        Fake(Method(muth.clientMock(), wantWrite));
 
         SUBCASE("sets SUBSCRIPTION state to SUBSCRIBED if a subscription operation is pending for topic")
         {
@@ -933,6 +938,7 @@ TEST_SUITE("Mqtt")
         const std::string topic{ "testTopic" };
 
         When(Method(muth.clientMock(), subscribe)).AlwaysReturnAndSet(MOSQ_ERR_SUCCESS, msgId);
+        Fake(Method(muth.clientMock(), wantWrite));
         When(Method(muth.clientMock(), unsubscribe)).AlwaysReturnAndSet(MOSQ_ERR_SUCCESS, msgId);
 
         SUBCASE("sets SUBSCRIPTION state to UNSUBSCRIBED if a subscription operation is pending for topic")
@@ -1054,6 +1060,7 @@ TEST_SUITE("Mqtt")
 
         muth.createMosquittoClientMockAndInjectIntoMqttClient(mqttClient);
         Fake(Method(muth.clientMock(), loopMisc));
+        Fake(Method(muth.clientMock(), wantWrite));
 
         SUBCASE("calls MosquittoClient::loopMisc once")
         {
@@ -1063,6 +1070,18 @@ TEST_SUITE("Mqtt")
             // THEN
             Verify(Method(muth.clientMock(), loopMisc)).Once();
         }
+
+        SUBCASE("asks MosquittoClient::wantWrite whether writes are pending")
+        {
+            // GIVEN
+            When(Method(muth.clientMock(), wantWrite)).Return(false);
+
+            // WHEN
+            MqttUnitTestHarness::onMiscTaskRequested(mqttClient.get());
+
+            // THEN
+            Verify(Method(muth.clientMock(), wantWrite)).Once();
+        }
     }
 
     TEST_CASE("MqttClient::EventLoopHook")
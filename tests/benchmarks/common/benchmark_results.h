@@ -0,0 +1,33 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#pragma once
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <nanobench.h>
+
+// Writes the results of bench in nanobench's JSON format to <name>.json in the
+// directory named by KDUTILS_BENCHMARK_RESULTS_DIR, if set. ctest sets it for the
+// benchmarks, so that results can be compared between releases.
+inline void writeBenchmarkResults(const ankerl::nanobench::Bench &bench, const std::string &name)
+{
+    const char *resultsDir = std::getenv("KDUTILS_BENCHMARK_RESULTS_DIR");
+    if (!resultsDir || !*resultsDir)
+        return;
+
+    std::error_code error;
+    std::filesystem::create_directories(resultsDir, error);
+    std::ofstream out(std::filesystem::path(resultsDir) / (name + ".json"));
+    ankerl::nanobench::render(ankerl::nanobench::templates::json(), bench, out);
+}
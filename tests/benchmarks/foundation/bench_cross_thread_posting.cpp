@@ -0,0 +1,121 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/core_application.h>
+#include <KDFoundation/event.h>
+#include <KDFoundation/event_loop.h>
+#include <KDFoundation/object.h>
+#include <KDFoundation/thread.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nanobench.h>
+
+#include "benchmark_results.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDFoundation;
+
+namespace {
+// Quits the event loop once the expected number of update events has arrived
+class CountingObject : public Object
+{
+public:
+    int updates = 0;
+    int expectedUpdates = 0;
+
+protected:
+    void event(EventReceiver *target, Event *ev) override
+    {
+        if (ev->type() == Event::Type::Update && ++updates == expectedUpdates)
+            EventLoop::instance()->quit();
+        Object::event(target, ev);
+    }
+};
+} // namespace
+
+TEST_CASE("Posting events from other threads")
+{
+    const int totalEvents = 64 * 1024;
+    CoreApplication app;
+    EventLoop *loop = app.eventLoop();
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Posting from other threads into one event loop")
+            .unit("event")
+            .batch(totalEvents)
+            .epochs(5)
+            .minEpochIterations(1);
+
+    // postEventIfAlive() is what posting to receivers of other threads goes through, e.g.
+    // for thread pool completions. Many producers show whether looking the loop up
+    // serializes them.
+    const EventLoop::Id loopId = loop->id();
+    for (const bool ifAlive : { false, true }) {
+        for (const int producerCount : { 1, 4, 16, 64 }) {
+            CountingObject target;
+            const std::string name = std::string(ifAlive ? "postEventIfAlive, " : "postEvent, ") + std::to_string(producerCount) + " producer(s)";
+            bench.run(name, [&] {
+                target.updates = 0;
+                target.expectedUpdates = totalEvents / producerCount * producerCount;
+                std::vector<std::thread> producers;
+                for (int p = 0; p < producerCount; ++p) {
+                    producers.emplace_back([&] {
+                        for (int i = 0; i < totalEvents / producerCount; ++i) {
+                            if (ifAlive)
+                                EventLoop::postEventIfAlive(loopId, &target, std::make_unique<UpdateEvent>());
+                            else
+                                loop->postEvent(&target, std::make_unique<UpdateEvent>());
+                        }
+                    });
+                }
+                loop->exec();
+                for (auto &producer : producers)
+                    producer.join();
+            });
+        }
+    }
+
+    writeBenchmarkResults(bench, "cross-thread-posting");
+}
+
+TEST_CASE("Round trips between event loops")
+{
+    const int roundTrips = 1000;
+    CoreApplication app;
+    EventLoop *loop = app.eventLoop();
+    Thread thread;
+    thread.start();
+    EventLoop *otherLoop = thread.eventLoop();
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Round trips between the event loops of two threads")
+            .unit("round trip")
+            .batch(roundTrips)
+            .epochs(5)
+            .minEpochIterations(1);
+
+    // The answer quits the nested exec(), so that no time is spent waiting for a timeout
+    bench.run("postCallback", [&] {
+        for (int i = 0; i < roundTrips; ++i) {
+            otherLoop->postCallback([&] {
+                loop->postCallback([&] { loop->quit(); });
+            });
+            loop->exec();
+        }
+    });
+
+    writeBenchmarkResults(bench, "cross-thread-round-trips");
+}
@@ -0,0 +1,103 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/core_application.h>
+#include <KDFoundation/event.h>
+#include <KDFoundation/event_loop.h>
+#include <KDFoundation/object.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <thread>
+
+#include <nanobench.h>
+
+#include "benchmark_results.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDFoundation;
+
+namespace {
+std::atomic<uint64_t> s_allocationCount{ 0 };
+}
+
+// Count every allocation going through the global allocator
+void *operator new(std::size_t size)
+{
+    s_allocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (void *ptr = std::malloc(size ? size : 1))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+namespace {
+// Posts eventCount update events to target and delivers them
+void postAndDeliver(EventLoop &loop, Object *target, int eventCount)
+{
+    for (int i = 0; i < eventCount; ++i)
+        loop.postEvent(target, std::make_unique<UpdateEvent>());
+    loop.processEvents(0);
+}
+} // namespace
+
+TEST_CASE("Posting and delivering events")
+{
+    const int eventCount = 1024;
+    CoreApplication app;
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Post and deliver events")
+            .unit("event")
+            .batch(eventCount)
+            .minEpochIterations(10)
+            .relative(true);
+
+    for (const auto backend : { EventQueue::Backend::Locking, EventQueue::Backend::LockFree }) {
+        const std::string name = backend == EventQueue::Backend::Locking ? "locking" : "lock-free";
+
+        // Each thread can only have one event loop, so give each backend its own thread
+        std::thread thread([&] {
+            EventLoop loop(nullptr, backend);
+            Object target;
+
+            // Let the queue, the delivery batch and the event pool grow to their working size
+            for (int i = 0; i < 3; ++i)
+                postAndDeliver(loop, &target, eventCount);
+
+            const uint64_t allocationsBefore = s_allocationCount.load();
+            postAndDeliver(loop, &target, eventCount);
+            const uint64_t allocations = s_allocationCount.load() - allocationsBefore;
+            MESSAGE(name << ": " << static_cast<double>(allocations) / eventCount << " allocation(s) per posted event");
+            if (backend == EventQueue::Backend::Locking)
+                CHECK(allocations == 0);
+
+            bench.run(name, [&] {
+                postAndDeliver(loop, &target, eventCount);
+            });
+        });
+        thread.join();
+    }
+
+    writeBenchmarkResults(bench, "event-posting");
+}
@@ -0,0 +1,126 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/event.h>
+#include <KDFoundation/event_queue.h>
+#include <KDFoundation/object.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <nanobench.h>
+
+#include "benchmark_results.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDFoundation;
+
+namespace {
+class BenchEvent : public Event
+{
+public:
+    BenchEvent()
+        : Event(static_cast<Event::Type>(static_cast<uint16_t>(Event::Type::UserType) + 1))
+    {
+    }
+};
+
+// Pushes totalEvents events from producerCount threads while the calling thread
+// consumes them, mimicking several threads posting into one event loop.
+void runContention(EventQueue &eventQueue, EventReceiver *target, int producerCount, int totalEvents)
+{
+    std::atomic<bool> start{ false };
+    std::vector<std::thread> producers;
+    producers.reserve(producerCount);
+    const int eventsPerProducer = totalEvents / producerCount;
+    for (int p = 0; p < producerCount; ++p) {
+        producers.emplace_back([&] {
+            while (!start.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            for (int i = 0; i < eventsPerProducer; ++i)
+                eventQueue.push(target, std::make_unique<BenchEvent>());
+        });
+    }
+
+    start.store(true, std::memory_order_release);
+    int received = 0;
+    while (received < eventsPerProducer * producerCount) {
+        auto postedEvent = eventQueue.tryPop();
+        if (postedEvent)
+            ++received;
+    }
+
+    for (auto &producer : producers)
+        producer.join();
+}
+} // namespace
+
+TEST_CASE("EventQueue contention")
+{
+    const int totalEvents = 64 * 1024;
+    Object target;
+
+    ankerl::nanobench::Bench bench;
+    bench.title("EventQueue push/pop under contention")
+            .unit("event")
+            .batch(totalEvents)
+            .epochs(5)
+            .minEpochIterations(1)
+            .relative(true);
+
+    for (const int producerCount : { 1, 4, 16 }) {
+        for (const auto backend : { EventQueue::Backend::Locking, EventQueue::Backend::LockFree }) {
+            const std::string name = std::string(backend == EventQueue::Backend::Locking ? "locking" : "lock-free") +
+                    ", " + std::to_string(producerCount) + " producer(s)";
+            EventQueue eventQueue(backend);
+            bench.run(name, [&] {
+                runContention(eventQueue, &target, producerCount, totalEvents);
+            });
+            REQUIRE(eventQueue.isEmpty());
+        }
+    }
+
+    writeBenchmarkResults(bench, "event-queue-contention");
+}
+
+TEST_CASE("EventQueue receiver teardown")
+{
+    // Destroying receivers while the queue holds a deep backlog of events for them
+    const int receiverCount = 10000;
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Removing the events of destroyed receivers")
+            .unit("receiver")
+            .batch(receiverCount)
+            .epochs(5)
+            .minEpochIterations(1);
+
+    std::vector<std::unique_ptr<Object>> receivers;
+    for (int i = 0; i < receiverCount; ++i)
+        receivers.push_back(std::make_unique<Object>());
+
+    for (const auto backend : { EventQueue::Backend::Locking, EventQueue::Backend::LockFree }) {
+        EventQueue eventQueue(backend);
+        bench.run(backend == EventQueue::Backend::Locking ? "locking" : "lock-free", [&] {
+            for (auto &receiver : receivers)
+                eventQueue.push(receiver.get(), std::make_unique<BenchEvent>());
+            for (auto &receiver : receivers)
+                eventQueue.removeAllEventsTargeting(*receiver);
+            eventQueue.tryPop();
+        });
+        REQUIRE(eventQueue.isEmpty());
+    }
+
+    writeBenchmarkResults(bench, "event-queue-teardown");
+}
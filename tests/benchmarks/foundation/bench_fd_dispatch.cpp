@@ -0,0 +1,90 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/platform/linux/linux_platform_event_loop.h>
+#include <KDFoundation/event_loop.h>
+#include <KDFoundation/file_descriptor_notifier.h>
+
+#include <memory>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <nanobench.h>
+
+#include "benchmark_results.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDFoundation;
+
+namespace {
+// Raises the soft limit of open files as far as allowed. Returns whether count more
+// file descriptors fit.
+bool reserveFileDescriptors(size_t count)
+{
+    rlimit limit;
+    if (getrlimit(RLIMIT_NOFILE, &limit) != 0)
+        return false;
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &limit);
+    return limit.rlim_cur == RLIM_INFINITY || count + 64 <= limit.rlim_cur;
+}
+} // namespace
+
+TEST_CASE("Dispatching notifications of many file descriptors")
+{
+    ankerl::nanobench::Bench bench;
+    bench.title("Dispatch of ready file descriptors")
+            .unit("notification")
+            .minEpochIterations(5);
+
+    for (const size_t fdCount : { 1000, 10000, 50000 }) {
+        if (!reserveFileDescriptors(fdCount)) {
+            MESSAGE("Not enough file descriptors available for " << fdCount << " notifiers, skipping");
+            continue;
+        }
+
+        auto platformLoop = std::make_unique<LinuxPlatformEventLoop>();
+        LinuxPlatformEventLoop *linuxLoop = platformLoop.get();
+        EventLoop loop(std::move(platformLoop));
+
+        // Eventfds that stay readable, so every wait reports all of them again
+        size_t notifications = 0;
+        std::vector<int> fds;
+        std::vector<std::unique_ptr<FileDescriptorNotifier>> notifiers;
+        for (size_t i = 0; i < fdCount; ++i) {
+            const int fd = eventfd(1, EFD_NONBLOCK);
+            REQUIRE(fd != -1);
+            fds.push_back(fd);
+            auto notifier = std::make_unique<FileDescriptorNotifier>(fd, FileDescriptorNotifier::NotificationType::Read);
+            std::ignore = notifier->triggered.connect([&notifications](const int &) { ++notifications; });
+            notifiers.push_back(std::move(notifier));
+        }
+        REQUIRE(linuxLoop->registeredFileDescriptorCount() == fdCount);
+
+        bench.batch(fdCount).run(std::to_string(fdCount) + " fds", [&] {
+            notifications = 0;
+            while (notifications < fdCount)
+                linuxLoop->waitForEvents(0);
+        });
+
+        notifiers.clear();
+        for (const int fd : fds)
+            close(fd);
+    }
+
+    writeBenchmarkResults(bench, "fd-dispatch");
+}
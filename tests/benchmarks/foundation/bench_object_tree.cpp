@@ -0,0 +1,121 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/core_application.h>
+#include <KDFoundation/object.h>
+#include <KDFoundation/object_arena.h>
+
+#include <memory>
+#include <utility>
+
+#include <nanobench.h>
+
+#include "benchmark_results.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDFoundation;
+
+namespace {
+// Gives root fanOut children, each with fanOut children of their own
+void populate(Object &root, int fanOut)
+{
+    for (int i = 0; i < fanOut; ++i) {
+        auto child = root.createChild<Object>();
+        for (int j = 0; j < fanOut; ++j)
+            child->createChild<Object>();
+    }
+}
+} // namespace
+
+TEST_CASE("Object tree creation and destruction")
+{
+    const int fanOut = 100;
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Creating and destroying an Object tree")
+            .unit("object")
+            .batch(fanOut * fanOut + fanOut + 1)
+            .epochs(5)
+            .minEpochIterations(1)
+            .relative(true);
+
+    bench.run("global allocator", [&] {
+        auto root = std::make_unique<Object>();
+        populate(*root, fanOut);
+    });
+
+    ObjectArena arena;
+    bench.run("arena", [&] {
+        auto root = arena.create<Object>();
+        populate(*root, fanOut);
+    });
+    REQUIRE(arena.allocationCount() == 0);
+
+    writeBenchmarkResults(bench, "object-tree");
+}
+
+TEST_CASE("Object reparenting")
+{
+    const int childCount = 10000;
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Reparenting the children of an Object front to back")
+            .unit("child")
+            .batch(childCount)
+            .epochs(5)
+            .minEpochIterations(1);
+
+    auto from = std::make_unique<Object>();
+    auto to = std::make_unique<Object>();
+    for (int i = 0; i < childCount; ++i)
+        from->createChild<Object>();
+
+    bench.run("takeChild + addChild", [&] {
+        while (!from->children().empty())
+            to->addChild(from->takeChild(from->children().front().get()));
+        std::swap(from, to);
+    });
+    REQUIRE(from->children().size() == childCount);
+
+    writeBenchmarkResults(bench, "object-reparenting");
+}
+
+TEST_CASE("Deferred deletion")
+{
+    const int objectCount = 50000;
+    CoreApplication app;
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Deleting Objects with deleteLater()")
+            .unit("object")
+            .batch(objectCount)
+            .epochs(5)
+            .minEpochIterations(1);
+
+    bench.run("parentless objects", [&] {
+        for (int i = 0; i < objectCount; ++i)
+            (new Object())->deleteLater();
+        app.processEvents();
+    });
+
+    auto root = std::make_unique<Object>();
+    bench.run("children", [&] {
+        for (int i = 0; i < objectCount; ++i)
+            root->createChild<Object>();
+        for (const auto &child : root->children())
+            child->deleteLater();
+        app.processEvents();
+    });
+    REQUIRE(root->children().empty());
+
+    writeBenchmarkResults(bench, "deferred-deletion");
+}
@@ -0,0 +1,75 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/core_application.h>
+#include <KDFoundation/latency_histogram.h>
+#include <KDFoundation/timer.h>
+
+#include <chrono>
+#include <cstdint>
+#include <tuple>
+
+#include <nanobench.h>
+
+#include "benchmark_results.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDFoundation;
+using namespace std::chrono_literals;
+
+TEST_CASE("Timer jitter")
+{
+    CoreApplication app;
+    const auto interval = 2ms;
+    const size_t tickCount = 200;
+
+    // Every epoch measures a single tick, so the spread between epochs that nanobench
+    // reports is the jitter of the timer
+    ankerl::nanobench::Bench bench;
+    bench.title("Interval between timer ticks (2 ms)")
+            .unit("tick")
+            .epochs(tickCount)
+            .epochIterations(1)
+            .warmup(5);
+
+    for (const auto type : { TimerType::Precise, TimerType::Coarse }) {
+        const char *name = type == TimerType::Precise ? "precise" : "coarse";
+
+        Timer timer;
+        timer.interval = interval;
+        timer.timerType = type;
+        bool ticked = false;
+        std::ignore = timer.timeout.connect([&ticked] { ticked = true; });
+
+        // Deviations from the interval, for a percentile summary on top
+        LatencyHistogram lateness;
+        auto lastTick = std::chrono::steady_clock::now();
+        timer.running = true;
+
+        bench.run(name, [&] {
+            ticked = false;
+            while (!ticked)
+                app.processEvents(-1);
+            const auto now = std::chrono::steady_clock::now();
+            const auto elapsed = now - lastTick;
+            lateness.record(elapsed > interval ? elapsed - interval : interval - elapsed);
+            lastTick = now;
+        });
+        timer.running = false;
+
+        MESSAGE(name << ": deviation from the interval median " << lateness.valueAtPercentile(50) / 1000
+                     << " us, 99th percentile " << lateness.valueAtPercentile(99) / 1000
+                     << " us, max " << lateness.max() / 1000 << " us");
+    }
+
+    writeBenchmarkResults(bench, "timer-jitter");
+}
@@ -0,0 +1,104 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDUtils/bytearray.h>
+
+#include <cstdint>
+#include <string>
+
+#include <nanobench.h>
+
+#include "benchmark_results.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDUtils;
+
+namespace {
+ByteArray makeData(size_t size)
+{
+    ByteArray data(size);
+    for (size_t i = 0; i < size; ++i)
+        data.data()[i] = static_cast<uint8_t>(i * 31 + 7);
+    return data;
+}
+} // namespace
+
+TEST_CASE("ByteArray operations")
+{
+    const size_t size = 64 * 1024;
+    const ByteArray data = makeData(size);
+    const ByteArray chunk = makeData(256);
+
+    ankerl::nanobench::Bench bench;
+    bench.title("ByteArray operations on 64 KiB")
+            .unit("byte")
+            .batch(size)
+            .minEpochIterations(10);
+
+    bench.run("copy", [&] {
+        ByteArray copy(data);
+        ankerl::nanobench::doNotOptimizeAway(copy);
+    });
+    bench.run("append 256 byte chunks", [&] {
+        ByteArray result;
+        while (result.size() < size)
+            result += chunk;
+        ankerl::nanobench::doNotOptimizeAway(result);
+    });
+    bench.run("mid", [&] {
+        for (size_t pos = 0; pos < size; pos += 256) {
+            ByteArray part = data.mid(pos, 256);
+            ankerl::nanobench::doNotOptimizeAway(part);
+        }
+    });
+    bench.run("remove from the front", [&] {
+        ByteArray copy(data);
+        while (!copy.isEmpty())
+            copy.remove(0, 4096);
+        ankerl::nanobench::doNotOptimizeAway(copy);
+    });
+    bench.run("indexOf", [&] {
+        auto index = data.indexOf(0xFF);
+        ankerl::nanobench::doNotOptimizeAway(index);
+    });
+    bench.run("compare", [&] {
+        bool equal = data == ByteArray(data);
+        ankerl::nanobench::doNotOptimizeAway(equal);
+    });
+
+    writeBenchmarkResults(bench, "bytearray");
+}
+
+TEST_CASE("Base64")
+{
+    const size_t size = 64 * 1024;
+    const ByteArray data = makeData(size);
+    const ByteArray encoded = data.toBase64();
+    REQUIRE(ByteArray::fromBase64(encoded) == data);
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Base64 of 64 KiB")
+            .unit("byte")
+            .batch(size)
+            .minEpochIterations(10);
+
+    bench.run("encode", [&] {
+        ByteArray result = data.toBase64();
+        ankerl::nanobench::doNotOptimizeAway(result);
+    });
+    bench.run("decode", [&] {
+        ByteArray result = ByteArray::fromBase64(encoded);
+        ankerl::nanobench::doNotOptimizeAway(result);
+    });
+
+    writeBenchmarkResults(bench, "base64");
+}
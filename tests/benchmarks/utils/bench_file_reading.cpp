@@ -0,0 +1,73 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDUtils/bytearray.h>
+#include <KDUtils/file.h>
+#include <KDUtils/file_mapper.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <numeric>
+#include <string>
+
+#include <nanobench.h>
+
+#include "benchmark_results.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDUtils;
+
+namespace {
+// Touches every byte, as a consumer of the file contents would
+uint64_t checksum(const uint8_t *data, size_t size)
+{
+    return std::accumulate(data, data + size, uint64_t(0));
+}
+} // namespace
+
+TEST_CASE("Reading whole files")
+{
+    const std::string path = (std::filesystem::temp_directory_path() / "kdutils-bench-file-reading.bin").string();
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Reading a whole file")
+            .unit("byte")
+            .minEpochIterations(10);
+
+    for (const size_t size : { size_t(4 * 1024), size_t(1024 * 1024), size_t(16 * 1024 * 1024) }) {
+        {
+            File file(path);
+            REQUIRE(file.open(std::ios::out | std::ios::binary | std::ios::trunc));
+            file.write(ByteArray(size, 42));
+        }
+        REQUIRE(File::size(path) == size);
+        const std::string sizeName = std::to_string(size / 1024) + " KiB";
+        bench.batch(size);
+
+        bench.run("File::readAll, " + sizeName, [&] {
+            File file(path);
+            file.open(std::ios::in | std::ios::binary);
+            const ByteArray data = file.readAll();
+            ankerl::nanobench::doNotOptimizeAway(checksum(data.constData(), data.size()));
+        });
+
+        bench.run("FileMapper, " + sizeName, [&] {
+            const FileMapper mapper(File{ path });
+            const uint8_t *data = mapper.map();
+            REQUIRE(data != nullptr);
+            ankerl::nanobench::doNotOptimizeAway(checksum(data, mapper.size()));
+        });
+    }
+
+    std::filesystem::remove(path);
+    writeBenchmarkResults(bench, "file-reading");
+}
@@ -0,0 +1,76 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDFoundation/core_application.h>
+
+#include <kdbindings/signal.h>
+
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <nanobench.h>
+
+#include "benchmark_results.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+TEST_CASE("Signal emission")
+{
+    const int emissionCount = 1000;
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Signal emission")
+            .unit("emission")
+            .batch(emissionCount)
+            .minEpochIterations(10);
+
+    for (const int slotCount : { 0, 1, 10 }) {
+        KDBindings::Signal<int> signal;
+        int sum = 0;
+        std::vector<KDBindings::ScopedConnection> connections;
+        for (int i = 0; i < slotCount; ++i)
+            connections.emplace_back(signal.connect([&sum](int value) { sum += value; }));
+
+        bench.run(std::to_string(slotCount) + " slot(s)", [&] {
+            for (int i = 0; i < emissionCount; ++i)
+                signal.emit(i);
+        });
+        ankerl::nanobench::doNotOptimizeAway(sum);
+    }
+
+    writeBenchmarkResults(bench, "signal");
+}
+
+TEST_CASE("Deferred signal emission")
+{
+    const int emissionCount = 1000;
+    KDFoundation::CoreApplication app;
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Signal emission, evaluated by the event loop")
+            .unit("emission")
+            .batch(emissionCount)
+            .minEpochIterations(10);
+
+    KDBindings::Signal<int> signal;
+    int sum = 0;
+    const KDBindings::ScopedConnection connection = signal.connectDeferred(app.connectionEvaluator(), [&sum](int value) { sum += value; });
+
+    bench.run("1 deferred slot", [&] {
+        for (int i = 0; i < emissionCount; ++i)
+            signal.emit(i);
+        app.processEvents();
+    });
+    ankerl::nanobench::doNotOptimizeAway(sum);
+
+    writeBenchmarkResults(bench, "signal-deferred");
+}
@@ -0,0 +1,62 @@
+/*
+  This file is part of KDUtils.
+
+  SPDX-FileCopyrightText: 2025 Klarälvdalens Datakonsult AB, a KDAB Group company <info@kdab.com>
+
+  SPDX-License-Identifier: MIT
+
+  Contact KDAB at <info@kdab.com> for commercial licensing options.
+*/
+
+#include <KDUtils/url.h>
+
+#include <string>
+#include <vector>
+
+#include <nanobench.h>
+
+#include "benchmark_results.h"
+
+#define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
+#include <doctest.h>
+
+using namespace KDUtils;
+
+TEST_CASE("Url parsing")
+{
+    const std::vector<std::string> urls = {
+        "https://www.kdab.com/software-technologies/developer-tools/",
+        "mqtt://broker.example.com:1883/sensors/temperature",
+        "file:///home/user/Documents/scene.gltf",
+        "/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf",
+        "relative/path/to/texture.png",
+    };
+
+    ankerl::nanobench::Bench bench;
+    bench.title("Url")
+            .unit("url")
+            .batch(urls.size())
+            .minEpochIterations(1000);
+
+    bench.run("parse", [&] {
+        for (const auto &url : urls) {
+            Url parsed(url);
+            ankerl::nanobench::doNotOptimizeAway(parsed);
+        }
+    });
+    bench.run("parse and query", [&] {
+        for (const auto &url : urls) {
+            Url parsed(url);
+            auto fileName = parsed.fileName();
+            auto localFile = parsed.isLocalFile() ? parsed.toLocalFile() : std::string();
+            ankerl::nanobench::doNotOptimizeAway(fileName);
+            ankerl::nanobench::doNotOptimizeAway(localFile);
+        }
+    });
+    bench.run("fromLocalFile", [&] {
+        Url url = Url::fromLocalFile("/home/user/Documents/scene.gltf");
+        ankerl::nanobench::doNotOptimizeAway(url);
+    });
+
+    writeBenchmarkResults(bench, "url");
+}